@@ -0,0 +1,554 @@
+/*
+ * y-align-operation.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <memory.h>
+#include <math.h>
+#include "y-align-operation.h"
+
+/**
+ * SECTION: y-align-operation
+ * @short_description: Operation that aligns timestamped ring vectors onto
+ * a common clock.
+ *
+ * This operation samples several #YRingVector channels, each created with
+ * timestamp tracking, at a shared set of clock ticks. The input is the
+ * first channel, and more are added with y_align_operation_add_channel().
+ * The output is a matrix with one row per tick. Column 0 is the tick time,
+ * column 1 the input and the following columns the added channels, in the
+ * order they were added.
+ *
+ * With %ALIGN_CLOCK_INPUT, the ticks are the timestamps of the input. With
+ * %ALIGN_CLOCK_MERGED, they are the timestamps of all channels, combined
+ * into one increasing sequence by a k-way merge. Repeated times give a
+ * single tick. With %ALIGN_HOLD, a channel's value at a tick is its last
+ * sample at or before the tick. With %ALIGN_LINEAR, it is interpolated
+ * between the samples on either side. A tick is then only output once
+ * every channel has a sample after it, or once it has fallen more than
+ * "rows" ticks behind, when the last value is held. Before a channel's
+ * first sample, its value is NaN.
+ *
+ * The output holds the last "rows" ticks, the newest in the last row, and
+ * rows without a tick yet are NaN. Between runs the operation keeps its
+ * output and only processes samples appended since the last run, found
+ * with y_ring_vector_get_n_appended(). Samples dropped from a ring before
+ * the operation saw them are skipped. Changing a property, the input or
+ * the channels starts again from the samples currently in the rings.
+ */
+
+enum {
+	ALIGN_PROP_0,
+	ALIGN_PROP_METHOD,
+	ALIGN_PROP_CLOCK,
+	ALIGN_PROP_ROWS,
+	ALIGN_PROP_CHANNELS,
+	N_PROPERTIES
+};
+
+struct _YAlignOperation {
+	YOperation base;
+	int method;
+	int clock;
+	unsigned int rows;
+	GPtrArray *channels;
+};
+
+G_DEFINE_TYPE(YAlignOperation, y_align_operation, Y_TYPE_OPERATION);
+
+static void on_channel_changed(YData * data, gpointer user_data)
+{
+	g_object_notify(G_OBJECT(user_data), "channels");
+}
+
+static void
+y_align_operation_set_property(GObject * gobject, guint param_id,
+			       GValue const *value, GParamSpec * pspec)
+{
+	YAlignOperation *sop = Y_ALIGN_OPERATION(gobject);
+
+	switch (param_id) {
+	case ALIGN_PROP_METHOD:
+		sop->method = g_value_get_int(value);
+		break;
+	case ALIGN_PROP_CLOCK:
+		sop->clock = g_value_get_int(value);
+		break;
+	case ALIGN_PROP_ROWS:
+		sop->rows = g_value_get_uint(value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void
+y_align_operation_get_property(GObject * gobject, guint param_id,
+			       GValue * value, GParamSpec * pspec)
+{
+	YAlignOperation *sop = Y_ALIGN_OPERATION(gobject);
+
+	switch (param_id) {
+	case ALIGN_PROP_METHOD:
+		g_value_set_int(value, sop->method);
+		break;
+	case ALIGN_PROP_CLOCK:
+		g_value_set_int(value, sop->clock);
+		break;
+	case ALIGN_PROP_ROWS:
+		g_value_set_uint(value, sop->rows);
+		break;
+	case ALIGN_PROP_CHANNELS:
+		g_value_set_boxed(value, sop->channels);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void y_align_operation_dispose(GObject * obj)
+{
+	YAlignOperation *sop = Y_ALIGN_OPERATION(obj);
+	if (sop->channels) {
+		unsigned int i;
+		for (i = 0; i < sop->channels->len; i++) {
+			g_signal_handlers_disconnect_by_data(g_ptr_array_index
+							     (sop->channels, i),
+							     sop);
+		}
+		g_clear_pointer(&sop->channels, g_ptr_array_unref);
+	}
+	G_OBJECT_CLASS(y_align_operation_parent_class)->dispose(obj);
+}
+
+static
+int align_size(YOperation * op, YData * input, unsigned int *dims)
+{
+	YAlignOperation *sop = Y_ALIGN_OPERATION(op);
+	g_assert(dims);
+	g_assert(Y_IS_VECTOR(input));
+	dims[0] = 2 + (sop->channels ? sop->channels->len : 0);
+	dims[1] = sop->rows;
+	return 2;
+}
+
+typedef struct {
+	YRingVector *ring;	/* holds a reference */
+	gboolean timed;
+	guint64 seen;
+	/* samples not yet passed by the ticks: [pos,len) */
+	double *t;
+	double *v;
+	unsigned int len;
+	unsigned int size;
+	unsigned int pos;
+	unsigned int clk;	/* samples before this are in the tick queue */
+	/* last sample passed by the ticks */
+	gboolean has_last;
+	double last_t, last_v;
+} AlignChannel;
+
+typedef struct {
+	YAlignOperation sop;	/* channels is not valid in the copy */
+	unsigned int n_channels;
+	AlignChannel *channels;
+	/* clock ticks not yet output: [tpos,tlen) */
+	double *ticks;
+	unsigned int tlen;
+	unsigned int tsize;
+	unsigned int tpos;
+	gboolean has_tick;
+	double last_tick;
+	unsigned int *heap;
+	double *rowbuf;
+	unsigned int rowbuf_size;
+	double *output;
+	unsigned int output_size;
+} AlignOpData;
+
+static void align_channels_free(AlignOpData * d)
+{
+	unsigned int c;
+	for (c = 0; c < d->n_channels; c++) {
+		g_clear_object(&d->channels[c].ring);
+		g_free(d->channels[c].t);
+		g_free(d->channels[c].v);
+	}
+	g_clear_pointer(&d->channels, g_free);
+	g_clear_pointer(&d->heap, g_free);
+	d->n_channels = 0;
+}
+
+static YRingVector *align_get_channel(YAlignOperation * sop, YData * input,
+				      unsigned int c)
+{
+	if (c == 0)
+		return Y_IS_RING_VECTOR(input) ? Y_RING_VECTOR(input) : NULL;
+	return g_ptr_array_index(sop->channels, c - 1);
+}
+
+/* copy samples appended since the last run into the pending buffer */
+static void align_channel_load(AlignChannel * c, unsigned int cap)
+{
+	YRingVector *ts = c->ring ? y_ring_vector_get_timestamps(c->ring) : NULL;
+	c->timed = ts != NULL;
+	if (ts == NULL)
+		return;
+	unsigned int n = y_vector_get_len(Y_VECTOR(c->ring));
+	unsigned int nts = y_vector_get_len(Y_VECTOR(ts));
+	n = MIN(n, nts);
+	guint64 total = y_ring_vector_get_n_appended(c->ring);
+	guint64 first = total > n ? total - n : 0;
+	guint64 start = MAX(c->seen, first);
+	unsigned int cnt = total - start;
+	c->seen = total;
+	if (cnt == 0)
+		return;
+
+	unsigned int drop = MIN(c->pos, c->clk);
+	memmove(c->t, c->t + drop, (c->len - drop) * sizeof(double));
+	memmove(c->v, c->v + drop, (c->len - drop) * sizeof(double));
+	c->len -= drop;
+	c->pos -= drop;
+	c->clk -= drop;
+	if (c->len + cnt > c->size) {
+		c->size = MAX(c->len + cnt, 2 * c->size);
+		c->t = g_renew(double, c->t, c->size);
+		c->v = g_renew(double, c->v, c->size);
+	}
+	y_vector_get_values_range(Y_VECTOR(c->ring), start - first, cnt,
+				  c->v + c->len);
+	y_vector_get_values_range(Y_VECTOR(ts), nts - n + (start - first), cnt,
+				  c->t + c->len);
+	c->len += cnt;
+
+	if (c->len - c->pos > cap) {
+		/* nothing is consuming this channel; keep its newest samples */
+		c->pos = c->len - cap;
+		c->clk = MAX(c->clk, c->pos);
+		c->has_last = TRUE;
+		c->last_t = c->t[c->pos - 1];
+		c->last_v = c->v[c->pos - 1];
+	}
+}
+
+static
+gpointer align_op_create_data(YOperation * op, gpointer data, YData * input)
+{
+	if (input == NULL)
+		return NULL;
+	AlignOpData *d;
+	YAlignOperation *sop = Y_ALIGN_OPERATION(op);
+	if (data == NULL) {
+		d = g_new0(AlignOpData, 1);
+	} else {
+		d = (AlignOpData *) data;
+	}
+	unsigned int n_channels = 1 + (sop->channels ? sop->channels->len : 0);
+	unsigned int c;
+
+	gboolean restart = d->output == NULL || d->n_channels != n_channels
+	    || d->sop.method != sop->method || d->sop.clock != sop->clock
+	    || d->sop.rows != sop->rows;
+	for (c = 0; c < n_channels && !restart; c++) {
+		restart = d->channels[c].ring !=
+		    align_get_channel(sop, input, c);
+	}
+	d->sop = *sop;
+	d->sop.channels = NULL;
+
+	if (restart) {
+		align_channels_free(d);
+		d->n_channels = n_channels;
+		d->channels = g_new0(AlignChannel, n_channels);
+		d->heap = g_new(unsigned int, n_channels);
+		for (c = 0; c < n_channels; c++) {
+			YRingVector *r = align_get_channel(sop, input, c);
+			d->channels[c].ring = r ? g_object_ref(r) : NULL;
+		}
+		d->tlen = d->tpos = 0;
+		d->has_tick = FALSE;
+		unsigned int size = (n_channels + 1) * sop->rows;
+		if (size > d->output_size) {
+			d->output_size = size;
+			d->output = g_renew(double, d->output, size);
+		}
+		for (c = 0; c < size; c++) {
+			d->output[c] = NAN;
+		}
+	}
+
+	unsigned int cap = 2 * MAX(sop->rows, 1);
+	for (c = 0; c < n_channels; c++) {
+		align_channel_load(&d->channels[c], cap);
+	}
+	return d;
+}
+
+static
+void align_op_data_free(gpointer data)
+{
+	AlignOpData *d = (AlignOpData *) data;
+	align_channels_free(d);
+	g_free(d->ticks);
+	g_free(d->rowbuf);
+	g_free(d->output);
+	g_free(d);
+}
+
+static void align_push_tick(AlignOpData * d, double t)
+{
+	if (d->has_tick && !(t > d->last_tick))
+		return;
+	if (d->tlen == d->tsize) {
+		memmove(d->ticks, d->ticks + d->tpos,
+			(d->tlen - d->tpos) * sizeof(double));
+		d->tlen -= d->tpos;
+		d->tpos = 0;
+		if (d->tlen == d->tsize) {
+			d->tsize = MAX(64, 2 * d->tsize);
+			d->ticks = g_renew(double, d->ticks, d->tsize);
+		}
+	}
+	d->ticks[d->tlen++] = t;
+	d->has_tick = TRUE;
+	d->last_tick = t;
+}
+
+static inline double align_head(AlignOpData * d, unsigned int c)
+{
+	AlignChannel *ch = &d->channels[c];
+	return ch->t[ch->clk];
+}
+
+static void align_sift_down(AlignOpData * d, unsigned int size, unsigned int i)
+{
+	unsigned int *h = d->heap;
+	for (;;) {
+		unsigned int l = 2 * i + 1, r = l + 1, m = i;
+		if (l < size && align_head(d, h[l]) < align_head(d, h[m]))
+			m = l;
+		if (r < size && align_head(d, h[r]) < align_head(d, h[m]))
+			m = r;
+		if (m == i)
+			return;
+		unsigned int tmp = h[i];
+		h[i] = h[m];
+		h[m] = tmp;
+		i = m;
+	}
+}
+
+/* add the new timestamps of all channels to the tick queue in order */
+static void align_merge_ticks(AlignOpData * d)
+{
+	unsigned int size = 0;
+	unsigned int c;
+	for (c = 0; c < d->n_channels; c++) {
+		if (d->channels[c].clk < d->channels[c].len)
+			d->heap[size++] = c;
+	}
+	for (c = size / 2; c-- > 0;) {
+		align_sift_down(d, size, c);
+	}
+	while (size > 0) {
+		AlignChannel *ch = &d->channels[d->heap[0]];
+		align_push_tick(d, ch->t[ch->clk++]);
+		if (ch->clk == ch->len)
+			d->heap[0] = d->heap[--size];
+		align_sift_down(d, size, 0);
+	}
+}
+
+/* pass channel samples up to t; returns whether the value at t is known */
+static gboolean align_channel_advance(AlignChannel * c, double t,
+				      gboolean linear)
+{
+	while (c->pos < c->len && c->t[c->pos] <= t) {
+		c->has_last = TRUE;
+		c->last_t = c->t[c->pos];
+		c->last_v = c->v[c->pos];
+		c->pos++;
+	}
+	if (!linear || !c->timed)
+		return TRUE;
+	return c->pos < c->len || (c->has_last && c->last_t == t);
+}
+
+static double align_channel_value(const AlignChannel * c, double t,
+				  gboolean linear)
+{
+	if (!c->has_last)
+		return NAN;
+	if (!linear || c->last_t == t || c->pos == c->len)
+		return c->last_v;
+	double t1 = c->t[c->pos];
+	double v1 = c->v[c->pos];
+	return c->last_v + (v1 - c->last_v) * (t - c->last_t) / (t1 - c->last_t);
+}
+
+static
+gpointer align_op(gpointer input)
+{
+	AlignOpData *d = (AlignOpData *) input;
+
+	if (d == NULL || d->sop.rows == 0)
+		return NULL;
+
+	unsigned int rows = d->sop.rows;
+	unsigned int cols = d->n_channels + 1;
+	gboolean linear = d->sop.method == ALIGN_LINEAR;
+	unsigned int c;
+
+	if (d->sop.clock == ALIGN_CLOCK_MERGED) {
+		align_merge_ticks(d);
+	} else {
+		AlignChannel *ch = &d->channels[0];
+		for (; ch->clk < ch->len; ch->clk++) {
+			align_push_tick(d, ch->t[ch->clk]);
+		}
+		for (c = 1; c < d->n_channels; c++) {
+			d->channels[c].clk = d->channels[c].len;
+		}
+	}
+
+	unsigned int nnew = 0;
+	while (d->tpos < d->tlen) {
+		double t = d->ticks[d->tpos];
+		gboolean ready = TRUE;
+		for (c = 0; c < d->n_channels; c++) {
+			ready &= align_channel_advance(&d->channels[c], t, linear);
+		}
+		if (!ready && d->tlen - d->tpos <= rows)
+			break;
+		/* only the last rows ticks will be visible, so wrap around */
+		unsigned int r = nnew % rows;
+		if ((r + 1) * cols > d->rowbuf_size) {
+			d->rowbuf_size = MIN(MAX((r + 1) * cols,
+						 2 * d->rowbuf_size), rows * cols);
+			d->rowbuf = g_renew(double, d->rowbuf, d->rowbuf_size);
+		}
+		double *row = d->rowbuf + r * cols;
+		row[0] = t;
+		for (c = 0; c < d->n_channels; c++) {
+			row[c + 1] = align_channel_value(&d->channels[c], t, linear);
+		}
+		nnew++;
+		d->tpos++;
+	}
+
+	if (nnew >= rows) {
+		unsigned int r = nnew % rows;
+		memcpy(d->output, d->rowbuf + r * cols,
+		       (rows - r) * cols * sizeof(double));
+		memcpy(d->output + (rows - r) * cols, d->rowbuf,
+		       r * cols * sizeof(double));
+	} else if (nnew > 0) {
+		memmove(d->output, d->output + nnew * cols,
+			(rows - nnew) * cols * sizeof(double));
+		memcpy(d->output + (rows - nnew) * cols, d->rowbuf,
+		       nnew * cols * sizeof(double));
+	}
+	return d->output;
+}
+
+static void y_align_operation_class_init(YAlignOperationClass * klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->set_property = y_align_operation_set_property;
+	gobject_klass->get_property = y_align_operation_get_property;
+	gobject_klass->dispose = y_align_operation_dispose;
+	YOperationClass *op_klass = (YOperationClass *) klass;
+	op_klass->thread_safe = TRUE;
+	op_klass->op_size = align_size;
+	op_klass->op_func = align_op;
+	op_klass->op_data = align_op_create_data;
+	op_klass->op_data_free = align_op_data_free;
+
+	g_object_class_install_property(gobject_klass, ALIGN_PROP_METHOD,
+					g_param_spec_int("method", "Method",
+							 "How channels are sampled at the ticks",
+							 ALIGN_HOLD,
+							 ALIGN_LINEAR,
+							 ALIGN_HOLD,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, ALIGN_PROP_CLOCK,
+					g_param_spec_int("clock", "Clock",
+							 "Where the ticks come from",
+							 ALIGN_CLOCK_INPUT,
+							 ALIGN_CLOCK_MERGED,
+							 ALIGN_CLOCK_INPUT,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, ALIGN_PROP_ROWS,
+					g_param_spec_uint("rows", "Rows",
+							  "Number of ticks in the output",
+							  1, G_MAXUINT, 1000,
+							  G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, ALIGN_PROP_CHANNELS,
+					g_param_spec_boxed("channels", "Channels",
+							   "Ring vectors aligned with the input",
+							   G_TYPE_PTR_ARRAY,
+							   G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+}
+
+static void y_align_operation_init(YAlignOperation * sop)
+{
+	g_assert(Y_IS_ALIGN_OPERATION(sop));
+	sop->rows = 1000;
+	sop->channels = g_ptr_array_new_with_free_func(g_object_unref);
+}
+
+/**
+ * y_align_operation_new:
+ * @method: %ALIGN_HOLD or %ALIGN_LINEAR
+ * @rows: number of ticks in the output
+ *
+ * Create a new alignment operation. The ticks come from the input's
+ * timestamps until the "clock" property is changed.
+ *
+ * Returns: a #YOperation
+ **/
+YOperation *y_align_operation_new(int method, unsigned rows)
+{
+	return g_object_new(Y_TYPE_ALIGN_OPERATION, "method", method, "rows",
+			    rows, NULL);
+}
+
+/**
+ * y_align_operation_add_channel:
+ * @op: a #YAlignOperation
+ * @channel: a #YRingVector that tracks timestamps
+ *
+ * Add a channel to be aligned with the input. Its values go in the next
+ * column of the output.
+ **/
+void y_align_operation_add_channel(YAlignOperation * op, YRingVector * channel)
+{
+	g_return_if_fail(Y_IS_ALIGN_OPERATION(op));
+	g_return_if_fail(Y_IS_RING_VECTOR(channel));
+	g_return_if_fail(y_ring_vector_get_timestamps(channel) != NULL);
+	g_ptr_array_add(op->channels, g_object_ref_sink(channel));
+	g_signal_connect(channel, "changed", G_CALLBACK(on_channel_changed), op);
+	g_object_notify(G_OBJECT(op), "channels");
+}
@@ -0,0 +1,52 @@
+/*
+ * y-align-operation.h :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef OP_ALIGN_H
+#define OP_ALIGN_H
+
+#include <y-data-class.h>
+#include <y-operation.h>
+#include <y-vector-ring.h>
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE(YAlignOperation,y_align_operation,Y,ALIGN_OPERATION,YOperation)
+
+#define Y_TYPE_ALIGN_OPERATION  (y_align_operation_get_type ())
+
+/* how channels are sampled at the clock ticks */
+enum {
+	ALIGN_HOLD = 0,
+	ALIGN_LINEAR
+};
+
+/* where the clock ticks come from */
+enum {
+	ALIGN_CLOCK_INPUT = 0,
+	ALIGN_CLOCK_MERGED
+};
+
+YOperation *y_align_operation_new (int method, unsigned rows);
+void y_align_operation_add_channel (YAlignOperation *op, YRingVector *channel);
+
+G_END_DECLS
+
+#endif
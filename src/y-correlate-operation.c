@@ -0,0 +1,441 @@
+/*
+ * y-correlate-operation.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <memory.h>
+#include <math.h>
+#include <complex.h>
+#include "y-correlate-operation.h"
+
+/**
+ * SECTION: y-correlate-operation
+ * @short_description: Operation that cross-correlates a vector with a
+ * reference.
+ *
+ * This operation computes the cross-correlation of an input vector x of
+ * length n with a reference vector r of length m,
+ * c[k] = sum_i x[i+k] r[i], for lags k from -(m-1) to n-1. The output vector
+ * has n+m-1 elements, and element j holds the lag j-(m-1), so a positive lag
+ * means the input is delayed relative to the reference. Without a reference,
+ * the autocorrelation of the input is computed.
+ *
+ * The correlation is computed with FFTs zero padded to at least n+m-1
+ * points, using plans from the plan cache. The transform of the reference is
+ * kept, and is recomputed only when the reference emits "changed" or is
+ * replaced, so correlating a stream of traces against a fixed reference
+ * costs one forward and one inverse transform per trace.
+ *
+ * With %CORRELATE_NORMALIZED, the correlation is divided by the product of
+ * the norms of the input and the reference, so that identical shapes give a
+ * peak of 1. %CORRELATE_COEFFICIENT subtracts the means first, giving the
+ * correlation coefficient. With %CORRELATE_OUTPUT_PEAK_LAG, the output is a
+ * scalar holding the lag of the largest element of the correlation, refined
+ * to a fraction of a sample by fitting a parabola through it and its two
+ * neighbors.
+ */
+
+enum {
+	CORRELATE_PROP_0,
+	CORRELATE_PROP_REFERENCE,
+	CORRELATE_PROP_MODE,
+	CORRELATE_PROP_OUTPUT,
+	N_PROPERTIES
+};
+
+struct _YCorrelateOperation {
+	YOperation base;
+	YVector *reference;
+	gulong handler;
+	guchar mode;
+	guchar output;
+};
+
+G_DEFINE_TYPE(YCorrelateOperation, y_correlate_operation, Y_TYPE_OPERATION);
+
+static void on_reference_changed(YData * data, gpointer user_data)
+{
+	g_object_notify(G_OBJECT(user_data), "reference");
+}
+
+static void correlate_set_reference(YCorrelateOperation * sop,
+				    YVector * reference)
+{
+	if (sop->reference == reference)
+		return;
+	if (sop->reference) {
+		g_signal_handler_disconnect(sop->reference, sop->handler);
+		g_object_unref(sop->reference);
+		sop->handler = 0;
+	}
+	sop->reference = reference;
+	if (reference) {
+		g_object_ref(reference);
+		sop->handler =
+		    g_signal_connect(reference, "changed",
+				     G_CALLBACK(on_reference_changed), sop);
+	}
+}
+
+static void
+y_correlate_operation_set_property(GObject * gobject, guint param_id,
+				   GValue const *value, GParamSpec * pspec)
+{
+	YCorrelateOperation *sop = Y_CORRELATE_OPERATION(gobject);
+
+	switch (param_id) {
+	case CORRELATE_PROP_REFERENCE:
+		correlate_set_reference(sop, g_value_get_object(value));
+		break;
+	case CORRELATE_PROP_MODE:
+		sop->mode = g_value_get_int(value);
+		break;
+	case CORRELATE_PROP_OUTPUT:
+		sop->output = g_value_get_int(value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void
+y_correlate_operation_get_property(GObject * gobject, guint param_id,
+				   GValue * value, GParamSpec * pspec)
+{
+	YCorrelateOperation *sop = Y_CORRELATE_OPERATION(gobject);
+
+	switch (param_id) {
+	case CORRELATE_PROP_REFERENCE:
+		g_value_set_object(value, sop->reference);
+		break;
+	case CORRELATE_PROP_MODE:
+		g_value_set_int(value, sop->mode);
+		break;
+	case CORRELATE_PROP_OUTPUT:
+		g_value_set_int(value, sop->output);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void y_correlate_operation_dispose(GObject * obj)
+{
+	YCorrelateOperation *sop = Y_CORRELATE_OPERATION(obj);
+	correlate_set_reference(sop, NULL);
+	G_OBJECT_CLASS(y_correlate_operation_parent_class)->dispose(obj);
+}
+
+static
+int correlate_size(YOperation * op, YData * input, unsigned int *dims)
+{
+	YCorrelateOperation *sop = Y_CORRELATE_OPERATION(op);
+	g_assert(dims);
+	g_assert(Y_IS_VECTOR(input));
+	if (sop->output == CORRELATE_OUTPUT_PEAK_LAG) {
+		return 0;
+	}
+	unsigned int n = y_vector_get_len(Y_VECTOR(input));
+	unsigned int m = sop->reference ? y_vector_get_len(sop->reference) : n;
+	dims[0] = (n > 0 && m > 0) ? n + m - 1 : 0;
+	return 1;
+}
+
+typedef struct {
+	YCorrelateOperation sop;	/* reference is not valid in the copy */
+	/* input */
+	double *input;
+	unsigned int n;
+	unsigned int input_size;
+	/* copy of the reference; NULL values means autocorrelation */
+	YVector *ref;
+	guint64 ref_gen;
+	double *rvalues;
+	unsigned int m;
+	/* transforms */
+	unsigned int fft_len;
+	double *fbuf;
+	fftw_complex *xspec;
+	fftw_complex *rspec;
+	fftw_plan fwd;
+	fftw_plan inv;
+	/* the reference transform is valid for this mode */
+	gboolean rspec_valid;
+	int rspec_mode;
+	double rnorm;
+	/* output */
+	double *output;
+	unsigned int output_size;
+	double peak;
+} CorrelateOpData;
+
+static void correlate_free_fft(CorrelateOpData * d)
+{
+	fftw_free(d->fbuf);
+	fftw_free(d->xspec);
+	fftw_free(d->rspec);
+	d->fbuf = NULL;
+	d->xspec = NULL;
+	d->rspec = NULL;
+	y_fft_plan_release(d->fwd);
+	y_fft_plan_release(d->inv);
+	d->fwd = NULL;
+	d->inv = NULL;
+	d->fft_len = 0;
+}
+
+static
+gpointer correlate_op_create_data(YOperation * op, gpointer data,
+				  YData * input)
+{
+	if (input == NULL)
+		return NULL;
+	CorrelateOpData *d;
+	YCorrelateOperation *sop = Y_CORRELATE_OPERATION(op);
+	if (data == NULL) {
+		d = g_new0(CorrelateOpData, 1);
+	} else {
+		d = (CorrelateOpData *) data;
+	}
+	d->sop = *sop;
+	d->sop.reference = NULL;
+
+	YVector *vec = Y_VECTOR(input);
+	d->n = y_vector_get_len(vec);
+	if (d->n > d->input_size) {
+		d->input_size = d->n;
+		d->input = g_renew(double, d->input, d->input_size);
+	}
+	if (d->n > 0) {
+		memcpy(d->input, y_vector_get_values(vec),
+		       d->n * sizeof(double));
+	}
+
+	/* copy the reference only if it is new or has changed */
+	if (sop->reference == NULL) {
+		g_clear_object(&d->ref);
+		g_clear_pointer(&d->rvalues, g_free);
+		d->m = d->n;
+		d->rspec_valid = FALSE;
+	} else if (d->ref != sop->reference
+		   || d->ref_gen != y_data_get_generation(Y_DATA(sop->reference))) {
+		if (d->ref != sop->reference) {
+			g_clear_object(&d->ref);
+			d->ref = g_object_ref(sop->reference);
+		}
+		d->ref_gen = y_data_get_generation(Y_DATA(d->ref));
+		d->m = y_vector_get_len(d->ref);
+		g_free(d->rvalues);
+		d->rvalues = g_memdup(y_vector_get_values(d->ref),
+				      MAX(d->m, 1) * sizeof(double));
+		d->rspec_valid = FALSE;
+	}
+
+	if (d->n == 0 || d->m == 0) {
+		return d;
+	}
+	unsigned int len = d->n + d->m - 1;
+	if (len > d->output_size) {
+		d->output_size = len;
+		d->output = g_renew(double, d->output, d->output_size);
+	}
+	unsigned int L = y_fft_padded_length(FFT_PAD_SMOOTH, len);
+	if (L != d->fft_len) {
+		correlate_free_fft(d);
+		unsigned int nc = L / 2 + 1;
+		d->fft_len = L;
+		d->fbuf = fftw_alloc_real(L);
+		d->xspec = fftw_alloc_complex(nc);
+		d->rspec = fftw_alloc_complex(nc);
+		d->fwd = y_fft_plan_r2c_1d(L, d->fbuf, d->xspec, FFT_ESTIMATE);
+		d->inv = y_fft_plan_c2r_1d(L, d->xspec, d->fbuf, FFT_ESTIMATE);
+		d->rspec_valid = FALSE;
+	}
+	return d;
+}
+
+static
+void correlate_op_data_free(gpointer data)
+{
+	CorrelateOpData *d = (CorrelateOpData *) data;
+	correlate_free_fft(d);
+	g_clear_object(&d->ref);
+	g_free(d->rvalues);
+	g_free(d->input);
+	g_free(d->output);
+	g_free(d);
+}
+
+/* copy v into the zero padded transform buffer, subtracting the mean for
+ * CORRELATE_COEFFICIENT, and return the sum of squares */
+static double correlate_load(CorrelateOpData * d, const double *v,
+			     unsigned int n)
+{
+	unsigned int i;
+	double mean = 0.0;
+	double sum2 = 0.0;
+	if (d->sop.mode == CORRELATE_COEFFICIENT) {
+		for (i = 0; i < n; i++) {
+			mean += v[i];
+		}
+		mean /= n;
+	}
+	for (i = 0; i < n; i++) {
+		double x = v[i] - mean;
+		d->fbuf[i] = x;
+		sum2 += x * x;
+	}
+	memset(d->fbuf + n, 0, (d->fft_len - n) * sizeof(double));
+	return sum2;
+}
+
+static
+gpointer correlate_op(gpointer input)
+{
+	CorrelateOpData *d = (CorrelateOpData *) input;
+
+	if (d == NULL || d->n == 0 || d->m == 0)
+		return NULL;
+	if (d->fwd == NULL || d->inv == NULL)
+		return NULL;
+
+	unsigned int L = d->fft_len;
+	unsigned int nc = L / 2 + 1;
+	unsigned int m = d->m;
+	unsigned int len = d->n + m - 1;
+	unsigned int i;
+
+	double xnorm = correlate_load(d, d->input, d->n);
+	fftw_execute_dft_r2c(d->fwd, d->fbuf, d->xspec);
+	if (d->rvalues == NULL) {
+		d->rnorm = xnorm;
+		for (i = 0; i < nc; i++) {
+			d->xspec[i] *= conj(d->xspec[i]) / L;
+		}
+	} else {
+		if (!d->rspec_valid || d->rspec_mode != d->sop.mode) {
+			d->rnorm = correlate_load(d, d->rvalues, m);
+			fftw_execute_dft_r2c(d->fwd, d->fbuf, d->rspec);
+			d->rspec_valid = TRUE;
+			d->rspec_mode = d->sop.mode;
+		}
+		for (i = 0; i < nc; i++) {
+			d->xspec[i] *= conj(d->rspec[i]) / L;
+		}
+	}
+	fftw_execute_dft_c2r(d->inv, d->xspec, d->fbuf);
+
+	/* negative lags wrap around to the end of the circular correlation */
+	double scale = 1.0;
+	if (d->sop.mode != CORRELATE_RAW && xnorm > 0.0 && d->rnorm > 0.0) {
+		scale = 1.0 / sqrt(xnorm * d->rnorm);
+	}
+	for (i = 0; i < m - 1; i++) {
+		d->output[i] = scale * d->fbuf[L - (m - 1) + i];
+	}
+	for (i = m - 1; i < len; i++) {
+		d->output[i] = scale * d->fbuf[i - (m - 1)];
+	}
+
+	if (d->sop.output != CORRELATE_OUTPUT_PEAK_LAG) {
+		return d->output;
+	}
+	unsigned int j = 0;
+	for (i = 1; i < len; i++) {
+		if (d->output[i] > d->output[j]) {
+			j = i;
+		}
+	}
+	double delta = 0.0;
+	if (j > 0 && j < len - 1) {
+		double a = d->output[j - 1];
+		double b = d->output[j];
+		double c = d->output[j + 1];
+		double den = a - 2.0 * b + c;
+		if (den < 0.0) {
+			delta = 0.5 * (a - c) / den;
+		}
+	}
+	d->peak = (double)j - (double)(m - 1) + delta;
+	return &d->peak;
+}
+
+static void y_correlate_operation_class_init(YCorrelateOperationClass *
+					     klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->set_property = y_correlate_operation_set_property;
+	gobject_klass->get_property = y_correlate_operation_get_property;
+	gobject_klass->dispose = y_correlate_operation_dispose;
+	YOperationClass *op_klass = (YOperationClass *) klass;
+	op_klass->thread_safe = TRUE;
+	op_klass->op_size = correlate_size;
+	op_klass->op_func = correlate_op;
+	op_klass->op_data = correlate_op_create_data;
+	op_klass->op_data_free = correlate_op_data_free;
+
+	g_object_class_install_property(gobject_klass,
+					CORRELATE_PROP_REFERENCE,
+					g_param_spec_object("reference",
+							    "Reference",
+							    "Vector the input is correlated with, or NULL for the autocorrelation",
+							    Y_TYPE_VECTOR,
+							    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, CORRELATE_PROP_MODE,
+					g_param_spec_int("mode", "Mode",
+							 "How the correlation is normalized",
+							 CORRELATE_RAW,
+							 CORRELATE_COEFFICIENT,
+							 CORRELATE_RAW,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, CORRELATE_PROP_OUTPUT,
+					g_param_spec_int("output", "Output",
+							 "Whether to output the correlation or the lag of its peak",
+							 CORRELATE_OUTPUT_FULL,
+							 CORRELATE_OUTPUT_PEAK_LAG,
+							 CORRELATE_OUTPUT_FULL,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void y_correlate_operation_init(YCorrelateOperation * sop)
+{
+	g_assert(Y_IS_CORRELATE_OPERATION(sop));
+	sop->reference = NULL;
+	sop->mode = CORRELATE_RAW;
+	sop->output = CORRELATE_OUTPUT_FULL;
+}
+
+/**
+ * y_correlate_operation_new:
+ * @reference: (nullable): the reference vector, or %NULL
+ *
+ * Create a new correlation operation. If @reference is %NULL, the operation
+ * computes the autocorrelation of its input.
+ *
+ * Returns: a #YOperation
+ **/
+YOperation *y_correlate_operation_new(YVector * reference)
+{
+	return g_object_new(Y_TYPE_CORRELATE_OPERATION, "reference",
+			    reference, NULL);
+}
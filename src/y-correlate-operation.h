@@ -0,0 +1,52 @@
+/*
+ * y-correlate-operation.h :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef OP_CORRELATE_H
+#define OP_CORRELATE_H
+
+#include <y-data-class.h>
+#include <y-operation.h>
+#include <y-fft-util.h>
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE(YCorrelateOperation,y_correlate_operation,Y,CORRELATE_OPERATION,YOperation)
+
+#define Y_TYPE_CORRELATE_OPERATION  (y_correlate_operation_get_type ())
+
+/* normalization */
+enum {
+	CORRELATE_RAW = 0,
+	CORRELATE_NORMALIZED,
+	CORRELATE_COEFFICIENT
+};
+
+/* output */
+enum {
+	CORRELATE_OUTPUT_FULL = 0,
+	CORRELATE_OUTPUT_PEAK_LAG
+};
+
+YOperation *y_correlate_operation_new (YVector *reference);
+
+G_END_DECLS
+
+#endif
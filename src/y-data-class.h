@@ -110,6 +110,13 @@ YData *y_val_scalar_new(double val);
 double *y_val_scalar_get_val(YValScalar * s);
 void y_val_scalar_set_val(YValScalar *s, double val);
 
+/* how y_vector_find_index() matches a value */
+enum {
+	FIND_INDEX_NEAREST = 0,
+	FIND_INDEX_FLOOR,
+	FIND_INDEX_CEIL
+};
+
 G_DECLARE_DERIVABLE_TYPE(YVector, y_vector, Y, VECTOR, YData)
 
 #define Y_TYPE_VECTOR	(y_vector_get_type ())
@@ -121,6 +128,12 @@ G_DECLARE_DERIVABLE_TYPE(YVector, y_vector, Y, VECTOR, YData)
  * @load_values: loads the values and returns them.
  * @get_value: gets a value.
  * @replace_cache: replaces array cache
+ * @locate: for vectors whose values increase or decrease according to a
+ * formula, returns the approximate index at which a value would be found;
+ * %NULL for other vectors.
+ * @load_range: computes some of the values without loading the cache, or %NULL.
+ * @minmax_range: computes the minimum and maximum of the values in a
+ * nonempty range without loading them, or %NULL.
  *
  * Class for YVector.
  **/
@@ -132,6 +145,9 @@ struct _YVectorClass {
 	double *(*load_values) (YVector * vec);
 	double (*get_value) (YVector * vec, unsigned i);
 	double *(*replace_cache) (YVector *vec, unsigned len);
+	double (*locate) (YVector *vec, double x);
+	void (*load_range) (YVector *vec, unsigned start, unsigned n, double *out);
+	void (*minmax_range) (YVector *vec, unsigned start, unsigned end, double *min, double *max);
 };
 
 G_DECLARE_DERIVABLE_TYPE(YMatrix, y_matrix, Y, MATRIX, YData)
@@ -144,6 +160,11 @@ G_DECLARE_DERIVABLE_TYPE(YMatrix, y_matrix, Y, MATRIX, YData)
  * @load_size: loads the matrix length.
  * @load_values: loads the values in the cache.
  * @get_value: gets a value.
+ * @replace_cache: replaces array cache
+ * @load_range: computes some of the values, counting along rows, without
+ * loading the cache, or %NULL.
+ * @load_minmax: computes the minimum and maximum without loading the values,
+ * or %NULL.
  *
  * Class for YMatrix.
  **/
@@ -155,6 +176,8 @@ struct _YMatrixClass {
 	double *(*load_values) (YMatrix * vec);
 	double (*get_value) (YMatrix * mat, unsigned i, unsigned j);
 	double *(*replace_cache) (YMatrix *vec, unsigned len);
+	void (*load_range) (YMatrix *mat, unsigned start, unsigned n, double *out);
+	void (*load_minmax) (YMatrix *mat, double *min, double *max);
 };
 
 G_DECLARE_DERIVABLE_TYPE(YThreeDArray, y_three_d_array, Y, THREE_D_ARRAY, YData)
@@ -185,6 +208,7 @@ YData *y_data_dup_to_simple(YData * src);
 
 char *y_data_serialize(YData * dat, gpointer user);
 void y_data_emit_changed(YData * dat);
+guint64 y_data_get_generation(YData * dat);
 
 gboolean y_data_has_value(YData * data);
 
@@ -201,9 +225,13 @@ char *y_scalar_get_str(YScalar * scalar, const gchar * format);
 unsigned int y_vector_get_len(YVector * vec);
 const double *y_vector_get_values(YVector * vec);
 double y_vector_get_value(YVector * vec, unsigned i);
+void y_vector_get_values_range(YVector * vec, unsigned int start, unsigned int n, double *out);
 char *y_vector_get_str(YVector * vec, unsigned int i, const gchar * format);
 gboolean y_vector_is_varying_uniformly(YVector * data);
+int y_vector_find_index(YVector * vec, double x, int mode);
 void y_vector_get_minmax(YVector * vec, double *min, double *max);
+void y_vector_get_minmax_range(YVector * vec, unsigned int start, unsigned int end, double *min, double *max);
+void y_vector_emit_changed_range(YVector * vec, unsigned int start, unsigned int end);
 
 /* to be used only by subclasses */
 double* y_vector_replace_cache(YVector *vec, unsigned len);
@@ -215,6 +243,7 @@ unsigned int y_matrix_get_rows(YMatrix * mat);
 unsigned int y_matrix_get_columns(YMatrix * mat);
 const double *y_matrix_get_values(YMatrix * mat);
 double y_matrix_get_value(YMatrix * mat, unsigned i, unsigned j);
+void y_matrix_get_values_range(YMatrix * mat, unsigned int start, unsigned int n, double *out);
 char *y_matrix_get_str(YMatrix * mat, unsigned i, unsigned j,
 		       const gchar * format);
 void y_matrix_get_minmax(YMatrix * mat, double *min, double *max);
@@ -81,7 +81,12 @@ typedef struct {
 	gulong handler;
 	unsigned int autorun : 1;
 	unsigned int running : 1;	/* is operation currently running? */
+	unsigned int pending : 1;	/* did input change while running? */
+	unsigned int has_result : 1;	/* result not yet loaded into cache */
 	gpointer task_data;
+	double *result;		/* output of the last threaded run */
+	unsigned int result_dims[3];
+	int result_ndims;
 } Derived;
 
 static
@@ -103,6 +108,79 @@ void finalize_derived(Derived *d) {
 	if (d->op) {
 		g_object_unref(d->op);
 	}
+	g_free(d->result);
+}
+
+static gsize derived_result_len(Derived *d)
+{
+	switch (d->result_ndims) {
+	case 0:
+		return 1;
+	case 1:
+		return d->result_dims[0];
+	default:
+		return (gsize) d->result_dims[0] * d->result_dims[1];
+	}
+}
+
+/* Take a snapshot of the input and start the operation in a worker thread.
+ * The derived object is kept alive until the task completes, and the task
+ * data must not be touched from the main thread until then. */
+static gboolean derived_run_in_thread(Derived *d, YData *self,
+				      GAsyncReadyCallback cb)
+{
+	YOperationClass *klass = Y_OPERATION_GET_CLASS(d->op);
+	if (d->task_data == NULL) {
+		d->task_data = y_operation_create_task_data(d->op, d->input);
+	} else {
+		y_operation_update_task_data(d->op, d->task_data, d->input);
+	}
+	if (d->task_data == NULL) {
+		return FALSE;
+	}
+	d->result_ndims = klass->op_size(d->op, d->input, d->result_dims);
+	d->running = TRUE;
+	y_operation_run_task(d->op, d->task_data, cb, g_object_ref(self));
+	return TRUE;
+}
+
+/* called on the main thread when a task started by derived_run_in_thread()
+ * completes; copies the output so the task data can be reused */
+static void derived_finish_task(Derived *d, GAsyncResult *res)
+{
+	double *out = g_task_propagate_pointer(G_TASK(res), NULL);
+	d->running = FALSE;
+	if (out != NULL) {
+		gsize len = derived_result_len(d);
+		d->result = g_renew(double, d->result, len);
+		memcpy(d->result, out, len * sizeof(double));
+		d->has_result = TRUE;
+	}
+}
+
+static void derived_on_input_changed(Derived *d, YData *self,
+				     GAsyncReadyCallback cb)
+{
+	if (d->running) {
+		/* run again with the latest input once this run is done */
+		d->pending = TRUE;
+		return;
+	}
+	if (!derived_run_in_thread(d, self, cb)) {
+		y_data_emit_changed(self);
+	}
+}
+
+static void derived_task_done(Derived *d, YData *self,
+			      GAsyncResult *res, GAsyncReadyCallback cb)
+{
+	derived_finish_task(d, res);
+	y_data_emit_changed(self);
+	if (d->pending) {
+		d->pending = FALSE;
+		derived_run_in_thread(d, self, cb);
+	}
+	g_object_unref(self);
 }
 
 static gboolean
@@ -164,6 +242,16 @@ static double scalar_derived_get_value(YScalar * sca)
 
 	g_return_val_if_fail(klass->op_size(scas->der.op,scas->der.input, dims)==0,NAN);
 
+	if (scas->der.has_result) {
+		scas->der.has_result = FALSE;
+		scas->cache = scas->der.result[0];
+		return scas->cache;
+	}
+	if (scas->der.running) {
+		/* a worker thread owns the task data */
+		return scas->cache;
+	}
+
 	/* call op */
 	if (scas->der.task_data == NULL) {
 		scas->der.task_data =
@@ -173,19 +261,18 @@ static double scalar_derived_get_value(YScalar * sca)
 					     scas->der.input);
 	}
 	double *dout = klass->op_func(scas->der.task_data);
+	if (dout == NULL)
+		return NAN;
 
+	scas->cache = *dout;
 	return *dout;
 }
 
 static void
 scalar_op_cb(GObject * source_object, GAsyncResult * res, gpointer user_data)
 {
-	/* set outputs */
-	GTask *task = G_TASK(res);
-	g_task_propagate_pointer(task, NULL);
 	YDerivedScalar *d = (YDerivedScalar *) user_data;
-	d->der.running = FALSE;
-	y_data_emit_changed(Y_DATA(user_data));
+	derived_task_done(&d->der, Y_DATA(d), res, scalar_op_cb);
 }
 
 static void scalar_on_input_changed(YData * data, gpointer user_data)
@@ -194,20 +281,13 @@ static void scalar_on_input_changed(YData * data, gpointer user_data)
 	if (!d->der.autorun) {
 		y_data_emit_changed(Y_DATA(d));
 	} else {
-		if (d->der.running)
-			return;
-		d->der.running = TRUE;
 		YOperationClass *klass = Y_OPERATION_GET_CLASS(d->der.op);
 		if (klass->thread_safe) {
-			/* get task data, run in a thread */
-			y_operation_update_task_data(d->der.op,
-						     d->der.task_data, data);
-			y_operation_run_task(d->der.op, d->der.task_data,
-					     scalar_op_cb, d);
+			derived_on_input_changed(&d->der, Y_DATA(d),
+						 scalar_op_cb);
 		} else {
 			/* load new values into the cache */
 			d->cache = scalar_derived_get_value(Y_SCALAR(d));
-			d->der.running = FALSE;
 			y_data_emit_changed(Y_DATA(d));
 		}
 	}
@@ -348,7 +428,7 @@ YData *y_derived_scalar_new(YData * input, YOperation * op)
 
 struct _YDerivedVector {
 	YVector base;
-	unsigned int currlen;
+	unsigned int currlen;	/* length of the values in the cache */
 	Derived der;
 };
 
@@ -392,7 +472,10 @@ static unsigned int vector_derived_load_len(YVector * vec)
 
 	unsigned int newdim;
 	g_assert(klass->op_size);
-	if (vecd->der.input) {
+	if (vecd->der.has_result) {
+		/* length of the output that is waiting to be loaded */
+		newdim = vecd->der.result_dims[0];
+	} else if (vecd->der.input) {
 		int ndims =
 		    klass->op_size(vecd->der.op, vecd->der.input, &newdim);
 		g_assert(ndims == 1);
@@ -402,6 +485,13 @@ static unsigned int vector_derived_load_len(YVector * vec)
 	return newdim;
 }
 
+static void fill_nan(double *v, size_t n)
+{
+	size_t i;
+	for (i = 0; i < n; i++)
+		v[i] = NAN;
+}
+
 static double *vector_derived_load_values(YVector * vec)
 {
 	YDerivedVector *vecs = (YDerivedVector *) vec;
@@ -410,15 +500,31 @@ static double *vector_derived_load_values(YVector * vec)
 
 	unsigned int len = y_vector_get_len(vec);
 
-	if (vecs->currlen != len) {
-		v=y_vector_replace_cache(vec,len);
-		vecs->currlen = len;
-	} else {
-		v = y_vector_replace_cache(vec,vecs->currlen);
+	if (vecs->der.running && !vecs->der.has_result) {
+		/* a worker thread owns the task data. The old values are
+		 * shown until it is done, but only if they still have the
+		 * right length; otherwise they are missing (NaN) until then. */
+		if (vecs->currlen == len)
+			return y_vector_replace_cache(vec, len);
+		v = y_vector_replace_cache(vec, len);
+		vecs->currlen = 0;
+		if (v != NULL)
+			fill_nan(v, len);
+		return v;
 	}
+
+	v = y_vector_replace_cache(vec, len);
+	vecs->currlen = 0;
 	if (v == NULL)
 		return NULL;
 
+	if (vecs->der.has_result) {
+		vecs->der.has_result = FALSE;
+		memcpy(v, vecs->der.result, len * sizeof(double));
+		vecs->currlen = len;
+		return v;
+	}
+
 	/* call op */
 	YOperationClass *klass = Y_OPERATION_GET_CLASS(vecs->der.op);
 	if (vecs->der.task_data == NULL) {
@@ -429,9 +535,12 @@ static double *vector_derived_load_values(YVector * vec)
 					     vecs->der.input);
 	}
 	double *dout = klass->op_func(vecs->der.task_data);
-	if (dout == NULL)
-		return NULL;
+	if (dout == NULL) {
+		fill_nan(v, len);
+		return v;
+	}
 	memcpy(v, dout, len * sizeof(double));
+	vecs->currlen = len;
 
 	return v;
 }
@@ -439,18 +548,16 @@ static double *vector_derived_load_values(YVector * vec)
 static double vector_derived_get_value(YVector * vec, unsigned i)
 {
 	const double *d = y_vector_get_values(vec);	/* fills the cache */
+	if (d == NULL)
+		return NAN;
 	return d[i];
 }
 
 static void
 op_cb(GObject * source_object, GAsyncResult * res, gpointer user_data)
 {
-	/* set outputs */
-	GTask *task = G_TASK(res);
-	g_task_propagate_pointer(task, NULL);
 	YDerivedVector *d = (YDerivedVector *) user_data;
-	d->der.running = FALSE;
-	y_data_emit_changed(Y_DATA(user_data));
+	derived_task_done(&d->der, Y_DATA(d), res, op_cb);
 }
 
 static void on_input_changed_after(YData * data, gpointer user_data)
@@ -462,20 +569,12 @@ static void on_input_changed_after(YData * data, gpointer user_data)
 	if (!d->der.autorun) {
 		y_data_emit_changed(Y_DATA(d));
 	} else {
-		if (d->der.running)
-			return;
-		d->der.running = TRUE;
 		YOperationClass *klass = Y_OPERATION_GET_CLASS(d->der.op);
 		if (klass->thread_safe) {
-			/* get task data, run in a thread */
-			y_operation_update_task_data(d->der.op,
-						     d->der.task_data, data);
-			y_operation_run_task(d->der.op, d->der.task_data, op_cb,
-					     d);
+			derived_on_input_changed(&d->der, Y_DATA(d), op_cb);
 		} else {
 			/* load new values into the cache */
 			vector_derived_load_values(Y_VECTOR(d));
-			d->der.running = FALSE;
 			y_data_emit_changed(Y_DATA(d));
 		}
 	}
@@ -621,7 +720,7 @@ struct _YDerivedMatrix {
 	YMatrixSize currsize;
 	Derived der;
 	double *cache;
-	/* might need access to whether cache is OK */
+	gboolean cache_filled;	/* cache holds values of size currsize */
 };
 
 static GParamSpec *matrix_properties[N_PROPERTIES] = { NULL, };
@@ -656,7 +755,11 @@ static YMatrixSize derived_matrix_load_size(YMatrix * vec)
 
 	unsigned int newdim[2];
 	g_assert(klass->op_size);
-	if (vecd->der.input) {
+	if (vecd->der.has_result) {
+		/* size of the output that is waiting to be loaded */
+		newdim[0] = vecd->der.result_dims[0];
+		newdim[1] = vecd->der.result_dims[1];
+	} else if (vecd->der.input) {
 		int ndims =
 		    klass->op_size(vecd->der.op, vecd->der.input, newdim);
 		g_assert(ndims == 2);
@@ -682,8 +785,16 @@ static double *derived_matrix_load_values(YMatrix * vec)
 
 	//g_message("load values, len is %u",len);
 
-	if (vecs->currsize.rows != size.rows
-	    || vecs->currsize.columns != size.columns) {
+	gboolean same_size = vecs->currsize.rows == size.rows
+	    && vecs->currsize.columns == size.columns;
+	if (vecs->der.running && !vecs->der.has_result && same_size
+	    && vecs->cache_filled) {
+		/* a worker thread owns the task data. The old values are
+		 * shown until it is done, as they still have the right size */
+		return vecs->cache;
+	}
+
+	if (!same_size) {
 		if (vecs->cache)
 			g_free(vecs->cache);
 		v = g_new0(double, size.rows * size.columns);
@@ -692,9 +803,24 @@ static double *derived_matrix_load_values(YMatrix * vec)
 	} else {
 		v = vecs->cache;
 	}
+	vecs->cache_filled = FALSE;
 	if (v == NULL)
 		return NULL;
 
+	if (vecs->der.running && !vecs->der.has_result) {
+		/* no old values to show; they are missing until it is done */
+		fill_nan(v, size.rows * size.columns);
+		return v;
+	}
+
+	if (vecs->der.has_result) {
+		vecs->der.has_result = FALSE;
+		memcpy(v, vecs->der.result,
+		       size.rows * size.columns * sizeof(double));
+		vecs->cache_filled = TRUE;
+		return v;
+	}
+
 	/* call op */
 	YOperationClass *klass = Y_OPERATION_GET_CLASS(vecs->der.op);
 	if (vecs->der.task_data == NULL) {
@@ -705,9 +831,12 @@ static double *derived_matrix_load_values(YMatrix * vec)
 					     vecs->der.input);
 	}
 	double *dout = klass->op_func(vecs->der.task_data);
-	if (dout == NULL)
-		return NULL;
+	if (dout == NULL) {
+		fill_nan(v, size.rows * size.columns);
+		return v;
+	}
 	memcpy(v, dout, size.rows * size.columns * sizeof(double));
+	vecs->cache_filled = TRUE;
 
 	return v;
 }
@@ -716,18 +845,16 @@ static double derived_matrix_get_value(YMatrix * vec, unsigned i, unsigned j)
 {
 	YMatrixSize size = y_matrix_get_size(vec);
 	const double *d = y_matrix_get_values(vec);	/* fills the cache */
+	if (d == NULL)
+		return NAN;
 	return d[i * size.columns + j];
 }
 
 static void
 op_cb2(GObject * source_object, GAsyncResult * res, gpointer user_data)
 {
-	/* set outputs */
-	GTask *task = G_TASK(res);
-	g_task_propagate_pointer(task, NULL);
 	YDerivedMatrix *d = (YDerivedMatrix *) user_data;
-	d->der.running = FALSE;
-	y_data_emit_changed(Y_DATA(user_data));
+	derived_task_done(&d->der, Y_DATA(d), res, op_cb2);
 }
 
 static void on_input_changed_after2(YData * data, gpointer user_data)
@@ -739,20 +866,12 @@ static void on_input_changed_after2(YData * data, gpointer user_data)
 	if (!d->der.autorun) {
 		y_data_emit_changed(Y_DATA(d));
 	} else {
-		if (d->der.running)
-			return;
-		d->der.running = TRUE;
 		YOperationClass *klass = Y_OPERATION_GET_CLASS(d->der.op);
 		if (klass->thread_safe) {
-			/* get task data, run in a thread */
-			y_operation_update_task_data(d->der.op,
-						     d->der.task_data, data);
-			y_operation_run_task(d->der.op, d->der.task_data,
-					     op_cb2, d);
+			derived_on_input_changed(&d->der, Y_DATA(d), op_cb2);
 		} else {
 			/* load new values into the cache */
 			derived_matrix_load_values(Y_MATRIX(d));
-			d->der.running = FALSE;
 			y_data_emit_changed(Y_DATA(d));
 		}
 	}
@@ -431,9 +431,10 @@ YData *y_data_dup_to_simple(YData * src)
 		double v = y_scalar_get_value(Y_SCALAR(src));
 		d = Y_DATA(y_val_scalar_new(v));
 	} else if (Y_IS_VECTOR(src)) {
-		const double *v = y_vector_get_values(Y_VECTOR(src));
-		d = Y_DATA(y_val_vector_new_copy
-			(v, y_vector_get_len(Y_VECTOR(src))));
+		unsigned int n = y_vector_get_len(Y_VECTOR(src));
+		d = y_val_vector_new_alloc(n);
+		y_vector_get_values_range(Y_VECTOR(src), 0, n,
+					  y_val_vector_get_array(Y_VAL_VECTOR(d)));
 	} else if (Y_IS_MATRIX(src)) {
 		const double *v = y_matrix_get_values(Y_MATRIX(src));
 		YMatrixSize s = y_matrix_get_size(Y_MATRIX(src));
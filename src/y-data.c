@@ -44,11 +44,14 @@ typedef enum {
 	Y_DATA_IS_EDITABLE = 1 << 1,
 	Y_DATA_SIZE_CACHED = 1 << 2,
 	Y_DATA_HAS_VALUE = 1 << 3,
-	Y_DATA_MINMAX_CACHED = 1 << 4
+	Y_DATA_MINMAX_CACHED = 1 << 4,
+	Y_DATA_MINMAX_INDEX_CACHED = 1 << 5,
+	Y_DATA_MONOTONIC_CACHED = 1 << 6
 } YDataFlags;
 
 typedef struct {
 	guint32 flags;
+	guint64 generation;
 } YDataPrivate;
 
 enum {
@@ -153,9 +156,30 @@ void y_data_emit_changed(YData * dat)
 
 	g_return_if_fail(klass != NULL);
 
+	YDataPrivate *priv = y_data_get_instance_private(dat);
+	priv->generation++;
+
 	g_signal_emit(G_OBJECT(dat), y_data_signals[CHANGED], 0);
 }
 
+/**
+ * y_data_get_generation :
+ * @dat: #YData
+ *
+ * Get a counter that is incremented every time @dat emits "changed". Code
+ * that keeps something derived from the values of @dat can store the
+ * generation and compare it later, instead of copying and comparing the
+ * values, to find out whether they might have changed.
+ *
+ * Returns: the generation
+ **/
+guint64 y_data_get_generation(YData * dat)
+{
+	g_return_val_if_fail(Y_IS_DATA(dat), 0);
+	YDataPrivate *priv = y_data_get_instance_private(dat);
+	return priv->generation;
+}
+
 /**
  * y_data_has_value :
  * @data: #YData
@@ -425,10 +449,27 @@ void y_val_scalar_set_val(YValScalar *s, double val)
  * Abstract base class for data classes representing one dimensional arrays.
  */
 
+/* number of elements in each block of the range minimum/maximum index */
+#define Y_VECTOR_INDEX_BLOCK 64
+
 typedef struct {
 	unsigned int len;
 	double *values;		/* NULL = uninitialized/unsupported, nan = missing */
+	unsigned int values_len;	/* length allocated by replace_cache */
 	double minimum, maximum;
+	/* segment tree of block minima and maxima; leaves start at index_size */
+	double *index_min, *index_max;
+	unsigned int index_len;	/* length of the vector when indexed */
+	unsigned int index_size;
+	/* elements changed since the index was built */
+	gboolean index_dirty;
+	unsigned int dirty_start, dirty_end;
+	/* set while emitting a ranged change */
+	gboolean range_change;
+	unsigned int change_start, change_end;
+	/* 1 if increasing, -1 if decreasing, 0 otherwise, ignoring NaNs */
+	int monotonic;
+	gboolean has_nan;
 } YVectorPrivate;
 
 /**
@@ -444,7 +485,24 @@ static void _data_array_emit_changed(YData * data)
 	YDataPrivate *priv = y_data_get_instance_private(data);
 	priv->flags &=
 	    ~(Y_DATA_CACHE_IS_VALID | Y_DATA_SIZE_CACHED | Y_DATA_HAS_VALUE |
-	      Y_DATA_MINMAX_CACHED);
+	      Y_DATA_MINMAX_CACHED | Y_DATA_MONOTONIC_CACHED);
+	if (!Y_IS_VECTOR(data))
+		return;
+	YVectorPrivate *vpriv = y_vector_get_instance_private(Y_VECTOR(data));
+	if (vpriv->range_change && (priv->flags & Y_DATA_MINMAX_INDEX_CACHED)) {
+		/* only the blocks holding the changed elements are stale */
+		if (vpriv->index_dirty) {
+			vpriv->dirty_start =
+			    MIN(vpriv->dirty_start, vpriv->change_start);
+			vpriv->dirty_end = MAX(vpriv->dirty_end, vpriv->change_end);
+		} else {
+			vpriv->dirty_start = vpriv->change_start;
+			vpriv->dirty_end = vpriv->change_end;
+			vpriv->index_dirty = TRUE;
+		}
+	} else {
+		priv->flags &= ~Y_DATA_MINMAX_INDEX_CACHED;
+	}
 }
 
 static void _vector_finalize(GObject *dat)
@@ -458,6 +516,8 @@ static void _vector_finalize(GObject *dat)
 		  g_free(vpriv->values);
 	  }
 	}
+	g_free(vpriv->index_min);
+	g_free(vpriv->index_max);
 }
 
 static char _data_vector_get_sizes(YData * data, unsigned int *sizes)
@@ -481,15 +541,15 @@ static gboolean _vector_has_value(YData *dat)
 static char *_vector_serialize(YData * dat, gpointer user)
 {
 	YVector *vec = (YVector *) dat;
-	YVectorPrivate *vpriv = y_vector_get_instance_private(vec);
 	GString *str;
 	char sep;
 
 	sep = '\t';
 	str = g_string_new(NULL);
 
-	for (unsigned int i = 0; i < vpriv->len; i++) {
-		char *s = render_val(vpriv->values[i]);
+	unsigned int len = y_vector_get_len(vec);
+	for (unsigned int i = 0; i < len; i++) {
+		char *s = render_val(y_vector_get_value(vec, i));
 		if (i)
 			g_string_append_c(str, sep);
 		g_string_append(str, s);
@@ -558,7 +618,12 @@ const double *y_vector_get_values(YVector * vec)
 
 		g_return_val_if_fail(klass != NULL, NULL);
 
-		vpriv->values = (*klass->load_values) (vec);
+		double *v = (*klass->load_values) (vec);
+		/* no values, e.g. an empty vector, so leave the cache
+		 * invalid and try again next time */
+		if (v == NULL)
+			return NULL;
+		vpriv->values = v;
 
 		priv->flags |= Y_DATA_CACHE_IS_VALID;
 	}
@@ -591,6 +656,42 @@ double y_vector_get_value(YVector * vec, unsigned i)
 	return vpriv->values[i];
 }
 
+/**
+ * y_vector_get_values_range :
+ * @vec: #YVector
+ * @start: index of the first value
+ * @n: number of values
+ * @out: (array length=n): array to copy the values into
+ *
+ * Copy @n values of @vec, starting at @start, into @out. Vectors whose values
+ * follow a formula, like #YLinearRangeVector, compute them without filling
+ * the cache of @vec, which y_vector_get_values() would. Values that are not
+ * available are set to NaN.
+ **/
+void y_vector_get_values_range(YVector * vec, unsigned int start,
+			       unsigned int n, double *out)
+{
+	g_return_if_fail(Y_IS_VECTOR(vec));
+	YDataPrivate *priv = y_data_get_instance_private(Y_DATA(vec));
+	if (n == 0)
+		return;
+	unsigned int len = y_vector_get_len(vec);
+	g_return_if_fail(start <= len && n <= len - start);
+	YVectorClass const *klass = Y_VECTOR_GET_CLASS(vec);
+	if (!(priv->flags & Y_DATA_CACHE_IS_VALID) && klass->load_range) {
+		(*klass->load_range) (vec, start, n, out);
+		return;
+	}
+	const double *v = y_vector_get_values(vec);
+	if (v == NULL) {
+		unsigned int i;
+		for (i = 0; i < n; i++)
+			out[i] = NAN;
+		return;
+	}
+	memcpy(out, v + start, n * sizeof(double));
+}
+
 /**
  * y_vector_get_str :
  * @vec: #YVector
@@ -649,9 +750,28 @@ static int range_decreasing(double const *xs, int n)
 	return 1;
 }
 
-static int range_vary_uniformly(double const *xs, int n)
+/* whether the values increase or decrease, cached until they change */
+static int vector_get_monotonic(YVector * vec, const double *v,
+				unsigned int n)
 {
-	return range_increasing(xs, n) || range_decreasing(xs, n);
+	YDataPrivate *priv = y_data_get_instance_private(Y_DATA(vec));
+	YVectorPrivate *vpriv = y_vector_get_instance_private(vec);
+	if (!(priv->flags & Y_DATA_MONOTONIC_CACHED)) {
+		unsigned int i;
+		if (range_increasing(v, n)) {
+			vpriv->monotonic = 1;
+		} else if (range_decreasing(v, n)) {
+			vpriv->monotonic = -1;
+		} else {
+			vpriv->monotonic = 0;
+		}
+		vpriv->has_nan = FALSE;
+		for (i = 0; i < n && !vpriv->has_nan; i++) {
+			vpriv->has_nan = isnan(v[i]);
+		}
+		priv->flags |= Y_DATA_MONOTONIC_CACHED;
+	}
+	return vpriv->monotonic;
 }
 
 /**
@@ -669,6 +789,16 @@ gboolean y_vector_is_varying_uniformly(YVector * data)
 
 	g_return_val_if_fail(Y_IS_VECTOR(data), FALSE);
 
+	YVectorClass const *klass = Y_VECTOR_GET_CLASS(data);
+	if (klass->locate) {
+		/* monotonic by construction; strictly unless the step is zero */
+		n_values = y_vector_get_len(data);
+		if (n_values < 2)
+			return n_values == 1;
+		return y_vector_get_value(data, 0) !=
+		    y_vector_get_value(data, n_values - 1);
+	}
+
 	values = y_vector_get_values(data);
 	if (values == NULL)
 		return FALSE;
@@ -677,7 +807,140 @@ gboolean y_vector_is_varying_uniformly(YVector * data)
 	if (n_values < 1)
 		return FALSE;
 
-	return range_vary_uniformly(values, n_values);
+	return vector_get_monotonic(data, values, n_values) != 0;
+}
+
+static inline double vector_at(YVector * vec, const double *v, unsigned int i)
+{
+	return v ? v[i] : y_vector_get_value(vec, i);
+}
+
+/* number of elements with dir*v[i] < y, or <= y if not strict, for sorted
+ * values, searching outward from guess */
+static unsigned int vector_bound(YVector * vec, const double *v,
+				 unsigned int n, int dir, double y,
+				 gboolean strict, unsigned int guess)
+{
+#define BEFORE(i) (strict ? dir * vector_at(vec, v, i) < y : dir * vector_at(vec, v, i) <= y)
+	unsigned int g = MIN(guess, n - 1);
+	unsigned int lo, hi, s = 1;
+	if (BEFORE(g)) {
+		lo = g + 1;
+		while (g + s < n && BEFORE(g + s)) {
+			lo = g + s + 1;
+			s *= 2;
+		}
+		hi = MIN(g + s, n);
+	} else {
+		hi = g;
+		while (s <= g && !BEFORE(g - s)) {
+			hi = g - s;
+			s *= 2;
+		}
+		lo = s <= g ? g - s + 1 : 0;
+	}
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		if (BEFORE(mid))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+#undef BEFORE
+}
+
+/* pick the element according to mode, given the index of the last element
+ * with value <= x (or -1) and the first with value >= x (or n) */
+static int vector_pick(YVector * vec, const double *v, double x, int mode,
+		       int below, int above, unsigned int n)
+{
+	gboolean has_below = below >= 0;
+	gboolean has_above = above >= 0 && (unsigned int)above < n;
+	if (mode == FIND_INDEX_FLOOR)
+		return has_below ? below : -1;
+	if (mode == FIND_INDEX_CEIL)
+		return has_above ? above : -1;
+	if (!has_below)
+		return has_above ? above : -1;
+	if (!has_above)
+		return below;
+	return fabs(vector_at(vec, v, below) - x) <=
+	    fabs(vector_at(vec, v, above) - x) ? below : above;
+}
+
+/**
+ * y_vector_find_index :
+ * @vec: #YVector
+ * @x: value to look for
+ * @mode: %FIND_INDEX_NEAREST, %FIND_INDEX_FLOOR or %FIND_INDEX_CEIL
+ *
+ * Find the element of @vec with the value nearest to @x, the largest value
+ * that is not greater than @x, or the smallest value that is not less than
+ * @x, depending on @mode.
+ *
+ * If the values of @vec increase or decrease, which is checked once and
+ * cached until @vec changes, this is a binary search. Vectors whose values
+ * follow a formula, like #YLinearRangeVector, find the element directly.
+ * Otherwise all of the values are scanned. NaN values are ignored.
+ *
+ * Returns: the index, or -1 if there is no such element
+ **/
+int y_vector_find_index(YVector * vec, double x, int mode)
+{
+	g_return_val_if_fail(Y_IS_VECTOR(vec), -1);
+	if (isnan(x))
+		return -1;
+	YVectorClass const *klass = Y_VECTOR_GET_CLASS(vec);
+	YDataPrivate *priv = y_data_get_instance_private(Y_DATA(vec));
+	YVectorPrivate *vpriv = y_vector_get_instance_private(vec);
+	unsigned int n = y_vector_get_len(vec);
+	if (n == 0)
+		return -1;
+	const double *v = NULL;
+	unsigned int guess = n / 2;
+	int dir;
+
+	if (klass->locate) {
+		/* the values follow a formula, so start at the right place */
+		if (priv->flags & Y_DATA_CACHE_IS_VALID)
+			v = vpriv->values;
+		double t = klass->locate(vec, x);
+		if (!(t > 0.0))
+			guess = 0;
+		else if (t >= n - 1)
+			guess = n - 1;
+		else
+			guess = lround(t);
+		dir = vector_at(vec, v, n - 1) < vector_at(vec, v, 0) ? -1 : 1;
+	} else {
+		v = y_vector_get_values(vec);
+		if (v == NULL)
+			return -1;
+		dir = vector_get_monotonic(vec, v, n);
+		if (dir == 0 || vpriv->has_nan) {
+			/* no order to exploit */
+			int below = -1, above = -1;
+			unsigned int i;
+			for (i = 0; i < n; i++) {
+				if (isnan(v[i]))
+					continue;
+				if (v[i] <= x && (below < 0 || v[i] > v[below]))
+					below = i;
+				if (v[i] >= x && (above < 0 || v[i] < v[above]))
+					above = i;
+			}
+			return vector_pick(vec, v, x, mode, below, above, n);
+		}
+	}
+
+	/* p elements are at or before x in sorted order, q strictly before */
+	unsigned int p = vector_bound(vec, v, n, dir, dir * x, FALSE, guess);
+	unsigned int q = vector_bound(vec, v, n, dir, dir * x, TRUE, guess);
+	if (dir > 0)
+		return vector_pick(vec, v, x, mode, (int)p - 1, q, n);
+	return vector_pick(vec, v, x, mode, q < n ? (int)q : -1,
+			   (int)p - 1, n);
 }
 
 /**
@@ -694,10 +957,26 @@ void y_vector_get_minmax(YVector * vec, double *min, double *max)
 	YDataPrivate *priv = y_data_get_instance_private(data);
 	YVectorPrivate *vpriv = y_vector_get_instance_private(vec);
 
+	YVectorClass const *klass = Y_VECTOR_GET_CLASS(vec);
+	if (!(priv->flags & Y_DATA_MINMAX_CACHED) && klass->minmax_range) {
+		unsigned int len = y_vector_get_len(vec);
+		vpriv->minimum = DBL_MAX;
+		vpriv->maximum = -DBL_MAX;
+		if (len > 0)
+			(*klass->minmax_range) (vec, 0, len, &vpriv->minimum,
+						&vpriv->maximum);
+		priv->flags |= Y_DATA_MINMAX_CACHED;
+	}
+
 	if (!(priv->flags & Y_DATA_MINMAX_CACHED)) {
 		const double *v = y_vector_get_values(vec);
-		if (v == NULL)
+		if (v == NULL) {
+			if (min != NULL)
+				*min = DBL_MAX;
+			if (max != NULL)
+				*max = -DBL_MAX;
 			return;
+		}
 
 		double minimum = DBL_MAX, maximum = -DBL_MAX;
 
@@ -722,6 +1001,197 @@ void y_vector_get_minmax(YVector * vec, double *min, double *max)
 		*max = vpriv->maximum;
 }
 
+static void vector_scan_minmax(const double *v, unsigned int start,
+			       unsigned int end, double *minimum,
+			       double *maximum)
+{
+	unsigned int i;
+	for (i = start; i < end; i++) {
+		if (!isfinite(v[i]))
+			continue;
+		if (*minimum > v[i])
+			*minimum = v[i];
+		if (*maximum < v[i])
+			*maximum = v[i];
+	}
+}
+
+static void vector_index_update_block(YVectorPrivate * vpriv,
+				      const double *v, unsigned int b)
+{
+	unsigned int i = vpriv->index_size + b;
+	double minimum = DBL_MAX, maximum = -DBL_MAX;
+	vector_scan_minmax(v, b * Y_VECTOR_INDEX_BLOCK,
+			   MIN((b + 1) * Y_VECTOR_INDEX_BLOCK, vpriv->index_len),
+			   &minimum, &maximum);
+	vpriv->index_min[i] = minimum;
+	vpriv->index_max[i] = maximum;
+	for (i /= 2; i > 0; i /= 2) {
+		vpriv->index_min[i] =
+		    MIN(vpriv->index_min[2 * i], vpriv->index_min[2 * i + 1]);
+		vpriv->index_max[i] =
+		    MAX(vpriv->index_max[2 * i], vpriv->index_max[2 * i + 1]);
+	}
+}
+
+static void vector_index_build(YVectorPrivate * vpriv, const double *v,
+			       unsigned int len)
+{
+	unsigned int nb = (len + Y_VECTOR_INDEX_BLOCK - 1) / Y_VECTOR_INDEX_BLOCK;
+	unsigned int size = 1;
+	unsigned int i;
+	while (size < nb)
+		size <<= 1;
+	if (size != vpriv->index_size) {
+		vpriv->index_min = g_renew(double, vpriv->index_min, 2 * size);
+		vpriv->index_max = g_renew(double, vpriv->index_max, 2 * size);
+		vpriv->index_size = size;
+	}
+	vpriv->index_len = len;
+	for (i = 0; i < size; i++) {
+		double minimum = DBL_MAX, maximum = -DBL_MAX;
+		if (i < nb) {
+			vector_scan_minmax(v, i * Y_VECTOR_INDEX_BLOCK,
+					   MIN((i + 1) * Y_VECTOR_INDEX_BLOCK,
+					       len), &minimum, &maximum);
+		}
+		vpriv->index_min[size + i] = minimum;
+		vpriv->index_max[size + i] = maximum;
+	}
+	for (i = size - 1; i > 0; i--) {
+		vpriv->index_min[i] =
+		    MIN(vpriv->index_min[2 * i], vpriv->index_min[2 * i + 1]);
+		vpriv->index_max[i] =
+		    MAX(vpriv->index_max[2 * i], vpriv->index_max[2 * i + 1]);
+	}
+	vpriv->index_dirty = FALSE;
+}
+
+/**
+ * y_vector_get_minmax_range :
+ * @vec: #YVector
+ * @start: index of the first element
+ * @end: index after the last element
+ * @min: (out)(nullable): return location for minimum value, or @NULL
+ * @max: (out)(nullable): return location for maximum value, or @NULL
+ *
+ * Get the minimum and maximum finite values of the elements of @vec from
+ * @start up to but not including @end. If there are none, the minimum is
+ * DBL_MAX and the maximum -DBL_MAX, as for y_vector_get_minmax().
+ *
+ * Long ranges are answered from an index of the minima and maxima of blocks
+ * of elements, which is built the first time it is needed and kept until
+ * @vec changes, so each query takes time logarithmic in the length of @vec.
+ * After y_vector_emit_changed_range(), only the blocks holding the changed
+ * elements are updated. Vectors whose values follow a formula, like
+ * #YLinearRangeVector, compute the result directly.
+ **/
+void y_vector_get_minmax_range(YVector * vec, unsigned int start,
+			       unsigned int end, double *min, double *max)
+{
+	g_return_if_fail(Y_IS_VECTOR(vec));
+	YData *data = Y_DATA(vec);
+	YDataPrivate *priv = y_data_get_instance_private(data);
+	YVectorPrivate *vpriv = y_vector_get_instance_private(vec);
+	YVectorClass const *klass = Y_VECTOR_GET_CLASS(vec);
+	unsigned int len = y_vector_get_len(vec);
+	double minimum = DBL_MAX, maximum = -DBL_MAX;
+	end = MIN(end, len);
+
+	if (klass->minmax_range) {
+		if (start < end)
+			(*klass->minmax_range) (vec, start, end, &minimum,
+						&maximum);
+		if (min != NULL)
+			*min = minimum;
+		if (max != NULL)
+			*max = maximum;
+		return;
+	}
+
+	const double *v = y_vector_get_values(vec);
+	if (v == NULL) {
+		if (min != NULL)
+			*min = minimum;
+		if (max != NULL)
+			*max = maximum;
+		return;
+	}
+
+	if (start + 2 * Y_VECTOR_INDEX_BLOCK > end) {
+		vector_scan_minmax(v, start, end, &minimum, &maximum);
+	} else {
+		if (!(priv->flags & Y_DATA_MINMAX_INDEX_CACHED)
+		    || vpriv->index_len != len) {
+			vector_index_build(vpriv, v, len);
+			priv->flags |= Y_DATA_MINMAX_INDEX_CACHED;
+		} else if (vpriv->index_dirty) {
+			unsigned int b0 = vpriv->dirty_start / Y_VECTOR_INDEX_BLOCK;
+			unsigned int b1 = (MIN(vpriv->dirty_end, len) +
+					   Y_VECTOR_INDEX_BLOCK - 1) /
+			    Y_VECTOR_INDEX_BLOCK;
+			unsigned int b;
+			for (b = b0; b < b1; b++) {
+				vector_index_update_block(vpriv, v, b);
+			}
+			vpriv->index_dirty = FALSE;
+		}
+		/* partial blocks at the ends */
+		unsigned int lo = (start + Y_VECTOR_INDEX_BLOCK - 1) /
+		    Y_VECTOR_INDEX_BLOCK;
+		unsigned int hi = end / Y_VECTOR_INDEX_BLOCK;
+		vector_scan_minmax(v, start, lo * Y_VECTOR_INDEX_BLOCK,
+				   &minimum, &maximum);
+		vector_scan_minmax(v, hi * Y_VECTOR_INDEX_BLOCK, end,
+				   &minimum, &maximum);
+		/* whole blocks */
+		lo += vpriv->index_size;
+		hi += vpriv->index_size;
+		while (lo < hi) {
+			if (lo & 1) {
+				minimum = MIN(minimum, vpriv->index_min[lo]);
+				maximum = MAX(maximum, vpriv->index_max[lo]);
+				lo++;
+			}
+			if (hi & 1) {
+				hi--;
+				minimum = MIN(minimum, vpriv->index_min[hi]);
+				maximum = MAX(maximum, vpriv->index_max[hi]);
+			}
+			lo /= 2;
+			hi /= 2;
+		}
+	}
+
+	if (min != NULL)
+		*min = minimum;
+	if (max != NULL)
+		*max = maximum;
+}
+
+/**
+ * y_vector_emit_changed_range :
+ * @vec: #YVector
+ * @start: index of the first changed element
+ * @end: index after the last changed element
+ *
+ * Emit the "changed" signal for @vec, telling it that only the elements
+ * from @start up to but not including @end have changed, and its length has
+ * not. Cached summaries that can be updated piece by piece, like the index
+ * used by y_vector_get_minmax_range(), then only update that part.
+ **/
+void y_vector_emit_changed_range(YVector * vec, unsigned int start,
+				 unsigned int end)
+{
+	g_return_if_fail(Y_IS_VECTOR(vec));
+	YVectorPrivate *vpriv = y_vector_get_instance_private(vec);
+	vpriv->range_change = TRUE;
+	vpriv->change_start = start;
+	vpriv->change_end = end;
+	y_data_emit_changed(Y_DATA(vec));
+	vpriv->range_change = FALSE;
+}
+
 double * y_vector_replace_cache(YVector *vec, unsigned len)
 {
 	YData *data = Y_DATA(vec);
@@ -731,26 +1201,33 @@ double * y_vector_replace_cache(YVector *vec, unsigned len)
 	YVectorClass const *klass = Y_VECTOR_GET_CLASS(vec);
 	g_return_val_if_fail(klass != NULL, NULL);
 
-	if(vpriv->values!=NULL && len == y_vector_get_len(vec)) {
-		return vpriv->values;
-	}
-
 	/* if subclass has a replace_cache function, it is handling this */
 	if(klass->replace_cache) {
+		if(vpriv->values!=NULL && len == y_vector_get_len(vec)) {
+			return vpriv->values;
+		}
 		priv->flags &=
 		    ~(Y_DATA_CACHE_IS_VALID | Y_DATA_SIZE_CACHED | Y_DATA_HAS_VALUE |
-		      Y_DATA_MINMAX_CACHED);
+		      Y_DATA_MINMAX_CACHED | Y_DATA_MINMAX_INDEX_CACHED |
+		      Y_DATA_MONOTONIC_CACHED);
 		return (*klass->replace_cache) (vec, len);
 	}
 
+	/* the length may have changed since the buffer was made */
+	if(vpriv->values!=NULL && len == vpriv->values_len) {
+		return vpriv->values;
+	}
+
 	if(vpriv->values !=NULL) {
 		g_free(vpriv->values);
 	}
 	vpriv->values = g_new0(double,len);
+	vpriv->values_len = len;
 
 	priv->flags &=
 	    ~(Y_DATA_CACHE_IS_VALID | Y_DATA_SIZE_CACHED | Y_DATA_HAS_VALUE |
-	      Y_DATA_MINMAX_CACHED);
+	      Y_DATA_MINMAX_CACHED | Y_DATA_MINMAX_INDEX_CACHED |
+		      Y_DATA_MONOTONIC_CACHED);
 
 	return vpriv->values;
 }
@@ -767,6 +1244,7 @@ double * y_vector_replace_cache(YVector *vec, unsigned len)
 typedef struct {
 	YMatrixSize size;	/* negative if dirty, includes missing values */
 	double *values;		/* NULL = uninitialized/unsupported, nan = missing */
+	unsigned int values_len;	/* length allocated by replace_cache */
 	double minimum, maximum;
 } YMatrixPrivate;
 
@@ -956,7 +1434,10 @@ const double *y_matrix_get_values(YMatrix * mat)
 
 		g_return_val_if_fail(klass != NULL, NULL);
 
-		mpriv->values = (*klass->load_values) (mat);
+		double *v = (*klass->load_values) (mat);
+		if (v == NULL)
+			return NULL;
+		mpriv->values = v;
 
 		priv->flags |= Y_DATA_CACHE_IS_VALID;
 	}
@@ -991,6 +1472,43 @@ double y_matrix_get_value(YMatrix * mat, unsigned i, unsigned j)
 	return mpriv->values[i * mpriv->size.columns + j];
 }
 
+/**
+ * y_matrix_get_values_range :
+ * @mat: #YMatrix
+ * @start: index of the first value, counting along rows
+ * @n: number of values
+ * @out: (array length=n): array to copy the values into
+ *
+ * Copy @n values of @mat, starting at element @start of the values stored
+ * row by row, into @out. Matrices whose values follow a formula, like
+ * #YLinearRangeMatrix, compute them without filling the cache of @mat, which
+ * y_matrix_get_values() would. Values that are not available are set to NaN.
+ **/
+void y_matrix_get_values_range(YMatrix * mat, unsigned int start,
+			       unsigned int n, double *out)
+{
+	g_return_if_fail(Y_IS_MATRIX(mat));
+	YDataPrivate *priv = y_data_get_instance_private(Y_DATA(mat));
+	if (n == 0)
+		return;
+	YMatrixSize size = y_matrix_get_size(mat);
+	unsigned int len = size.rows * size.columns;
+	g_return_if_fail(start <= len && n <= len - start);
+	YMatrixClass const *klass = Y_MATRIX_GET_CLASS(mat);
+	if (!(priv->flags & Y_DATA_CACHE_IS_VALID) && klass->load_range) {
+		(*klass->load_range) (mat, start, n, out);
+		return;
+	}
+	const double *v = y_matrix_get_values(mat);
+	if (v == NULL) {
+		unsigned int i;
+		for (i = 0; i < n; i++)
+			out[i] = NAN;
+		return;
+	}
+	memcpy(out, v + start, n * sizeof(double));
+}
+
 /**
  * y_matrix_get_str :
  * @mat: #YMatrix
@@ -1022,6 +1540,11 @@ void y_matrix_get_minmax(YMatrix * mat, double *min, double *max)
 	YData *data = Y_DATA(mat);
 	YDataPrivate *priv = y_data_get_instance_private(data);
 	YMatrixPrivate *mpriv = y_matrix_get_instance_private(mat);
+	YMatrixClass const *klass = Y_MATRIX_GET_CLASS(mat);
+	if (!(priv->flags & Y_DATA_MINMAX_CACHED) && klass->load_minmax) {
+		(*klass->load_minmax) (mat, &mpriv->minimum, &mpriv->maximum);
+		priv->flags |= Y_DATA_MINMAX_CACHED;
+	}
 	if (!(priv->flags & Y_DATA_MINMAX_CACHED)) {
 		const double *v = y_matrix_get_values(mat);
 
@@ -1058,24 +1581,28 @@ double * y_matrix_replace_cache(YMatrix *mat, unsigned len)
 	YMatrixClass const *klass = Y_MATRIX_GET_CLASS(mat);
 	g_return_val_if_fail(klass != NULL, NULL);
 
-	YMatrixSize s = y_matrix_get_size(mat);
-
-	if(mpriv->values!=NULL && s.rows*s.columns == len) {
-		return mpriv->values;
-	}
-
 	/* if subclass has a replace_cache function, it is handling this */
 	if(klass->replace_cache) {
+		YMatrixSize s = y_matrix_get_size(mat);
+		if(mpriv->values!=NULL && s.rows*s.columns == len) {
+			return mpriv->values;
+		}
 		priv->flags &=
 		    ~(Y_DATA_CACHE_IS_VALID | Y_DATA_SIZE_CACHED | Y_DATA_HAS_VALUE |
 		      Y_DATA_MINMAX_CACHED);
 		return (*klass->replace_cache) (mat, len);
 	}
 
+	/* the size may have changed since the buffer was made */
+	if(mpriv->values!=NULL && len == mpriv->values_len) {
+		return mpriv->values;
+	}
+
 	if(mpriv->values !=NULL) {
 		g_free(mpriv->values);
 	}
 	mpriv->values = g_new0(double,len);
+	mpriv->values_len = len;
 
 	priv->flags &=
 	    ~(Y_DATA_CACHE_IS_VALID | Y_DATA_SIZE_CACHED | Y_DATA_HAS_VALUE |
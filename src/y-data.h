@@ -34,6 +34,20 @@
 #include <y-linear-range.h>
 #include <y-scalar-property.h>
 #include <y-vector-ring.h>
+#include <y-history.h>
+#include <y-tiered-ring.h>
+#include <y-spill.h>
+#include <y-fft-util.h>
 #include <y-fft-operation.h>
+#include <y-spectrogram-operation.h>
+#include <y-psd-operation.h>
+#include <y-sliding-dft-operation.h>
+#include <y-lock-in-operation.h>
+#include <y-filter-operation.h>
+#include <y-correlate-operation.h>
+#include <y-rolling-stats-operation.h>
+#include <y-decimate-operation.h>
+#include <y-interpolate-operation.h>
+#include <y-align-operation.h>
 
 #endif
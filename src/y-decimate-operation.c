@@ -0,0 +1,521 @@
+/*
+ * y-decimate-operation.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <memory.h>
+#include <math.h>
+#include "y-decimate-operation.h"
+
+/**
+ * SECTION: y-decimate-operation
+ * @short_description: Operation that reduces a long vector to a few points
+ * for plotting.
+ *
+ * This operation reduces the part of a vector between the indices "start"
+ * and "end" to about "width" points, which is all a plot that is "width"
+ * pixels wide can show. The output is a matrix with two columns, holding the
+ * index of each point, which can be used to look up its x value, and its
+ * value. If the range holds few enough points, they are all output.
+ *
+ * %DECIMATE_ENVELOPE divides the range into "width" buckets and outputs the
+ * minimum and maximum of each, in the order they occur, so a line drawn
+ * through the points covers the same pixels as one drawn through all of the
+ * data. %DECIMATE_LTTB outputs "width" points chosen by the
+ * Largest-Triangle-Three-Buckets algorithm, which keeps the visual shape of
+ * the data with one point per bucket. For buckets longer than a few dozen
+ * samples, the candidates in each bucket are its minimum and maximum.
+ *
+ * The minimum and maximum of each bucket are found with a pyramid of block
+ * minima and maxima, and bucket means with prefix sums. Both are built once
+ * when the input changes and kept in the task data, so changing the range or
+ * width, for example to pan or zoom a plot, costs time proportional to the
+ * width times the logarithm of the length of the vector, rather than to the
+ * length of the range.
+ */
+
+enum {
+	DECIMATE_PROP_0,
+	DECIMATE_PROP_METHOD,
+	DECIMATE_PROP_WIDTH,
+	DECIMATE_PROP_START,
+	DECIMATE_PROP_END,
+	N_PROPERTIES
+};
+
+/* number of samples in the blocks at the bottom of the pyramid */
+#define DECIMATE_BLOCK 32
+#define DECIMATE_MAX_LEVELS 32
+
+struct _YDecimateOperation {
+	YOperation base;
+	int method;
+	unsigned int width;
+	int start;
+	int end;
+};
+
+G_DEFINE_TYPE(YDecimateOperation, y_decimate_operation, Y_TYPE_OPERATION);
+
+static void
+y_decimate_operation_set_property(GObject * gobject, guint param_id,
+				  GValue const *value, GParamSpec * pspec)
+{
+	YDecimateOperation *sop = Y_DECIMATE_OPERATION(gobject);
+
+	switch (param_id) {
+	case DECIMATE_PROP_METHOD:
+		sop->method = g_value_get_int(value);
+		break;
+	case DECIMATE_PROP_WIDTH:
+		sop->width = g_value_get_int(value);
+		break;
+	case DECIMATE_PROP_START:
+		sop->start = g_value_get_int(value);
+		break;
+	case DECIMATE_PROP_END:
+		sop->end = g_value_get_int(value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void
+y_decimate_operation_get_property(GObject * gobject, guint param_id,
+				  GValue * value, GParamSpec * pspec)
+{
+	YDecimateOperation *sop = Y_DECIMATE_OPERATION(gobject);
+
+	switch (param_id) {
+	case DECIMATE_PROP_METHOD:
+		g_value_set_int(value, sop->method);
+		break;
+	case DECIMATE_PROP_WIDTH:
+		g_value_set_int(value, sop->width);
+		break;
+	case DECIMATE_PROP_START:
+		g_value_set_int(value, sop->start);
+		break;
+	case DECIMATE_PROP_END:
+		g_value_set_int(value, sop->end);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+/* the range [a,b) of a vector of length n, and the number of output points */
+static unsigned int decimate_range(const YDecimateOperation * sop,
+				   unsigned int n, unsigned int *a,
+				   unsigned int *b)
+{
+	unsigned int end = (sop->end < 0 || (unsigned int)sop->end > n) ?
+	    n : (unsigned int)sop->end;
+	unsigned int start = MIN((unsigned int)sop->start, end);
+	unsigned int count = end - start;
+	*a = start;
+	*b = end;
+	if (sop->method == DECIMATE_LTTB) {
+		return MIN(count, sop->width);
+	}
+	return MIN(count, 2 * sop->width);
+}
+
+static
+int decimate_size(YOperation * op, YData * input, unsigned int *dims)
+{
+	unsigned int a, b;
+	g_assert(dims);
+	g_assert(Y_IS_VECTOR(input));
+	dims[0] = 2;
+	dims[1] = decimate_range(Y_DECIMATE_OPERATION(op),
+				 y_vector_get_len(Y_VECTOR(input)), &a, &b);
+	return 2;
+}
+
+typedef struct {
+	YDecimateOperation sop;
+	/* copy of the input, and the generation it was copied at */
+	YVector *src;
+	guint64 gen;
+	double *values;
+	unsigned int n;
+	/* indices of the minimum and maximum of each block, at each level */
+	gboolean pyramid_valid;
+	unsigned int n_levels;
+	unsigned int n_blocks[DECIMATE_MAX_LEVELS];
+	unsigned int *pmin[DECIMATE_MAX_LEVELS];
+	unsigned int *pmax[DECIMATE_MAX_LEVELS];
+	/* psum[i] is the sum of the first i values */
+	double *psum;
+	unsigned int rows;
+	double *output;
+	unsigned int output_size;
+} DecimateOpData;
+
+static void decimate_free_pyramid(DecimateOpData * d)
+{
+	unsigned int l;
+	for (l = 0; l < d->n_levels; l++) {
+		g_free(d->pmin[l]);
+		g_free(d->pmax[l]);
+	}
+	g_clear_pointer(&d->psum, g_free);
+	d->n_levels = 0;
+	d->pyramid_valid = FALSE;
+}
+
+static
+gpointer decimate_op_create_data(YOperation * op, gpointer data,
+				 YData * input)
+{
+	if (input == NULL)
+		return NULL;
+	DecimateOpData *d;
+	YDecimateOperation *sop = Y_DECIMATE_OPERATION(op);
+	if (data == NULL) {
+		d = g_new0(DecimateOpData, 1);
+	} else {
+		d = (DecimateOpData *) data;
+	}
+	d->sop = *sop;
+
+	/* copy the input only if it has changed */
+	YVector *vec = Y_VECTOR(input);
+	if (d->src != vec || d->gen != y_data_get_generation(input)) {
+		if (d->src != vec) {
+			g_clear_object(&d->src);
+			d->src = g_object_ref(vec);
+		}
+		d->gen = y_data_get_generation(input);
+		unsigned int n = y_vector_get_len(vec);
+		if (n != d->n) {
+			g_free(d->values);
+			d->values = g_new(double, MAX(n, 1));
+			d->n = n;
+		}
+		y_vector_get_values_range(vec, 0, n, d->values);
+		decimate_free_pyramid(d);
+	}
+
+	unsigned int a, b;
+	d->rows = decimate_range(sop, d->n, &a, &b);
+	if (2 * d->rows > d->output_size) {
+		d->output_size = 2 * d->rows;
+		d->output = g_renew(double, d->output, d->output_size);
+	}
+	return d;
+}
+
+static
+void decimate_op_data_free(gpointer data)
+{
+	DecimateOpData *d = (DecimateOpData *) data;
+	decimate_free_pyramid(d);
+	g_clear_object(&d->src);
+	g_free(d->values);
+	g_free(d->output);
+	g_free(d);
+}
+
+static void decimate_build_pyramid(DecimateOpData * d)
+{
+	const double *v = d->values;
+	unsigned int nb = (d->n + DECIMATE_BLOCK - 1) / DECIMATE_BLOCK;
+	unsigned int i, j, l;
+
+	d->n_levels = 0;
+	for (l = 0; l < DECIMATE_MAX_LEVELS && nb > 0; l++) {
+		unsigned int *mn = g_new(unsigned int, nb);
+		unsigned int *mx = g_new(unsigned int, nb);
+		for (i = 0; i < nb; i++) {
+			unsigned int lo, hi;
+			if (l == 0) {
+				/* scan the samples of the block */
+				lo = i * DECIMATE_BLOCK;
+				mn[i] = mx[i] = lo;
+				hi = MIN(lo + DECIMATE_BLOCK, d->n);
+				for (j = lo + 1; j < hi; j++) {
+					if (v[j] < v[mn[i]])
+						mn[i] = j;
+					if (v[j] > v[mx[i]])
+						mx[i] = j;
+				}
+			} else {
+				/* combine the two child blocks */
+				const unsigned int *cmn = d->pmin[l - 1];
+				const unsigned int *cmx = d->pmax[l - 1];
+				mn[i] = cmn[2 * i];
+				mx[i] = cmx[2 * i];
+				if (2 * i + 1 < d->n_blocks[l - 1]) {
+					if (v[cmn[2 * i + 1]] < v[mn[i]])
+						mn[i] = cmn[2 * i + 1];
+					if (v[cmx[2 * i + 1]] > v[mx[i]])
+						mx[i] = cmx[2 * i + 1];
+				}
+			}
+		}
+		d->pmin[l] = mn;
+		d->pmax[l] = mx;
+		d->n_blocks[l] = nb;
+		d->n_levels++;
+		nb = nb > 1 ? (nb + 1) / 2 : 0;
+	}
+
+	d->psum = g_new(double, d->n + 1);
+	d->psum[0] = 0.0;
+	for (i = 0; i < d->n; i++) {
+		d->psum[i + 1] = d->psum[i] + v[i];
+	}
+	d->pyramid_valid = TRUE;
+}
+
+static inline void decimate_take(const double *v, unsigned int i,
+				 unsigned int j, unsigned int *mn,
+				 unsigned int *mx)
+{
+	if (v[i] < v[*mn])
+		*mn = i;
+	if (v[j] > v[*mx])
+		*mx = j;
+}
+
+/* indices of the minimum and maximum in [a,b), which must not be empty */
+static void decimate_minmax(const DecimateOpData * d, unsigned int a,
+			    unsigned int b, unsigned int *mn, unsigned int *mx)
+{
+	const double *v = d->values;
+	*mn = *mx = a;
+	/* samples before the first and after the last whole block */
+	while (a < b && a % DECIMATE_BLOCK != 0) {
+		decimate_take(v, a, a, mn, mx);
+		a++;
+	}
+	while (b > a && b % DECIMATE_BLOCK != 0) {
+		b--;
+		decimate_take(v, b, b, mn, mx);
+	}
+	/* whole blocks, climbing the pyramid */
+	unsigned int lo = a / DECIMATE_BLOCK;
+	unsigned int hi = b / DECIMATE_BLOCK;
+	unsigned int l;
+	for (l = 0; lo < hi && l < d->n_levels; l++) {
+		if (lo & 1) {
+			decimate_take(v, d->pmin[l][lo], d->pmax[l][lo], mn, mx);
+			lo++;
+		}
+		if (hi & 1) {
+			hi--;
+			decimate_take(v, d->pmin[l][hi], d->pmax[l][hi], mn, mx);
+		}
+		lo /= 2;
+		hi /= 2;
+	}
+}
+
+static inline void decimate_put(double *out, unsigned int *k, unsigned int i,
+				double value)
+{
+	out[2 * *k] = i;
+	out[2 * *k + 1] = value;
+	(*k)++;
+}
+
+static void decimate_envelope(DecimateOpData * d, unsigned int a,
+			      unsigned int b)
+{
+	unsigned int w = d->sop.width;
+	guint64 count = b - a;
+	unsigned int p, k = 0;
+	for (p = 0; p < w; p++) {
+		unsigned int lo = a + count * p / w;
+		unsigned int hi = a + count * (p + 1) / w;
+		unsigned int mn, mx;
+		decimate_minmax(d, lo, hi, &mn, &mx);
+		unsigned int first = MIN(mn, mx);
+		unsigned int second = MAX(mn, mx);
+		decimate_put(d->output, &k, first, d->values[first]);
+		decimate_put(d->output, &k, second, d->values[second]);
+	}
+}
+
+static void decimate_lttb(DecimateOpData * d, unsigned int a, unsigned int b)
+{
+	const double *v = d->values;
+	unsigned int w = d->sop.width;
+	guint64 count = b - a - 2;	/* points between the ends */
+	unsigned int nb = w - 2;	/* buckets between the ends */
+	unsigned int p, k = 0;
+	unsigned int prev = a;
+	decimate_put(d->output, &k, a, v[a]);
+	for (p = 0; p < nb; p++) {
+		unsigned int lo = a + 1 + count * p / nb;
+		unsigned int hi = a + 1 + count * (p + 1) / nb;
+		/* mean of the next bucket, or the last point */
+		double cx, cy;
+		if (p + 1 < nb) {
+			unsigned int nlo = hi;
+			unsigned int nhi = a + 1 + count * (p + 2) / nb;
+			cx = 0.5 * ((double)nlo + (double)nhi - 1.0);
+			cy = (d->psum[nhi] - d->psum[nlo]) / (nhi - nlo);
+		} else {
+			cx = b - 1;
+			cy = v[b - 1];
+		}
+		double px = prev;
+		double py = v[prev];
+		unsigned int best = lo;
+		double best_area = -1.0;
+		unsigned int i;
+		if (hi - lo <= DECIMATE_BLOCK) {
+			for (i = lo; i < hi; i++) {
+				double area = fabs((px - cx) * (v[i] - py)
+						   - (px - i) * (cy - py));
+				if (area > best_area) {
+					best_area = area;
+					best = i;
+				}
+			}
+		} else {
+			unsigned int c[2];
+			decimate_minmax(d, lo, hi, &c[0], &c[1]);
+			for (i = 0; i < 2; i++) {
+				double area = fabs((px - cx) * (v[c[i]] - py)
+						   - (px - c[i]) * (cy - py));
+				if (area > best_area) {
+					best_area = area;
+					best = c[i];
+				}
+			}
+		}
+		decimate_put(d->output, &k, best, v[best]);
+		prev = best;
+	}
+	decimate_put(d->output, &k, b - 1, v[b - 1]);
+}
+
+static
+gpointer decimate_op(gpointer input)
+{
+	DecimateOpData *d = (DecimateOpData *) input;
+
+	if (d == NULL || d->rows == 0)
+		return NULL;
+
+	unsigned int a, b, i;
+	decimate_range(&d->sop, d->n, &a, &b);
+	if (b - a == d->rows) {
+		/* few enough points to output them all */
+		for (i = 0; i < d->rows; i++) {
+			d->output[2 * i] = a + i;
+			d->output[2 * i + 1] = d->values[a + i];
+		}
+		return d->output;
+	}
+	if (!d->pyramid_valid) {
+		decimate_build_pyramid(d);
+	}
+	if (d->sop.method == DECIMATE_LTTB) {
+		decimate_lttb(d, a, b);
+	} else {
+		decimate_envelope(d, a, b);
+	}
+	return d->output;
+}
+
+static void y_decimate_operation_class_init(YDecimateOperationClass * klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->set_property = y_decimate_operation_set_property;
+	gobject_klass->get_property = y_decimate_operation_get_property;
+	YOperationClass *op_klass = (YOperationClass *) klass;
+	op_klass->thread_safe = TRUE;
+	op_klass->op_size = decimate_size;
+	op_klass->op_func = decimate_op;
+	op_klass->op_data = decimate_op_create_data;
+	op_klass->op_data_free = decimate_op_data_free;
+
+	g_object_class_install_property(gobject_klass, DECIMATE_PROP_METHOD,
+					g_param_spec_int("method", "Method",
+							 "How to choose the points",
+							 DECIMATE_ENVELOPE,
+							 DECIMATE_LTTB,
+							 DECIMATE_ENVELOPE,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, DECIMATE_PROP_WIDTH,
+					g_param_spec_int("width", "Width",
+							 "Number of buckets, usually the width of the plot in pixels",
+							 4, G_MAXINT, 1000,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, DECIMATE_PROP_START,
+					g_param_spec_int("start", "Start",
+							 "Index of the first element of the range",
+							 0, G_MAXINT, 0,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, DECIMATE_PROP_END,
+					g_param_spec_int("end", "End",
+							 "Index after the last element of the range, or -1 for the end of the vector",
+							 -1, G_MAXINT, -1,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void y_decimate_operation_init(YDecimateOperation * sop)
+{
+	g_assert(Y_IS_DECIMATE_OPERATION(sop));
+	sop->method = DECIMATE_ENVELOPE;
+	sop->width = 1000;
+	sop->start = 0;
+	sop->end = -1;
+}
+
+/**
+ * y_decimate_operation_set_range:
+ * @op: a #YDecimateOperation
+ * @start: index of the first element
+ * @end: index after the last element, or -1 for the end of the vector
+ *
+ * Set the range of the input to decimate.
+ **/
+void y_decimate_operation_set_range(YDecimateOperation * op, int start,
+				    int end)
+{
+	g_return_if_fail(Y_IS_DECIMATE_OPERATION(op));
+	g_object_set(op, "start", start, "end", end, NULL);
+}
+
+/**
+ * y_decimate_operation_new:
+ * @method: %DECIMATE_ENVELOPE or %DECIMATE_LTTB
+ * @width: number of buckets, usually the width of the plot in pixels
+ *
+ * Create a new decimation operation.
+ *
+ * Returns: a #YOperation
+ **/
+YOperation *y_decimate_operation_new(int method, unsigned int width)
+{
+	return g_object_new(Y_TYPE_DECIMATE_OPERATION, "method", method,
+			    "width", width, NULL);
+}
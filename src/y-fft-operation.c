@@ -31,19 +31,78 @@
  * SECTION: y-fft-operation
  * @short_description: Operations that take the Fourier transform of input.
  *
- * These operations take the Fourier transform of the input and output the magnitude and phase of the spectrum.
+ * These operations take the Fourier transform of the input and output the magnitude, phase, power, log-power, real or imaginary part of the spectrum.
  *
+ * %FFT_COMPLEX outputs the complex spectrum, with the real and imaginary
+ * parts of each element next to each other, and %FFT_MAG_PHASE outputs the
+ * magnitude and the phase from a single transform: each row of the output
+ * holds the magnitudes followed by the phases. In both cases the output rows
+ * are twice as long as for the other types.
  *
+ * Vector inputs give the one-sided spectrum, of length n/2+1. Matrix inputs
+ * are transformed in two dimensions; the output has the same number of rows
+ * as the input and n/2+1 columns, where n is the number of input columns. If
+ * the "shift" property is set, the rows of the output are rotated so that
+ * zero frequency is in the middle row, as with fftshift. This is done while
+ * the output is written, not as a separate pass.
+ *
+ * With the "axis" property set to %FFT_ROWS or %FFT_COLUMNS, each row or
+ * column of a matrix is transformed separately instead, all with a single
+ * batched plan. For %FFT_ROWS the output has one spectrum per row, for
+ * %FFT_COLUMNS one spectrum per column.
+ *
+ * Plans are taken from the process-wide cache in y-fft-util, so derived
+ * objects of the same length share one plan. The "rigor" property selects
+ * how hard the FFTW planner works to find a fast plan.
+ *
+ * Plans are only created when the task data is updated, on the main thread,
+ * and are executed with the new-array execute functions, so the transforms
+ * of autorun derived objects are run in worker threads.
+ *
+ * Setting the "precision" property to %FFT_PRECISION_SINGLE runs the
+ * transform in single precision. The input is converted to float when it is
+ * copied into the task data, and the spectrum is converted back to double
+ * when the output is written. This halves the memory traffic of large
+ * transforms, at the cost of about seven significant digits, which is often
+ * more than the input data has.
+ *
+ * With the "inverse" property set, the operation computes the inverse,
+ * complex-to-real transform instead. The input is a spectrum in the layout
+ * written by %FFT_COMPLEX, with the same "axis", and the output is the real
+ * signal, normalized so that a forward and an inverse transform give back the
+ * original data. Signals are assumed to have an even length, so a spectrum of
+ * m elements gives 2(m-1) outputs. The inverse is always computed in double
+ * precision, and "type", "shift" and "precision" are ignored.
+ *
+ * FFTW is much slower for lengths with large prime factors, which a
+ * #YRingVector passes through as it fills. The "padding" property zero pads
+ * the input of forward transforms, along the transformed axes, to the next
+ * power of two (%FFT_PAD_POW2) or to the next length with no prime factors
+ * above 7 (%FFT_PAD_SMOOTH). The spectrum then has padded/2+1 elements; use
+ * y_fourier_linear_range_vector_set_padding() to get a matching frequency
+ * axis.
  */
 
 enum {
 	FFT_PROP_0,
-	FFT_PROP_TYPE
+	FFT_PROP_TYPE,
+	FFT_PROP_RIGOR,
+	FFT_PROP_SHIFT,
+	FFT_PROP_AXIS,
+	FFT_PROP_PRECISION,
+	FFT_PROP_INVERSE,
+	FFT_PROP_PADDING
 };
 
 struct _YFFTOperation {
 	YOperation base;
 	guchar type;
+	guchar rigor;
+	gboolean shift;
+	guchar axis;
+	guchar precision;
+	gboolean inverse;
+	guchar padding;
 };
 
 G_DEFINE_TYPE(YFFTOperation, y_fft_operation, Y_TYPE_OPERATION);
@@ -58,6 +117,24 @@ y_fft_operation_set_property(GObject * gobject, guint param_id,
 	case FFT_PROP_TYPE:
 		sop->type = g_value_get_int(value);
 		break;
+	case FFT_PROP_RIGOR:
+		sop->rigor = g_value_get_int(value);
+		break;
+	case FFT_PROP_SHIFT:
+		sop->shift = g_value_get_boolean(value);
+		break;
+	case FFT_PROP_AXIS:
+		sop->axis = g_value_get_int(value);
+		break;
+	case FFT_PROP_PRECISION:
+		sop->precision = g_value_get_int(value);
+		break;
+	case FFT_PROP_INVERSE:
+		sop->inverse = g_value_get_boolean(value);
+		break;
+	case FFT_PROP_PADDING:
+		sop->padding = g_value_get_int(value);
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
 		return;		/* NOTE : RETURN */
@@ -74,6 +151,24 @@ y_fft_operation_get_property(GObject * gobject, guint param_id,
 	case FFT_PROP_TYPE:
 		g_value_set_int(value, sop->type);
 		break;
+	case FFT_PROP_RIGOR:
+		g_value_set_int(value, sop->rigor);
+		break;
+	case FFT_PROP_SHIFT:
+		g_value_set_boolean(value, sop->shift);
+		break;
+	case FFT_PROP_AXIS:
+		g_value_set_int(value, sop->axis);
+		break;
+	case FFT_PROP_PRECISION:
+		g_value_set_int(value, sop->precision);
+		break;
+	case FFT_PROP_INVERSE:
+		g_value_set_boolean(value, sop->inverse);
+		break;
+	case FFT_PROP_PADDING:
+		g_value_set_int(value, sop->padding);
+		break;
 
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
@@ -81,28 +176,176 @@ y_fft_operation_get_property(GObject * gobject, guint param_id,
 	}
 }
 
+/* shape of the complex spectrum and of the output for an input with nrow rows
+ * and ncol columns (nrow is 1 for vectors) */
+static void
+fft_shape(const YFFTOperation * sop, gboolean is_matrix, unsigned int nrow,
+	  unsigned int ncol, unsigned int *spec_rows, unsigned int *spec_cols,
+	  unsigned int *out_rows, unsigned int *out_cols)
+{
+	gboolean columns = is_matrix && sop->axis == FFT_COLUMNS;
+	if (sop->inverse) {
+		/* the input holds interleaved real and imaginary parts */
+		*spec_rows = nrow;
+		*spec_cols = ncol / 2;
+		if (columns) {
+			*out_rows = nrow > 1 ? 2 * (nrow - 1) : 0;
+			*out_cols = ncol / 2;
+		} else {
+			*out_rows = nrow;
+			*out_cols = ncol / 2 > 1 ? 2 * (ncol / 2 - 1) : 0;
+		}
+	} else {
+		if (columns) {
+			*spec_rows = nrow / 2 + 1;
+			*spec_cols = ncol;
+		} else {
+			*spec_rows = nrow;
+			*spec_cols = ncol / 2 + 1;
+		}
+		*out_rows = *spec_rows;
+		*out_cols = *spec_cols * y_fft_output_width(sop->type);
+	}
+}
+
+/* the size of the forward transform after zero padding */
+static void
+fft_pad_shape(const YFFTOperation * sop, gboolean is_matrix,
+	      unsigned int *nrow, unsigned int *ncol)
+{
+	if (sop->inverse || sop->padding == FFT_PAD_NONE)
+		return;
+	if (!is_matrix || sop->axis != FFT_COLUMNS) {
+		*ncol = y_fft_padded_length(sop->padding, *ncol);
+	}
+	if (is_matrix && sop->axis != FFT_ROWS) {
+		*nrow = y_fft_padded_length(sop->padding, *nrow);
+	}
+}
+
 static
 int vector_fft_size(YOperation * op, YData * input, unsigned int *dims)
 {
-	int n_dims;
-	g_assert(Y_IS_VECTOR(input));
+	YFFTOperation *sop = Y_FFT_OPERATION(op);
+	unsigned int nrow, ncol, spec_rows, spec_cols;
 	g_assert(dims);
+	if (Y_IS_MATRIX(input)) {
+		YMatrixSize size = y_matrix_get_size(Y_MATRIX(input));
+		nrow = size.rows;
+		ncol = size.columns;
+		fft_pad_shape(sop, TRUE, &nrow, &ncol);
+		fft_shape(sop, TRUE, nrow, ncol, &spec_rows, &spec_cols,
+			  &dims[1], &dims[0]);
+		return 2;
+	}
+	g_assert(Y_IS_VECTOR(input));
 	YVector *mat = Y_VECTOR(input);
-	dims[0] = y_vector_get_len(mat) / 2 + 1;
-	n_dims = 1;
-	return n_dims;
+	nrow = 1;
+	ncol = y_vector_get_len(mat);
+	fft_pad_shape(sop, FALSE, &nrow, &ncol);
+	fft_shape(sop, FALSE, nrow, ncol, &spec_rows, &spec_cols, &nrow, &ncol);
+	dims[0] = ncol;
+	return 1;
 }
 
 typedef struct {
 	YFFTOperation sop;
 	double *input;
 	unsigned int len;
+	unsigned int nrow;	/* 1 for vectors */
+	unsigned int ncol;
 	fftw_complex *inter;
+	unsigned int inter_len;
+	unsigned int spec_rows;
+	unsigned int spec_cols;
 	double *output;
 	unsigned int out_len;
+	unsigned int out_rows;
+	unsigned int out_cols;
+	double scale;		/* normalization of the inverse transform */
 	fftw_plan plan;
+	/* single precision buffers, allocated only when needed */
+	float *finput;
+	unsigned int flen;
+	fftwf_complex *finter;
+	unsigned int fout_len;
+	fftwf_plan fplan;
 } FFTOpData;
 
+static void fft_op_data_release_plans(FFTOpData * d)
+{
+	y_fft_plan_release(d->plan);
+	y_fft_plan_release(d->fplan);
+	d->plan = NULL;
+	d->fplan = NULL;
+}
+
+static void fft_op_data_alloc_double(FFTOpData * d, unsigned int len,
+				     unsigned int inter_len)
+{
+	fftwf_free(d->finput);
+	fftwf_free(d->finter);
+	d->finput = NULL;
+	d->finter = NULL;
+	d->flen = 0;
+	d->fout_len = 0;
+	if (d->len != len) {
+		fftw_free(d->input);
+		d->input = fftw_alloc_real(len);
+		d->len = len;
+	}
+	if (d->inter_len != inter_len) {
+		fftw_free(d->inter);
+		d->inter = fftw_alloc_complex(inter_len);
+		d->inter_len = inter_len;
+	}
+}
+
+static void fft_op_data_alloc_single(FFTOpData * d, unsigned int len,
+				     unsigned int inter_len)
+{
+	fftw_free(d->input);
+	fftw_free(d->inter);
+	d->input = NULL;
+	d->inter = NULL;
+	d->len = 0;
+	d->inter_len = 0;
+	if (d->flen != len) {
+		fftwf_free(d->finput);
+		d->finput = fftwf_alloc_real(len);
+		d->flen = len;
+	}
+	if (d->fout_len != inter_len) {
+		fftwf_free(d->finter);
+		d->finter = fftwf_alloc_complex(inter_len);
+		d->fout_len = inter_len;
+	}
+}
+
+static void fft_op_data_plan_inverse(FFTOpData * d, gboolean is_matrix)
+{
+	unsigned int nr = d->out_rows;
+	unsigned int nc = d->out_cols;
+	if (!is_matrix) {
+		d->plan = y_fft_plan_c2r_1d(nc, d->inter, d->output,
+					    d->sop.rigor);
+		d->scale = 1.0 / nc;
+	} else if (d->sop.axis == FFT_ROWS) {
+		d->plan = y_fft_plan_c2r_many(nc, nr, 1, d->spec_cols,
+					      1, nc, d->inter, d->output,
+					      d->sop.rigor);
+		d->scale = 1.0 / nc;
+	} else if (d->sop.axis == FFT_COLUMNS) {
+		d->plan = y_fft_plan_c2r_many(nr, nc, nc, 1, nc, 1, d->inter,
+					      d->output, d->sop.rigor);
+		d->scale = 1.0 / nr;
+	} else {
+		d->plan = y_fft_plan_c2r_2d(nr, nc, d->inter, d->output,
+					    d->sop.rigor);
+		d->scale = 1.0 / ((double)nr * nc);
+	}
+}
+
 static
 gpointer vector_fft_op_create_data(YOperation * op, gpointer data,
 				   YData * input)
@@ -110,50 +353,142 @@ gpointer vector_fft_op_create_data(YOperation * op, gpointer data,
 	if (input == NULL)
 		return NULL;
 	FFTOpData *d;
-	gboolean neu = TRUE;
-	gboolean size_changed = FALSE;
 	if (data == NULL) {
 		d = g_new0(FFTOpData, 1);
 	} else {
-		neu = FALSE;
 		d = (FFTOpData *) data;
 	}
 	YFFTOperation *sop = Y_FFT_OPERATION(op);
 	d->sop = *sop;
-	YVector *vec = Y_VECTOR(input);
-	unsigned int old_len = d->len;
-	d->input = y_create_input_array_from_vector(vec, neu, d->len, d->input);
-	d->len = y_vector_get_len(vec);
-	if (d->len == 0)
+	unsigned int nrow, ncol;
+	const double *values;
+	gboolean is_matrix = Y_IS_MATRIX(input);
+	if (is_matrix) {
+		YMatrixSize size = y_matrix_get_size(Y_MATRIX(input));
+		nrow = size.rows;
+		ncol = size.columns;
+		values = y_matrix_get_values(Y_MATRIX(input));
+	} else {
+		YVector *vec = Y_VECTOR(input);
+		nrow = 1;
+		ncol = y_vector_get_len(vec);
+		values = y_vector_get_values(vec);
+	}
+	unsigned int len = nrow * ncol;
+	if (len == 0)
 		return NULL;
-	if (!neu) {
-		if (old_len != d->len) {
-			size_changed = TRUE;
-		}
+	unsigned int pnrow = nrow, pncol = ncol;
+	fft_pad_shape(&d->sop, is_matrix, &pnrow, &pncol);
+	fft_shape(&d->sop, is_matrix, pnrow, pncol, &d->spec_rows,
+		  &d->spec_cols, &d->out_rows, &d->out_cols);
+	unsigned int out_len = d->out_rows * d->out_cols;
+	unsigned int inter_len = d->spec_rows * d->spec_cols;
+	if (out_len == 0)
+		return NULL;
+	gboolean single = d->sop.precision == FFT_PRECISION_SINGLE
+	    && !d->sop.inverse;
+	/* FFTW wants SIMD-aligned arrays, so don't use y_create_input_array_from_vector */
+	if (single) {
+		fft_op_data_alloc_single(d, pnrow * pncol, inter_len);
+	} else if (d->sop.inverse) {
+		fft_op_data_alloc_double(d, 2 * inter_len, inter_len);
+	} else {
+		fft_op_data_alloc_double(d, pnrow * pncol, inter_len);
 	}
-	unsigned int dims[1];
-	vector_fft_size(op, input, dims);
-	if (d->out_len != dims[0]) {
-		size_changed = TRUE;
-		if (d->inter)
-			fftw_free(d->inter);
-		if (d->output)
-			g_free(d->output);
-		d->out_len = dims[0];
-		d->inter = fftw_malloc(sizeof(fftw_complex) * d->out_len);
-		memset(d->inter, 0, sizeof(fftw_complex) * d->out_len);
+	if (d->out_len != out_len) {
+		g_free(d->output);
+		d->out_len = out_len;
 		d->output = g_new0(double, d->out_len);
 	}
+	d->nrow = nrow;
+	d->ncol = ncol;
+	/* give back the old plan; looking up the same one again is cheap */
+	fft_op_data_release_plans(d);
+	if (d->sop.inverse) {
+		g_assert(d->input);
+		g_assert(d->inter);
+		fft_op_data_plan_inverse(d, is_matrix);
+		/* an odd number of columns leaves the last one unused */
+		unsigned int i;
+		for (i = 0; i < nrow; i++) {
+			memcpy(d->input + (gsize) i * 2 * d->spec_cols,
+			       values + (gsize) i * ncol,
+			       2 * d->spec_cols * sizeof(double));
+		}
+		return d;
+	}
+	if (single) {
+		g_assert(d->finput);
+		g_assert(d->finter);
+		if (!is_matrix) {
+			d->fplan = y_fft_plan_r2c_1d_f(pncol, d->finput,
+						       d->finter,
+						       d->sop.rigor);
+		} else if (d->sop.axis == FFT_ROWS) {
+			d->fplan = y_fft_plan_r2c_many_f(pncol, pnrow, 1, pncol,
+							 1, pncol / 2 + 1,
+							 d->finput, d->finter,
+							 d->sop.rigor);
+		} else if (d->sop.axis == FFT_COLUMNS) {
+			d->fplan = y_fft_plan_r2c_many_f(pnrow, pncol, pncol, 1,
+							 pncol, 1, d->finput,
+							 d->finter,
+							 d->sop.rigor);
+		} else {
+			d->fplan = y_fft_plan_r2c_2d_f(pnrow, pncol, d->finput,
+						       d->finter,
+						       d->sop.rigor);
+		}
+		unsigned int i, j;
+		memset(d->finput, 0, d->flen * sizeof(float));
+		for (i = 0; i < nrow; i++) {
+			for (j = 0; j < ncol; j++) {
+				d->finput[(gsize) i * pncol + j] =
+				    (float)values[(gsize) i * ncol + j];
+			}
+		}
+		return d;
+	}
 	g_assert(d->input);
 	g_assert(d->inter);
-	g_assert(d->len > 0);
-	if (neu || size_changed) {
-		d->plan =
-		    fftw_plan_dft_r2c_1d(d->len, d->input, d->inter,
-					 FFTW_ESTIMATE);
-	}
-	memset(d->inter, 0, sizeof(fftw_complex) * d->out_len);
-	memcpy(d->input, y_vector_get_values(vec), d->len * sizeof(double));
+	if (!is_matrix) {
+		d->plan = y_fft_plan_r2c_1d(pncol, d->input, d->inter,
+					    d->sop.rigor);
+	} else if (d->sop.axis == FFT_ROWS) {
+		d->plan = y_fft_plan_r2c_many(pncol, pnrow, 1, pncol,
+					      1, pncol / 2 + 1, d->input,
+					      d->inter, d->sop.rigor);
+	} else if (d->sop.axis == FFT_COLUMNS) {
+		/* the output is (pnrow/2+1) x pncol, row-major */
+		d->plan = y_fft_plan_r2c_many(pnrow, pncol, pncol, 1,
+					      pncol, 1, d->input,
+					      d->inter, d->sop.rigor);
+	} else {
+		d->plan = y_fft_plan_r2c_2d(pnrow, pncol, d->input, d->inter,
+					    d->sop.rigor);
+	}
+	if (pncol == ncol) {
+		memcpy(d->input, values, len * sizeof(double));
+	} else {
+		unsigned int i;
+		for (i = 0; i < nrow; i++) {
+			memcpy(d->input + (gsize) i * pncol,
+			       values + (gsize) i * ncol,
+			       ncol * sizeof(double));
+		}
+	}
+	/* zero padding, at the end of each row and in the extra rows */
+	if (pncol != ncol) {
+		unsigned int i;
+		for (i = 0; i < nrow; i++) {
+			memset(d->input + (gsize) i * pncol + ncol, 0,
+			       (pncol - ncol) * sizeof(double));
+		}
+	}
+	if (pnrow != nrow) {
+		memset(d->input + (gsize) nrow * pncol, 0,
+		       (gsize) (pnrow - nrow) * pncol * sizeof(double));
+	}
 	return d;
 }
 
@@ -161,9 +496,11 @@ static
 void vector_fft_op_data_free(gpointer d)
 {
 	FFTOpData *s = (FFTOpData *) d;
+	fft_op_data_release_plans(s);
 	fftw_free(s->input);
 	fftw_free(s->inter);
-	fftw_destroy_plan(s->plan);
+	fftwf_free(s->finput);
+	fftwf_free(s->finter);
 	g_free(s->output);
 	g_free(d);
 }
@@ -176,21 +513,50 @@ gpointer vector_fft_op(gpointer input)
 	if (d == NULL)
 		return NULL;
 
-	//g_message("task data: index %d, width %d, type %u, input %p, nrow %u, ncol %u",d->index,d->width,d->type,d->input,d->nrow,d->ncol);
+	if (d->sop.inverse) {
+		if (d->plan == NULL)
+			return NULL;
+		/* complex-to-real transforms destroy their input, so work on a
+		 * copy and keep the task data reusable */
+		memcpy(d->inter, d->input, d->len * sizeof(double));
+		fftw_execute_dft_c2r(d->plan, d->inter, d->output);
+		unsigned int i;
+		for (i = 0; i < d->out_len; i++) {
+			d->output[i] *= d->scale;
+		}
+		return d->output;
+	}
+
+	gboolean single = d->sop.precision == FFT_PRECISION_SINGLE;
+	if (single) {
+		if (d->fplan == NULL)
+			return NULL;
+		fftwf_execute_dft_r2c(d->fplan, d->finput, d->finter);
+	} else {
+		if (d->plan == NULL)
+			return NULL;
+		fftw_execute_dft_r2c(d->plan, d->input, d->inter);
+	}
 
-	if (d->sop.type == FFT_MAG || d->sop.type == FFT_PHASE) {
-		fftw_execute(d->plan);
-		int i;
-		if (d->sop.type == FFT_MAG) {
-			for (i = 0; i < d->out_len; i++) {
-				complex double ci = (complex double)d->inter[i];
-				d->output[i] = cabs(ci);
-			}
+	unsigned int nr = d->spec_rows;
+	unsigned int nc = d->spec_cols;
+	unsigned int w = d->out_cols;
+	gboolean shift = d->sop.shift && d->sop.axis == FFT_2D;
+	unsigned int i;
+	for (i = 0; i < nr; i++) {
+		/* fftshift along the rows: output row i comes from row i-nr/2 */
+		unsigned int src = i;
+		if (shift) {
+			src = (i + nr - nr / 2) % nr;
+		}
+		if (single) {
+			y_fft_write_output_f(d->sop.type,
+					     d->finter + (gsize) src * nc,
+					     d->output + (gsize) i * w, nc);
 		} else {
-			for (i = 0; i < d->out_len; i++) {
-				complex double ci = (complex double)d->inter[i];
-				d->output[i] = carg(ci);
-			}
+			y_fft_write_output(d->sop.type,
+					   d->inter + (gsize) src * nc,
+					   d->output + (gsize) i * w, nc);
 		}
 	}
 	return d->output;
@@ -202,7 +568,7 @@ static void y_fft_operation_class_init(YFFTOperationClass * slice_klass)
 	gobject_klass->set_property = y_fft_operation_set_property;
 	gobject_klass->get_property = y_fft_operation_get_property;
 	YOperationClass *op_klass = (YOperationClass *) slice_klass;
-	op_klass->thread_safe = FALSE;
+	op_klass->thread_safe = TRUE;
 	op_klass->op_size = vector_fft_size;
 	op_klass->op_func = vector_fft_op;
 	op_klass->op_data = vector_fft_op_create_data;
@@ -211,15 +577,57 @@ static void y_fft_operation_class_init(YFFTOperationClass * slice_klass)
 	g_object_class_install_property(gobject_klass, FFT_PROP_TYPE,
 					g_param_spec_int("type", "Type",
 							 "Type of FFT operation",
-							 FFT_MAG, FFT_PHASE,
+							 FFT_MAG, FFT_MAG_PHASE,
 							 FFT_MAG,
 							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, FFT_PROP_RIGOR,
+					g_param_spec_int("rigor", "Rigor",
+							 "How hard the FFTW planner should look for a fast plan",
+							 FFT_ESTIMATE, FFT_PATIENT,
+							 FFT_ESTIMATE,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, FFT_PROP_SHIFT,
+					g_param_spec_boolean("shift", "Shift",
+							     "Whether to move zero frequency to the middle row of a two dimensional transform",
+							     FALSE,
+							     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, FFT_PROP_AXIS,
+					g_param_spec_int("axis", "Axis",
+							 "Whether to transform matrices in two dimensions, or each row or column separately",
+							 FFT_2D, FFT_COLUMNS,
+							 FFT_2D,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, FFT_PROP_PRECISION,
+					g_param_spec_int("precision", "Precision",
+							 "Whether to compute the transform in double or single precision",
+							 FFT_PRECISION_DOUBLE,
+							 FFT_PRECISION_SINGLE,
+							 FFT_PRECISION_DOUBLE,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, FFT_PROP_INVERSE,
+					g_param_spec_boolean("inverse", "Inverse",
+							     "Whether to compute the inverse, complex-to-real transform",
+							     FALSE,
+							     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, FFT_PROP_PADDING,
+					g_param_spec_int("padding", "Padding",
+							 "How to zero pad the input to a length FFTW can transform quickly",
+							 FFT_PAD_NONE, FFT_PAD_SMOOTH,
+							 FFT_PAD_NONE,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void y_fft_operation_init(YFFTOperation * fft)
 {
 	g_assert(Y_IS_FFT_OPERATION(fft));
 	fft->type = FFT_MAG;
+	fft->rigor = FFT_ESTIMATE;
 }
 
 /**
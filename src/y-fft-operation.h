@@ -24,6 +24,7 @@
 
 #include <y-data-class.h>
 #include <y-operation.h>
+#include <y-fft-util.h>
 
 G_BEGIN_DECLS
 
@@ -31,9 +32,11 @@ G_DECLARE_FINAL_TYPE(YFFTOperation,y_fft_operation,Y,FFT_OPERATION,YOperation)
 
 #define Y_TYPE_FFT_OPERATION  (y_fft_operation_get_type ())
 
+/* how matrix inputs are transformed */
 enum {
-	FFT_MAG = 0,
-	FFT_PHASE
+	FFT_2D = 0,
+	FFT_ROWS,
+	FFT_COLUMNS
 };
 
 YOperation *y_fft_operation_new (int type);
@@ -0,0 +1,1046 @@
+/*
+ * y-fft-util.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <gio/gio.h>
+#include "y-fft-util.h"
+
+/**
+ * SECTION: y-fft-util
+ * @short_description: FFTW plan cache, wisdom and window functions.
+ *
+ * FFTW plans are expensive to create, and the planner is not thread safe. All
+ * plans used by the FFT operations are obtained from a process-wide cache,
+ * keyed by the transform size and kind, the planner rigor and the alignment of
+ * the arrays. Plans are created on scratch arrays and are meant to be run with
+ * the new-array execute functions (fftw_execute_dft_r2c() etc.), which are
+ * safe to call from any thread.
+ *
+ * Each plan obtained from the cache must be given back with
+ * y_fft_plan_release() when it is no longer needed. Plans that are not in
+ * use are kept for reuse, but only the most recently used few dozen, so data
+ * whose length keeps changing doesn't fill the cache with plans. Plans in use
+ * are never destroyed and don't count against that limit.
+ *
+ * Large multidimensional transforms use several threads when FFTW was built
+ * with thread support.
+ *
+ * Creating plans with %FFT_MEASURE or %FFT_PATIENT can take a long time.
+ * Accumulated wisdom can be saved with y_fft_export_wisdom() and loaded at
+ * startup with y_fft_import_wisdom() so that these plans are available
+ * immediately.
+ */
+
+enum {
+	FFT_PLAN_R2C_1D = 0,
+	FFT_PLAN_R2C_2D,
+	FFT_PLAN_R2C_MANY,
+	FFT_PLAN_C2R_1D,
+	FFT_PLAN_C2R_2D,
+	FFT_PLAN_C2R_MANY
+};
+
+/* transforms at least this large are planned with several threads, if
+ * FFTW was built with thread support */
+#define FFT_THREAD_THRESHOLD (256*256)
+
+typedef struct {
+	int kind;
+	int n[2];
+	int howmany;
+	int istride;
+	int idist;
+	int ostride;
+	int odist;
+	int rigor;
+	int align_in;
+	int align_out;
+	int nthreads;
+	int precision;
+} PlanKey;
+
+/* most plans kept that are not in use */
+#define PLAN_CACHE_MAX 32
+
+typedef struct {
+	int precision;
+	gpointer plan;
+	PlanKey *key;
+	int refs;
+	GList link;		/* in plan_lru */
+} CachedPlan;
+
+/* the FFTW planner is not thread safe, so everything that touches it goes
+ * through this lock */
+static GMutex plan_lock;
+static GHashTable *plan_cache = NULL;	/* key -> CachedPlan */
+static GHashTable *plan_index = NULL;	/* plan -> CachedPlan */
+static GQueue plan_lru = G_QUEUE_INIT;	/* most recently used first */
+static guint plan_unused = 0;	/* cached plans with refs == 0 */
+
+static guint plan_key_hash(gconstpointer k)
+{
+	const int *p = (const int *)k;
+	guint h = 17;
+	for (unsigned int i = 0; i < sizeof(PlanKey) / sizeof(int); i++) {
+		h = h * 31 + (guint) p[i];
+	}
+	return h;
+}
+
+static gboolean plan_key_equal(gconstpointer a, gconstpointer b)
+{
+	return memcmp(a, b, sizeof(PlanKey)) == 0;
+}
+
+static void plan_destroy(gpointer p)
+{
+	CachedPlan *c = (CachedPlan *) p;
+	if (c->precision == FFT_PRECISION_SINGLE) {
+		fftwf_destroy_plan((fftwf_plan) c->plan);
+	} else {
+		fftw_destroy_plan((fftw_plan) c->plan);
+	}
+	g_free(c);
+}
+
+static unsigned int rigor_flags(int rigor)
+{
+	switch (rigor) {
+	case FFT_PATIENT:
+		return FFTW_PATIENT;
+	case FFT_MEASURE:
+		return FFTW_MEASURE;
+	default:
+		return FFTW_ESTIMATE;
+	}
+}
+
+/* scratch arrays with the same alignment as the arrays the plan will be
+ * executed on, so MEASURE/PATIENT planning doesn't clobber the caller's data */
+static gpointer scratch_alloc(gsize size, int align, gpointer * base)
+{
+	*base = fftw_malloc(size + 64);
+	return ((char *)*base) + align;
+}
+
+static gpointer create_plan_double(const PlanKey * key)
+{
+	fftw_plan plan = NULL;
+	gpointer in_base, out_base;
+	unsigned int flags = rigor_flags(key->rigor);
+
+#ifdef HAVE_FFTW3_THREADS
+	fftw_plan_with_nthreads(key->nthreads);
+#endif
+
+	switch (key->kind) {
+	case FFT_PLAN_R2C_1D:
+		{
+			int n = key->n[0];
+			double *in =
+			    scratch_alloc(sizeof(double) * n, key->align_in,
+					  &in_base);
+			fftw_complex *out =
+			    scratch_alloc(sizeof(fftw_complex) * (n / 2 + 1),
+					  key->align_out, &out_base);
+			plan = fftw_plan_dft_r2c_1d(n, in, out, flags);
+			fftw_free(in_base);
+			fftw_free(out_base);
+		}
+		break;
+	case FFT_PLAN_R2C_2D:
+		{
+			int n0 = key->n[0];
+			int n1 = key->n[1];
+			double *in =
+			    scratch_alloc(sizeof(double) * n0 * n1,
+					  key->align_in, &in_base);
+			fftw_complex *out =
+			    scratch_alloc(sizeof(fftw_complex) * n0 *
+					  (n1 / 2 + 1), key->align_out,
+					  &out_base);
+			plan = fftw_plan_dft_r2c_2d(n0, n1, in, out, flags);
+			fftw_free(in_base);
+			fftw_free(out_base);
+		}
+		break;
+	case FFT_PLAN_R2C_MANY:
+		{
+			int n = key->n[0];
+			int nc = n / 2 + 1;
+			gsize in_len =
+			    (gsize) (key->howmany - 1) * key->idist +
+			    (gsize) (n - 1) * key->istride + 1;
+			gsize out_len =
+			    (gsize) (key->howmany - 1) * key->odist +
+			    (gsize) (nc - 1) * key->ostride + 1;
+			double *in =
+			    scratch_alloc(sizeof(double) * in_len,
+					  key->align_in, &in_base);
+			fftw_complex *out =
+			    scratch_alloc(sizeof(fftw_complex) * out_len,
+					  key->align_out, &out_base);
+			plan = fftw_plan_many_dft_r2c(1, &n, key->howmany,
+						      in, NULL, key->istride,
+						      key->idist, out, NULL,
+						      key->ostride, key->odist,
+						      flags);
+			fftw_free(in_base);
+			fftw_free(out_base);
+		}
+		break;
+	case FFT_PLAN_C2R_1D:
+		{
+			int n = key->n[0];
+			fftw_complex *in =
+			    scratch_alloc(sizeof(fftw_complex) * (n / 2 + 1),
+					  key->align_in, &in_base);
+			double *out =
+			    scratch_alloc(sizeof(double) * n, key->align_out,
+					  &out_base);
+			plan = fftw_plan_dft_c2r_1d(n, in, out, flags);
+			fftw_free(in_base);
+			fftw_free(out_base);
+		}
+		break;
+	case FFT_PLAN_C2R_2D:
+		{
+			int n0 = key->n[0];
+			int n1 = key->n[1];
+			fftw_complex *in =
+			    scratch_alloc(sizeof(fftw_complex) * n0 *
+					  (n1 / 2 + 1), key->align_in,
+					  &in_base);
+			double *out =
+			    scratch_alloc(sizeof(double) * n0 * n1,
+					  key->align_out, &out_base);
+			plan = fftw_plan_dft_c2r_2d(n0, n1, in, out, flags);
+			fftw_free(in_base);
+			fftw_free(out_base);
+		}
+		break;
+	case FFT_PLAN_C2R_MANY:
+		{
+			int n = key->n[0];
+			int nc = n / 2 + 1;
+			gsize in_len =
+			    (gsize) (key->howmany - 1) * key->idist +
+			    (gsize) (nc - 1) * key->istride + 1;
+			gsize out_len =
+			    (gsize) (key->howmany - 1) * key->odist +
+			    (gsize) (n - 1) * key->ostride + 1;
+			fftw_complex *in =
+			    scratch_alloc(sizeof(fftw_complex) * in_len,
+					  key->align_in, &in_base);
+			double *out =
+			    scratch_alloc(sizeof(double) * out_len,
+					  key->align_out, &out_base);
+			plan = fftw_plan_many_dft_c2r(1, &n, key->howmany,
+						      in, NULL, key->istride,
+						      key->idist, out, NULL,
+						      key->ostride, key->odist,
+						      flags);
+			fftw_free(in_base);
+			fftw_free(out_base);
+		}
+		break;
+	default:
+		g_assert_not_reached();
+	}
+	return plan;
+}
+
+static gpointer create_plan_single(const PlanKey * key)
+{
+	fftwf_plan plan = NULL;
+	gpointer in_base, out_base;
+	unsigned int flags = rigor_flags(key->rigor);
+
+#ifdef HAVE_FFTW3_THREADS
+	fftwf_plan_with_nthreads(key->nthreads);
+#endif
+
+	switch (key->kind) {
+	case FFT_PLAN_R2C_1D:
+		{
+			int n = key->n[0];
+			float *in =
+			    scratch_alloc(sizeof(float) * n, key->align_in,
+					  &in_base);
+			fftwf_complex *out =
+			    scratch_alloc(sizeof(fftwf_complex) * (n / 2 + 1),
+					  key->align_out, &out_base);
+			plan = fftwf_plan_dft_r2c_1d(n, in, out, flags);
+			fftwf_free(in_base);
+			fftwf_free(out_base);
+		}
+		break;
+	case FFT_PLAN_R2C_2D:
+		{
+			int n0 = key->n[0];
+			int n1 = key->n[1];
+			float *in =
+			    scratch_alloc(sizeof(float) * n0 * n1,
+					  key->align_in, &in_base);
+			fftwf_complex *out =
+			    scratch_alloc(sizeof(fftwf_complex) * n0 *
+					  (n1 / 2 + 1), key->align_out,
+					  &out_base);
+			plan = fftwf_plan_dft_r2c_2d(n0, n1, in, out, flags);
+			fftwf_free(in_base);
+			fftwf_free(out_base);
+		}
+		break;
+	case FFT_PLAN_R2C_MANY:
+		{
+			int n = key->n[0];
+			int nc = n / 2 + 1;
+			gsize in_len =
+			    (gsize) (key->howmany - 1) * key->idist +
+			    (gsize) (n - 1) * key->istride + 1;
+			gsize out_len =
+			    (gsize) (key->howmany - 1) * key->odist +
+			    (gsize) (nc - 1) * key->ostride + 1;
+			float *in =
+			    scratch_alloc(sizeof(float) * in_len,
+					  key->align_in, &in_base);
+			fftwf_complex *out =
+			    scratch_alloc(sizeof(fftwf_complex) * out_len,
+					  key->align_out, &out_base);
+			plan = fftwf_plan_many_dft_r2c(1, &n, key->howmany,
+						      in, NULL, key->istride,
+						      key->idist, out, NULL,
+						      key->ostride, key->odist,
+						      flags);
+			fftwf_free(in_base);
+			fftwf_free(out_base);
+		}
+		break;
+	default:
+		g_assert_not_reached();
+	}
+	return plan;
+}
+
+static gpointer create_plan(const PlanKey * key)
+{
+	if (key->precision == FFT_PRECISION_SINGLE) {
+		return create_plan_single(key);
+	}
+	return create_plan_double(key);
+}
+
+/* only plans that are not in use are removed */
+static void plan_cache_remove(CachedPlan * c)
+{
+	plan_unused--;
+	g_queue_unlink(&plan_lru, &c->link);
+	g_hash_table_remove(plan_index, c->plan);
+	g_hash_table_remove(plan_cache, c->key);
+}
+
+/* destroy the least recently used plans that are not in use until there are
+ * at most PLAN_CACHE_MAX of them; plans in use don't count */
+static void plan_cache_trim(void)
+{
+	GList *l = plan_lru.tail;
+	while (l != NULL && plan_unused > PLAN_CACHE_MAX) {
+		GList *prev = l->prev;
+		CachedPlan *c = (CachedPlan *) l->data;
+		if (c->refs == 0) {
+			plan_cache_remove(c);
+		}
+		l = prev;
+	}
+}
+
+static gpointer plan_cache_lookup(const PlanKey * key)
+{
+	g_mutex_lock(&plan_lock);
+	if (plan_cache == NULL) {
+#ifdef HAVE_FFTW3_THREADS
+		fftw_init_threads();
+		fftwf_init_threads();
+#endif
+		plan_cache =
+		    g_hash_table_new_full(plan_key_hash, plan_key_equal, g_free,
+					  plan_destroy);
+		plan_index = g_hash_table_new(g_direct_hash, g_direct_equal);
+	}
+	gpointer plan = NULL;
+	CachedPlan *c = g_hash_table_lookup(plan_cache, key);
+	if (c != NULL) {
+		plan = c->plan;
+		if (c->refs == 0)
+			plan_unused--;
+		c->refs++;
+		g_queue_unlink(&plan_lru, &c->link);
+		g_queue_push_head_link(&plan_lru, &c->link);
+	} else {
+		plan = create_plan(key);
+		if (plan != NULL) {
+			c = g_new0(CachedPlan, 1);
+			c->precision = key->precision;
+			c->plan = plan;
+			c->key = g_memdup(key, sizeof(PlanKey));
+			c->refs = 1;
+			c->link.data = c;
+			g_queue_push_head_link(&plan_lru, &c->link);
+			g_hash_table_insert(plan_cache, c->key, c);
+			g_hash_table_insert(plan_index, plan, c);
+			plan_cache_trim();
+		}
+	}
+	g_mutex_unlock(&plan_lock);
+	return plan;
+}
+
+/**
+ * y_fft_plan_release: (skip)
+ * @plan: (nullable): a plan obtained from one of the y_fft_plan functions,
+ * or %NULL
+ *
+ * Give back a plan that is no longer needed. It stays in the cache for reuse
+ * until too many other plans have been created.
+ **/
+void y_fft_plan_release(gpointer plan)
+{
+	if (plan == NULL)
+		return;
+	g_mutex_lock(&plan_lock);
+	CachedPlan *c = plan_index ? g_hash_table_lookup(plan_index, plan) : NULL;
+	/* unused plans are only destroyed when a new one is created, so data
+	 * can give back its plan and look up the same one again cheaply */
+	if (c != NULL && c->refs > 0) {
+		c->refs--;
+		if (c->refs == 0)
+			plan_unused++;
+	}
+	g_mutex_unlock(&plan_lock);
+}
+
+static void plan_key_1d(PlanKey * key, int n, int rigor)
+{
+	key->kind = FFT_PLAN_R2C_1D;
+	key->n[0] = n;
+	key->howmany = 1;
+	key->rigor = rigor;
+	key->nthreads = 1;
+}
+
+static void plan_key_2d(PlanKey * key, int n0, int n1, int rigor)
+{
+	key->kind = FFT_PLAN_R2C_2D;
+	key->n[0] = n0;
+	key->n[1] = n1;
+	key->howmany = 1;
+	key->rigor = rigor;
+	key->nthreads = 1;
+#ifdef HAVE_FFTW3_THREADS
+	if (n0 * n1 >= FFT_THREAD_THRESHOLD) {
+		key->nthreads = g_get_num_processors();
+	}
+#endif
+}
+
+static void plan_key_many(PlanKey * key, int n, int howmany, int istride,
+			  int idist, int ostride, int odist, int rigor)
+{
+	key->kind = FFT_PLAN_R2C_MANY;
+	key->n[0] = n;
+	key->howmany = howmany;
+	key->istride = istride;
+	key->idist = idist;
+	key->ostride = ostride;
+	key->odist = odist;
+	key->rigor = rigor;
+	key->nthreads = 1;
+#ifdef HAVE_FFTW3_THREADS
+	if (n * howmany >= FFT_THREAD_THRESHOLD) {
+		key->nthreads = g_get_num_processors();
+	}
+#endif
+}
+
+/**
+ * y_fft_plan_r2c_1d: (skip)
+ * @n: length of the transform
+ * @in: input array, used only to determine the alignment
+ * @out: output array, used only to determine the alignment
+ * @rigor: planner rigor, %FFT_ESTIMATE, %FFT_MEASURE or %FFT_PATIENT
+ *
+ * Get a cached real-to-complex plan of length @n, creating it if necessary.
+ * The plan must be executed with fftw_execute_dft_r2c() and must be given
+ * back with y_fft_plan_release() rather than destroyed.
+ *
+ * Returns: the plan, or %NULL if FFTW could not create it
+ **/
+fftw_plan y_fft_plan_r2c_1d(int n, double *in, fftw_complex * out, int rigor)
+{
+	g_return_val_if_fail(n > 0, NULL);
+	PlanKey key = { 0, };
+	plan_key_1d(&key, n, rigor);
+	key.align_in = fftw_alignment_of(in);
+	key.align_out = fftw_alignment_of((double *)out);
+	return plan_cache_lookup(&key);
+}
+
+/**
+ * y_fft_plan_r2c_2d: (skip)
+ * @n0: number of rows
+ * @n1: number of columns
+ * @in: input array, used only to determine the alignment
+ * @out: output array, used only to determine the alignment
+ * @rigor: planner rigor, %FFT_ESTIMATE, %FFT_MEASURE or %FFT_PATIENT
+ *
+ * Get a cached two dimensional real-to-complex plan for a row-major array with
+ * @n0 rows and @n1 columns, creating it if necessary. The output has @n0 rows
+ * and @n1/2+1 columns. The plan must be executed with fftw_execute_dft_r2c()
+ * and must be given back with y_fft_plan_release() rather than destroyed.
+ *
+ * Returns: the plan, or %NULL if FFTW could not create it
+ **/
+fftw_plan y_fft_plan_r2c_2d(int n0, int n1, double *in, fftw_complex * out,
+			    int rigor)
+{
+	g_return_val_if_fail(n0 > 0 && n1 > 0, NULL);
+	PlanKey key = { 0, };
+	plan_key_2d(&key, n0, n1, rigor);
+	key.align_in = fftw_alignment_of(in);
+	key.align_out = fftw_alignment_of((double *)out);
+	return plan_cache_lookup(&key);
+}
+
+/**
+ * y_fft_plan_r2c_many: (skip)
+ * @n: length of each transform
+ * @howmany: number of transforms
+ * @istride: distance between successive input elements of one transform
+ * @idist: distance between the first input elements of successive transforms
+ * @ostride: distance between successive output elements of one transform
+ * @odist: distance between the first output elements of successive transforms
+ * @in: input array, used only to determine the alignment
+ * @out: output array, used only to determine the alignment
+ * @rigor: planner rigor, %FFT_ESTIMATE, %FFT_MEASURE or %FFT_PATIENT
+ *
+ * Get a cached plan for @howmany one dimensional real-to-complex transforms
+ * of length @n, as with fftw_plan_many_dft_r2c(). Each transform has @n/2+1
+ * outputs. Transforming every row of a row-major matrix with c columns uses
+ * strides of 1 and distances of c and c/2+1; transforming every column uses
+ * strides of c and distances of 1. The plan must be executed with
+ * fftw_execute_dft_r2c() and must be given back with y_fft_plan_release() rather
+ * than destroyed.
+ *
+ * Returns: the plan, or %NULL if FFTW could not create it
+ **/
+fftw_plan y_fft_plan_r2c_many(int n, int howmany, int istride, int idist,
+			      int ostride, int odist, double *in,
+			      fftw_complex * out, int rigor)
+{
+	g_return_val_if_fail(n > 0 && howmany > 0, NULL);
+	PlanKey key = { 0, };
+	plan_key_many(&key, n, howmany, istride, idist, ostride, odist, rigor);
+	key.align_in = fftw_alignment_of(in);
+	key.align_out = fftw_alignment_of((double *)out);
+	return plan_cache_lookup(&key);
+}
+
+/**
+ * y_fft_plan_c2r_1d: (skip)
+ * @n: length of the real output
+ * @in: input array of @n/2+1 elements, used only to determine the alignment
+ * @out: output array, used only to determine the alignment
+ * @rigor: planner rigor, %FFT_ESTIMATE, %FFT_MEASURE or %FFT_PATIENT
+ *
+ * Get a cached plan for a one dimensional complex-to-real transform of
+ * length @n, the inverse of y_fft_plan_r2c_1d(). The transform is not
+ * normalized, and destroys its input. The plan must be executed with
+ * fftw_execute_dft_c2r() and must be given back with y_fft_plan_release() rather
+ * than destroyed.
+ *
+ * Returns: the plan, or %NULL if FFTW could not create it
+ **/
+fftw_plan y_fft_plan_c2r_1d(int n, fftw_complex * in, double *out, int rigor)
+{
+	g_return_val_if_fail(n > 0, NULL);
+	PlanKey key = { 0, };
+	plan_key_1d(&key, n, rigor);
+	key.kind = FFT_PLAN_C2R_1D;
+	key.align_in = fftw_alignment_of((double *)in);
+	key.align_out = fftw_alignment_of(out);
+	return plan_cache_lookup(&key);
+}
+
+/**
+ * y_fft_plan_c2r_2d: (skip)
+ * @n0: number of rows of the output
+ * @n1: number of columns of the output
+ * @in: input array, used only to determine the alignment
+ * @out: output array, used only to determine the alignment
+ * @rigor: planner rigor, %FFT_ESTIMATE, %FFT_MEASURE or %FFT_PATIENT
+ *
+ * Get a cached plan for a two dimensional complex-to-real transform, the
+ * inverse of y_fft_plan_r2c_2d(). The input has @n0 rows of @n1/2+1
+ * elements. The transform is not normalized, and destroys its input.
+ *
+ * Returns: the plan, or %NULL if FFTW could not create it
+ **/
+fftw_plan y_fft_plan_c2r_2d(int n0, int n1, fftw_complex * in, double *out,
+			    int rigor)
+{
+	g_return_val_if_fail(n0 > 0 && n1 > 0, NULL);
+	PlanKey key = { 0, };
+	plan_key_2d(&key, n0, n1, rigor);
+	key.kind = FFT_PLAN_C2R_2D;
+	key.align_in = fftw_alignment_of((double *)in);
+	key.align_out = fftw_alignment_of(out);
+	return plan_cache_lookup(&key);
+}
+
+/**
+ * y_fft_plan_c2r_many: (skip)
+ * @n: length of the real output of each transform
+ * @howmany: number of transforms
+ * @istride: distance between successive input elements of one transform
+ * @idist: distance between the first input elements of successive transforms
+ * @ostride: distance between successive output elements of one transform
+ * @odist: distance between the first output elements of successive transforms
+ * @in: input array, used only to determine the alignment
+ * @out: output array, used only to determine the alignment
+ * @rigor: planner rigor, %FFT_ESTIMATE, %FFT_MEASURE or %FFT_PATIENT
+ *
+ * Get a cached plan for @howmany complex-to-real transforms, the inverse of
+ * y_fft_plan_r2c_many(). Each transform has @n/2+1 inputs. The transforms
+ * are not normalized, and destroy their input.
+ *
+ * Returns: the plan, or %NULL if FFTW could not create it
+ **/
+fftw_plan y_fft_plan_c2r_many(int n, int howmany, int istride, int idist,
+			      int ostride, int odist, fftw_complex * in,
+			      double *out, int rigor)
+{
+	g_return_val_if_fail(n > 0 && howmany > 0, NULL);
+	PlanKey key = { 0, };
+	plan_key_many(&key, n, howmany, istride, idist, ostride, odist, rigor);
+	key.kind = FFT_PLAN_C2R_MANY;
+	key.align_in = fftw_alignment_of((double *)in);
+	key.align_out = fftw_alignment_of(out);
+	return plan_cache_lookup(&key);
+}
+
+/**
+ * y_fft_plan_r2c_1d_f: (skip)
+ * @n: length of the transform
+ * @in: input array, used only to determine the alignment
+ * @out: output array, used only to determine the alignment
+ * @rigor: planner rigor, %FFT_ESTIMATE, %FFT_MEASURE or %FFT_PATIENT
+ *
+ * Single precision version of y_fft_plan_r2c_1d(). The plan must be executed
+ * with fftwf_execute_dft_r2c().
+ *
+ * Returns: the plan, or %NULL if FFTW could not create it
+ **/
+fftwf_plan y_fft_plan_r2c_1d_f(int n, float *in, fftwf_complex * out,
+			       int rigor)
+{
+	g_return_val_if_fail(n > 0, NULL);
+	PlanKey key = { 0, };
+	plan_key_1d(&key, n, rigor);
+	key.precision = FFT_PRECISION_SINGLE;
+	key.align_in = fftwf_alignment_of(in);
+	key.align_out = fftwf_alignment_of((float *)out);
+	return plan_cache_lookup(&key);
+}
+
+/**
+ * y_fft_plan_r2c_2d_f: (skip)
+ * @n0: number of rows
+ * @n1: number of columns
+ * @in: input array, used only to determine the alignment
+ * @out: output array, used only to determine the alignment
+ * @rigor: planner rigor, %FFT_ESTIMATE, %FFT_MEASURE or %FFT_PATIENT
+ *
+ * Single precision version of y_fft_plan_r2c_2d(). The plan must be executed
+ * with fftwf_execute_dft_r2c().
+ *
+ * Returns: the plan, or %NULL if FFTW could not create it
+ **/
+fftwf_plan y_fft_plan_r2c_2d_f(int n0, int n1, float *in, fftwf_complex * out,
+			       int rigor)
+{
+	g_return_val_if_fail(n0 > 0 && n1 > 0, NULL);
+	PlanKey key = { 0, };
+	plan_key_2d(&key, n0, n1, rigor);
+	key.precision = FFT_PRECISION_SINGLE;
+	key.align_in = fftwf_alignment_of(in);
+	key.align_out = fftwf_alignment_of((float *)out);
+	return plan_cache_lookup(&key);
+}
+
+/**
+ * y_fft_plan_r2c_many_f: (skip)
+ * @n: length of each transform
+ * @howmany: number of transforms
+ * @istride: distance between successive input elements of one transform
+ * @idist: distance between the first input elements of successive transforms
+ * @ostride: distance between successive output elements of one transform
+ * @odist: distance between the first output elements of successive transforms
+ * @in: input array, used only to determine the alignment
+ * @out: output array, used only to determine the alignment
+ * @rigor: planner rigor, %FFT_ESTIMATE, %FFT_MEASURE or %FFT_PATIENT
+ *
+ * Single precision version of y_fft_plan_r2c_many(). The plan must be
+ * executed with fftwf_execute_dft_r2c().
+ *
+ * Returns: the plan, or %NULL if FFTW could not create it
+ **/
+fftwf_plan y_fft_plan_r2c_many_f(int n, int howmany, int istride, int idist,
+				 int ostride, int odist, float *in,
+				 fftwf_complex * out, int rigor)
+{
+	g_return_val_if_fail(n > 0 && howmany > 0, NULL);
+	PlanKey key = { 0, };
+	plan_key_many(&key, n, howmany, istride, idist, ostride, odist, rigor);
+	key.precision = FFT_PRECISION_SINGLE;
+	key.align_in = fftwf_alignment_of(in);
+	key.align_out = fftwf_alignment_of((float *)out);
+	return plan_cache_lookup(&key);
+}
+
+/**
+ * y_fft_padded_length:
+ * @padding: the padding policy, %FFT_PAD_NONE, %FFT_PAD_POW2 or
+ * %FFT_PAD_SMOOTH
+ * @n: length of the data
+ *
+ * Get the length a transform of @n points is zero padded to. With
+ * %FFT_PAD_POW2 this is the next power of two, and with %FFT_PAD_SMOOTH the
+ * next number of the form 2^a 3^b 5^c 7^d, for which FFTW has fast codelets.
+ *
+ * Returns: the padded length, at least @n
+ **/
+unsigned int y_fft_padded_length(int padding, unsigned int n)
+{
+	if (n < 2) {
+		return n;
+	}
+	if (padding == FFT_PAD_POW2) {
+		unsigned int m = 1;
+		while (m < n) {
+			m <<= 1;
+		}
+		return m;
+	}
+	if (padding == FFT_PAD_SMOOTH) {
+		unsigned int m;
+		for (m = n;; m++) {
+			unsigned int r = m;
+			while (r % 2 == 0)
+				r /= 2;
+			while (r % 3 == 0)
+				r /= 3;
+			while (r % 5 == 0)
+				r /= 5;
+			while (r % 7 == 0)
+				r /= 7;
+			if (r == 1) {
+				return m;
+			}
+		}
+	}
+	return n;
+}
+
+/**
+ * y_fft_output_width:
+ * @type: what to output, e.g. %FFT_MAG
+ *
+ * Get the number of real values written for each element of a spectrum.
+ *
+ * Returns: 2 for %FFT_COMPLEX and %FFT_MAG_PHASE, 1 otherwise
+ **/
+unsigned int y_fft_output_width(int type)
+{
+	if (type == FFT_COMPLEX || type == FFT_MAG_PHASE) {
+		return 2;
+	}
+	return 1;
+}
+
+/**
+ * y_fft_write_output: (skip)
+ * @type: what to output, e.g. %FFT_MAG or %FFT_COMPLEX
+ * @x: complex spectrum
+ * @out: output array
+ * @n: number of elements
+ *
+ * Convert @n elements of a complex spectrum to real numbers. Log-power is
+ * 10*log10 of the power. %FFT_COMPLEX writes the real and imaginary parts of
+ * each element next to each other, and %FFT_MAG_PHASE writes the @n
+ * magnitudes followed by the @n phases, so for these @out must have room for
+ * 2*@n values; see y_fft_output_width().
+ **/
+void y_fft_write_output(int type, const fftw_complex * x, double *out,
+			unsigned int n)
+{
+	unsigned int i;
+	switch (type) {
+	case FFT_PHASE:
+		for (i = 0; i < n; i++) {
+			out[i] = carg((complex double)x[i]);
+		}
+		break;
+	case FFT_POWER:
+		for (i = 0; i < n; i++) {
+			double re = creal((complex double)x[i]);
+			double im = cimag((complex double)x[i]);
+			out[i] = re * re + im * im;
+		}
+		break;
+	case FFT_LOG_POWER:
+		for (i = 0; i < n; i++) {
+			double re = creal((complex double)x[i]);
+			double im = cimag((complex double)x[i]);
+			out[i] = 10.0 * log10(re * re + im * im);
+		}
+		break;
+	case FFT_REAL:
+		for (i = 0; i < n; i++) {
+			out[i] = creal((complex double)x[i]);
+		}
+		break;
+	case FFT_IMAG:
+		for (i = 0; i < n; i++) {
+			out[i] = cimag((complex double)x[i]);
+		}
+		break;
+	case FFT_COMPLEX:
+		memcpy(out, x, sizeof(fftw_complex) * n);
+		break;
+	case FFT_MAG_PHASE:
+		for (i = 0; i < n; i++) {
+			out[i] = cabs((complex double)x[i]);
+			out[n + i] = carg((complex double)x[i]);
+		}
+		break;
+	default:
+		for (i = 0; i < n; i++) {
+			out[i] = cabs((complex double)x[i]);
+		}
+		break;
+	}
+}
+
+/**
+ * y_fft_write_output_f: (skip)
+ * @type: what to output, e.g. %FFT_MAG or %FFT_COMPLEX
+ * @x: single precision complex spectrum
+ * @out: output array
+ * @n: number of elements
+ *
+ * Single precision version of y_fft_write_output().
+ **/
+void y_fft_write_output_f(int type, const fftwf_complex * x, double *out,
+			  unsigned int n)
+{
+	unsigned int i;
+	for (i = 0; i < n; i++) {
+		complex float c = (complex float)x[i];
+		double re = crealf(c);
+		double im = cimagf(c);
+		switch (type) {
+		case FFT_PHASE:
+			out[i] = atan2(im, re);
+			break;
+		case FFT_POWER:
+			out[i] = re * re + im * im;
+			break;
+		case FFT_LOG_POWER:
+			out[i] = 10.0 * log10(re * re + im * im);
+			break;
+		case FFT_REAL:
+			out[i] = re;
+			break;
+		case FFT_IMAG:
+			out[i] = im;
+			break;
+		case FFT_COMPLEX:
+			out[2 * i] = re;
+			out[2 * i + 1] = im;
+			break;
+		case FFT_MAG_PHASE:
+			out[i] = sqrt(re * re + im * im);
+			out[n + i] = atan2(im, re);
+			break;
+		default:
+			out[i] = sqrt(re * re + im * im);
+			break;
+		}
+	}
+}
+
+/**
+ * y_fft_window_fill:
+ * @window: the window function, e.g. %FFT_WINDOW_HANN
+ * @w: (array length=n): array to fill
+ * @n: length of the window
+ *
+ * Fill @w with a window function. The windows are periodic (DFT-even), as is
+ * usual for spectral analysis.
+ **/
+void y_fft_window_fill(int window, double *w, unsigned int n)
+{
+	unsigned int i;
+	for (i = 0; i < n; i++) {
+		double x = 2 * G_PI * i / n;
+		switch (window) {
+		case FFT_WINDOW_HANN:
+			w[i] = 0.5 - 0.5 * cos(x);
+			break;
+		case FFT_WINDOW_HAMMING:
+			w[i] = 0.54 - 0.46 * cos(x);
+			break;
+		case FFT_WINDOW_BLACKMAN_HARRIS:
+			w[i] = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2 * x)
+			    - 0.01168 * cos(3 * x);
+			break;
+		case FFT_WINDOW_FLAT_TOP:
+			w[i] = 0.21557895 - 0.41663158 * cos(x)
+			    + 0.277263158 * cos(2 * x)
+			    - 0.083578947 * cos(3 * x)
+			    + 0.006947368 * cos(4 * x);
+			break;
+		default:
+			w[i] = 1.0;
+			break;
+		}
+	}
+}
+
+/**
+ * y_fft_plan_cache_clear:
+ *
+ * Destroy all cached plans that are not in use.
+ **/
+void y_fft_plan_cache_clear(void)
+{
+	g_mutex_lock(&plan_lock);
+	GList *l = plan_lru.head;
+	while (l != NULL) {
+		GList *next = l->next;
+		CachedPlan *c = (CachedPlan *) l->data;
+		if (c->refs == 0) {
+			plan_cache_remove(c);
+		}
+		l = next;
+	}
+	g_mutex_unlock(&plan_lock);
+}
+
+/* find the end of the first s-expression in a wisdom string */
+static const gchar *wisdom_end(const gchar * s)
+{
+	int depth = 0;
+	for (; *s != '\0'; s++) {
+		if (*s == '(') {
+			depth++;
+		} else if (*s == ')') {
+			depth--;
+			if (depth == 0) {
+				return s + 1;
+			}
+		}
+	}
+	return s;
+}
+
+/**
+ * y_fft_import_wisdom:
+ * @filename: file to read
+ * @err: (nullable): a #GError or %NULL
+ *
+ * Load FFTW wisdom from a file, so that plans created with %FFT_MEASURE or
+ * %FFT_PATIENT rigor don't need to be measured again. The file holds wisdom
+ * for both double and single precision plans, as written by
+ * y_fft_export_wisdom().
+ *
+ * Returns: %TRUE if the wisdom was imported
+ **/
+gboolean y_fft_import_wisdom(const gchar * filename, GError ** err)
+{
+	g_return_val_if_fail(filename != NULL, FALSE);
+	gchar *contents = NULL;
+	if (!g_file_get_contents(filename, &contents, NULL, err)) {
+		return FALSE;
+	}
+	/* double precision wisdom, optionally followed by single precision */
+	const gchar *end = wisdom_end(contents);
+	gchar *wisdom = g_strndup(contents, end - contents);
+	g_mutex_lock(&plan_lock);
+	int ok = fftw_import_wisdom_from_string(wisdom);
+	if (ok && strchr(end, '(') != NULL) {
+		ok = fftwf_import_wisdom_from_string(end);
+	}
+	g_mutex_unlock(&plan_lock);
+	g_free(wisdom);
+	g_free(contents);
+	if (!ok) {
+		g_set_error(err, G_IO_ERROR, G_IO_ERROR_FAILED,
+			    "could not import FFTW wisdom from %s", filename);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * y_fft_export_wisdom:
+ * @filename: file to write
+ * @err: (nullable): a #GError or %NULL
+ *
+ * Save the wisdom accumulated by the FFTW planner to a file.
+ *
+ * Returns: %TRUE if the wisdom was exported
+ **/
+gboolean y_fft_export_wisdom(const gchar * filename, GError ** err)
+{
+	g_return_val_if_fail(filename != NULL, FALSE);
+	g_mutex_lock(&plan_lock);
+	char *wd = fftw_export_wisdom_to_string();
+	char *wf = fftwf_export_wisdom_to_string();
+	g_mutex_unlock(&plan_lock);
+	if (wd == NULL || wf == NULL) {
+		free(wd);
+		free(wf);
+		g_set_error(err, G_IO_ERROR, G_IO_ERROR_FAILED,
+			    "could not export FFTW wisdom to %s", filename);
+		return FALSE;
+	}
+	gchar *contents = g_strconcat(wd, "\n", wf, NULL);
+	free(wd);
+	free(wf);
+	gboolean ok = g_file_set_contents(filename, contents, -1, err);
+	g_free(contents);
+	return ok;
+}
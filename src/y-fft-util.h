@@ -0,0 +1,98 @@
+/*
+ * y-fft-util.h :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef Y_FFT_UTIL_H
+#define Y_FFT_UTIL_H
+
+#include <glib-object.h>
+#ifndef __GI_SCANNER__
+#include <fftw3.h>
+#endif
+
+G_BEGIN_DECLS
+
+/* planner rigor */
+enum {
+	FFT_ESTIMATE = 0,
+	FFT_MEASURE,
+	FFT_PATIENT
+};
+
+/* precision */
+enum {
+	FFT_PRECISION_DOUBLE = 0,
+	FFT_PRECISION_SINGLE
+};
+
+/* zero padding policy */
+enum {
+	FFT_PAD_NONE = 0,
+	FFT_PAD_POW2,
+	FFT_PAD_SMOOTH
+};
+
+/* what to output from a complex spectrum */
+enum {
+	FFT_MAG = 0,
+	FFT_PHASE,
+	FFT_POWER,
+	FFT_LOG_POWER,
+	FFT_REAL,
+	FFT_IMAG,
+	FFT_COMPLEX,
+	FFT_MAG_PHASE
+};
+
+/* window functions */
+enum {
+	FFT_WINDOW_RECTANGULAR = 0,
+	FFT_WINDOW_HANN,
+	FFT_WINDOW_HAMMING,
+	FFT_WINDOW_BLACKMAN_HARRIS,
+	FFT_WINDOW_FLAT_TOP
+};
+
+gboolean y_fft_import_wisdom(const gchar *filename, GError **err);
+gboolean y_fft_export_wisdom(const gchar *filename, GError **err);
+void y_fft_plan_cache_clear(void);
+void y_fft_plan_release(gpointer plan);
+void y_fft_window_fill(int window, double *w, unsigned int n);
+unsigned int y_fft_output_width(int type);
+unsigned int y_fft_padded_length(int padding, unsigned int n);
+
+#ifndef __GI_SCANNER__
+fftw_plan y_fft_plan_r2c_1d(int n, double *in, fftw_complex *out, int rigor);
+fftw_plan y_fft_plan_r2c_2d(int n0, int n1, double *in, fftw_complex *out, int rigor);
+void y_fft_write_output(int type, const fftw_complex *x, double *out, unsigned int n);
+fftw_plan y_fft_plan_r2c_many(int n, int howmany, int istride, int idist, int ostride, int odist, double *in, fftw_complex *out, int rigor);
+fftw_plan y_fft_plan_c2r_1d(int n, fftw_complex *in, double *out, int rigor);
+fftw_plan y_fft_plan_c2r_2d(int n0, int n1, fftw_complex *in, double *out, int rigor);
+fftw_plan y_fft_plan_c2r_many(int n, int howmany, int istride, int idist, int ostride, int odist, fftw_complex *in, double *out, int rigor);
+
+void y_fft_write_output_f(int type, const fftwf_complex *x, double *out, unsigned int n);
+fftwf_plan y_fft_plan_r2c_1d_f(int n, float *in, fftwf_complex *out, int rigor);
+fftwf_plan y_fft_plan_r2c_2d_f(int n0, int n1, float *in, fftwf_complex *out, int rigor);
+fftwf_plan y_fft_plan_r2c_many_f(int n, int howmany, int istride, int idist, int ostride, int odist, float *in, fftwf_complex *out, int rigor);
+#endif
+
+G_END_DECLS
+
+#endif
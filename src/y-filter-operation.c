@@ -0,0 +1,605 @@
+/*
+ * y-filter-operation.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <memory.h>
+#include <math.h>
+#include <complex.h>
+#include "y-filter-operation.h"
+#include "y-vector-ring.h"
+
+/**
+ * SECTION: y-filter-operation
+ * @short_description: Operation that applies FIR and IIR filters.
+ *
+ * This operation filters vectors, or each row of a matrix, with an FIR
+ * kernel followed by a cascade of biquad IIR sections. Either may be empty.
+ * The filters are causal: output sample n depends on input samples n and
+ * earlier, and samples before the start of the input are taken as zero. The
+ * output has the same size as the input.
+ *
+ * The FIR kernel h gives y[n] = sum_k h[k] x[n-k]. Short kernels are applied
+ * directly; kernels with at least 64 taps are applied by FFT overlap-save,
+ * whose cost per sample grows only with the logarithm of the kernel length.
+ * The "method" property can force either. IIR sections are given as six
+ * coefficients each, b0 b1 b2 a0 a1 a2, in the same layout as the
+ * second-order sections of SciPy, and are applied in direct form II
+ * transposed.
+ *
+ * When the input is a #YRingVector, the filter state is kept between runs,
+ * and only samples appended since the last run are filtered; the output holds
+ * the filtered values of the samples currently in the ring. New samples are
+ * found with y_ring_vector_get_n_appended(). If samples were dropped from the
+ * ring before the operation saw them, it starts again from a zero state. For
+ * other inputs, everything is filtered each time.
+ */
+
+enum {
+	FILTER_PROP_0,
+	FILTER_PROP_KERNEL,
+	FILTER_PROP_SECTIONS,
+	FILTER_PROP_METHOD,
+	N_PROPERTIES
+};
+
+/* kernels at least this long are applied by FFT with FILTER_AUTO */
+#define FILTER_FFT_TAPS 64
+
+struct _YFilterOperation {
+	YOperation base;
+	GArray *kernel;
+	GArray *sections;
+	guchar method;
+};
+
+G_DEFINE_TYPE(YFilterOperation, y_filter_operation, Y_TYPE_OPERATION);
+
+static GArray *array_copy(const double *v, unsigned int n)
+{
+	GArray *a = g_array_sized_new(FALSE, FALSE, sizeof(double), n);
+	g_array_append_vals(a, v, n);
+	return a;
+}
+
+static GArray *array_from_value(GValue const *value)
+{
+	GArray *a = g_value_get_boxed(value);
+	if (a == NULL) {
+		return array_copy(NULL, 0);
+	}
+	return array_copy((const double *)a->data, a->len);
+}
+
+static void
+y_filter_operation_set_property(GObject * gobject, guint param_id,
+				GValue const *value, GParamSpec * pspec)
+{
+	YFilterOperation *sop = Y_FILTER_OPERATION(gobject);
+
+	switch (param_id) {
+	case FILTER_PROP_KERNEL:
+		g_array_unref(sop->kernel);
+		sop->kernel = array_from_value(value);
+		break;
+	case FILTER_PROP_SECTIONS:
+		g_array_unref(sop->sections);
+		sop->sections = array_from_value(value);
+		break;
+	case FILTER_PROP_METHOD:
+		sop->method = g_value_get_int(value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void
+y_filter_operation_get_property(GObject * gobject, guint param_id,
+				GValue * value, GParamSpec * pspec)
+{
+	YFilterOperation *sop = Y_FILTER_OPERATION(gobject);
+
+	switch (param_id) {
+	case FILTER_PROP_KERNEL:
+		g_value_set_boxed(value, sop->kernel);
+		break;
+	case FILTER_PROP_SECTIONS:
+		g_value_set_boxed(value, sop->sections);
+		break;
+	case FILTER_PROP_METHOD:
+		g_value_set_int(value, sop->method);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void y_filter_operation_finalize(GObject * obj)
+{
+	YFilterOperation *sop = Y_FILTER_OPERATION(obj);
+	g_array_unref(sop->kernel);
+	g_array_unref(sop->sections);
+	G_OBJECT_CLASS(y_filter_operation_parent_class)->finalize(obj);
+}
+
+static
+int filter_size(YOperation * op, YData * input, unsigned int *dims)
+{
+	g_assert(dims);
+	if (Y_IS_MATRIX(input)) {
+		YMatrixSize size = y_matrix_get_size(Y_MATRIX(input));
+		dims[0] = size.columns;
+		dims[1] = size.rows;
+		return 2;
+	}
+	g_assert(Y_IS_VECTOR(input));
+	dims[0] = y_vector_get_len(Y_VECTOR(input));
+	return 1;
+}
+
+typedef struct {
+	YFilterOperation sop;	/* kernel and sections are not valid in the copy */
+	/* copies of the properties */
+	unsigned int ntaps;
+	double *kernel;
+	unsigned int nsec;
+	double *sections;
+	/* FIR kernel, reversed */
+	double *rkernel;
+	/* IIR sections, normalized: b0 b1 b2 a1 a2 */
+	double *sec;
+	/* overlap-save */
+	gboolean use_fft;
+	unsigned int fft_len;
+	double *fbuf;
+	fftw_complex *fspec;
+	fftw_complex *kspec;
+	fftw_plan fwd;
+	fftw_plan inv;
+	/* previous ntaps-1 inputs followed by the samples being filtered */
+	double *ext;
+	unsigned int ext_size;
+	/* filter state for vectors */
+	double *hist;
+	double *state;
+	/* input */
+	gboolean is_matrix;
+	unsigned int nrow;
+	unsigned int ncol;
+	double *input;
+	unsigned int n_input;
+	unsigned int input_size;
+	/* for vectors, the output holds samples out_first to out_first+out_len */
+	guint64 first;
+	guint64 out_first;
+	unsigned int out_len;
+	guint64 seen;
+	gboolean started;
+	double *output;
+	unsigned int output_size;
+} FilterOpData;
+
+static gboolean array_equal(const double *a, unsigned int na, const GArray * b)
+{
+	return na == b->len && memcmp(a, b->data, na * sizeof(double)) == 0;
+}
+
+static gboolean filter_pars_equal(const FilterOpData * d,
+				  const YFilterOperation * sop)
+{
+	return d->sop.method == sop->method
+	    && array_equal(d->sections, d->nsec * 6, sop->sections)
+	    && array_equal(d->kernel, d->ntaps, sop->kernel);
+}
+
+static void filter_free_coefficients(FilterOpData * d)
+{
+	g_free(d->kernel);
+	g_free(d->sections);
+	g_free(d->rkernel);
+	g_free(d->sec);
+	g_free(d->hist);
+	g_free(d->state);
+	fftw_free(d->fbuf);
+	fftw_free(d->fspec);
+	fftw_free(d->kspec);
+	d->fbuf = NULL;
+	d->fspec = NULL;
+	d->kspec = NULL;
+	y_fft_plan_release(d->fwd);
+	y_fft_plan_release(d->inv);
+	d->fwd = NULL;
+	d->inv = NULL;
+}
+
+static void filter_clear(FilterOpData * d)
+{
+	if (d->ntaps > 1) {
+		memset(d->hist, 0, (d->ntaps - 1) * sizeof(double));
+	}
+	memset(d->state, 0, 2 * d->nsec * sizeof(double));
+}
+
+static void filter_reset(FilterOpData * d, const YFilterOperation * sop)
+{
+	unsigned int i;
+	filter_free_coefficients(d);
+	d->ntaps = sop->kernel->len;
+	d->kernel = g_memdup(sop->kernel->data, d->ntaps * sizeof(double));
+	d->nsec = sop->sections->len / 6;
+	d->sections = g_memdup(sop->sections->data,
+			       d->nsec * 6 * sizeof(double));
+	d->rkernel = g_new(double, d->ntaps);
+	for (i = 0; i < d->ntaps; i++) {
+		d->rkernel[i] = d->kernel[d->ntaps - 1 - i];
+	}
+	d->sec = g_new(double, 5 * d->nsec);
+	for (i = 0; i < d->nsec; i++) {
+		const double *c = d->sections + 6 * i;
+		double *s = d->sec + 5 * i;
+		s[0] = c[0] / c[3];
+		s[1] = c[1] / c[3];
+		s[2] = c[2] / c[3];
+		s[3] = c[4] / c[3];
+		s[4] = c[5] / c[3];
+	}
+	d->hist = g_new0(double, MAX(d->ntaps, 1));
+	d->state = g_new0(double, 2 * d->nsec + 1);
+
+	if (sop->method == FILTER_FFT) {
+		d->use_fft = d->ntaps > 0;
+	} else if (sop->method == FILTER_DIRECT) {
+		d->use_fft = FALSE;
+	} else {
+		d->use_fft = d->ntaps >= FILTER_FFT_TAPS;
+	}
+	if (d->use_fft) {
+		/* blocks of at least four kernel lengths keep the overlap small */
+		unsigned int L = y_fft_padded_length(FFT_PAD_POW2, 4 * d->ntaps);
+		unsigned int nc = L / 2 + 1;
+		d->fft_len = L;
+		d->fbuf = fftw_alloc_real(L);
+		d->fspec = fftw_alloc_complex(nc);
+		d->kspec = fftw_alloc_complex(nc);
+		d->fwd = y_fft_plan_r2c_1d(L, d->fbuf, d->fspec, FFT_ESTIMATE);
+		d->inv = y_fft_plan_c2r_1d(L, d->fspec, d->fbuf, FFT_ESTIMATE);
+		if (d->fwd == NULL || d->inv == NULL) {
+			d->use_fft = FALSE;
+		} else {
+			/* spectrum of the kernel, with the 1/L of the inverse */
+			memset(d->fbuf, 0, L * sizeof(double));
+			for (i = 0; i < d->ntaps; i++) {
+				d->fbuf[i] = d->kernel[i] / L;
+			}
+			fftw_execute_dft_r2c(d->fwd, d->fbuf, d->kspec);
+		}
+	}
+	d->started = FALSE;
+}
+
+static
+gpointer filter_op_create_data(YOperation * op, gpointer data, YData * input)
+{
+	if (input == NULL)
+		return NULL;
+	FilterOpData *d;
+	YFilterOperation *sop = Y_FILTER_OPERATION(op);
+	gboolean reset = FALSE;
+	if (data == NULL) {
+		d = g_new0(FilterOpData, 1);
+		reset = TRUE;
+	} else {
+		d = (FilterOpData *) data;
+		reset = !filter_pars_equal(d, sop);
+	}
+	d->sop = *sop;
+	d->sop.kernel = NULL;
+	d->sop.sections = NULL;
+	if (reset) {
+		filter_reset(d, sop);
+	}
+
+	const double *v;
+	unsigned int n;
+	guint64 total;
+	d->is_matrix = Y_IS_MATRIX(input);
+	if (d->is_matrix) {
+		YMatrixSize size = y_matrix_get_size(Y_MATRIX(input));
+		d->nrow = size.rows;
+		d->ncol = size.columns;
+		n = d->nrow * d->ncol;
+		v = y_matrix_get_values(Y_MATRIX(input));
+		total = n;
+		d->started = FALSE;
+	} else {
+		YVector *vec = Y_VECTOR(input);
+		n = y_vector_get_len(vec);
+		v = y_vector_get_values(vec);
+		d->nrow = 1;
+		d->ncol = n;
+		total = n;
+		if (Y_IS_RING_VECTOR(input)) {
+			total =
+			    y_ring_vector_get_n_appended(Y_RING_VECTOR(input));
+		} else {
+			/* no way to tell what is new, so start over */
+			d->started = FALSE;
+		}
+	}
+	guint64 first = total - n;	/* sample number of v[0] */
+	/* samples not yet filtered are appended to the input; if some were
+	 * dropped from the ring before we saw them, start again */
+	if (!d->started || d->seen < first || d->n_input + total - d->seen > n) {
+		filter_clear(d);
+		d->seen = first;
+		d->out_first = first;
+		d->out_len = 0;
+		d->n_input = 0;
+		d->started = TRUE;
+	}
+	d->first = first;
+	unsigned int nnew = total - d->seen;
+	if (d->n_input + nnew > d->input_size) {
+		d->input_size = d->n_input + nnew;
+		d->input = g_renew(double, d->input, d->input_size);
+	}
+	memcpy(d->input + d->n_input, v + (d->seen - first),
+	       nnew * sizeof(double));
+	d->n_input += nnew;
+	d->seen = total;
+	if (n > d->output_size) {
+		/* keeps the values already filtered */
+		d->output_size = n;
+		d->output = g_renew(double, d->output, d->output_size);
+	}
+	unsigned int chunk = d->is_matrix ? d->ncol : d->n_input;
+	if (d->ntaps > 0 && d->ntaps - 1 + chunk > d->ext_size) {
+		d->ext_size = d->ntaps - 1 + chunk;
+		d->ext = g_renew(double, d->ext, d->ext_size);
+	}
+	return d;
+}
+
+static
+void filter_op_data_free(gpointer data)
+{
+	FilterOpData *d = (FilterOpData *) data;
+	filter_free_coefficients(d);
+	g_free(d->ext);
+	g_free(d->input);
+	g_free(d->output);
+	g_free(d);
+}
+
+/* y[i] = sum_k h[k] ext[m-1+i-k], using overlap-save */
+static void filter_fir_fft(FilterOpData * d, unsigned int n, double *y)
+{
+	unsigned int m = d->ntaps;
+	unsigned int L = d->fft_len;
+	unsigned int nc = L / 2 + 1;
+	unsigned int step = L - (m - 1);
+	unsigned int b, i;
+	for (b = 0; b < n; b += step) {
+		unsigned int avail = MIN(L, m - 1 + n - b);
+		memcpy(d->fbuf, d->ext + b, avail * sizeof(double));
+		memset(d->fbuf + avail, 0, (L - avail) * sizeof(double));
+		fftw_execute_dft_r2c(d->fwd, d->fbuf, d->fspec);
+		for (i = 0; i < nc; i++) {
+			d->fspec[i] *= d->kspec[i];
+		}
+		fftw_execute_dft_c2r(d->inv, d->fspec, d->fbuf);
+		/* the first m-1 outputs of each block wrap around */
+		memcpy(y + b, d->fbuf + m - 1,
+		       MIN(step, n - b) * sizeof(double));
+	}
+}
+
+/* filter one channel, continuing from the state in hist and state */
+static void filter_channel(FilterOpData * d, const double *x, unsigned int n,
+			   double *y, double *hist, double *state)
+{
+	unsigned int m = d->ntaps;
+	unsigned int i, j;
+	if (n == 0)
+		return;
+	if (m > 0) {
+		memcpy(d->ext, hist, (m - 1) * sizeof(double));
+		memcpy(d->ext + m - 1, x, n * sizeof(double));
+		if (d->use_fft) {
+			filter_fir_fft(d, n, y);
+		} else {
+			for (i = 0; i < n; i++) {
+				const double *e = d->ext + i;
+				double sum = 0.0;
+				for (j = 0; j < m; j++) {
+					sum += d->rkernel[j] * e[j];
+				}
+				y[i] = sum;
+			}
+		}
+		memcpy(hist, d->ext + n, (m - 1) * sizeof(double));
+	} else {
+		memcpy(y, x, n * sizeof(double));
+	}
+	for (j = 0; j < d->nsec; j++) {
+		const double *c = d->sec + 5 * j;
+		double s1 = state[2 * j];
+		double s2 = state[2 * j + 1];
+		for (i = 0; i < n; i++) {
+			double in = y[i];
+			double out = c[0] * in + s1;
+			s1 = c[1] * in - c[3] * out + s2;
+			s2 = c[2] * in - c[4] * out;
+			y[i] = out;
+		}
+		state[2 * j] = s1;
+		state[2 * j + 1] = s2;
+	}
+}
+
+static
+gpointer filter_op(gpointer input)
+{
+	FilterOpData *d = (FilterOpData *) input;
+
+	if (d == NULL)
+		return NULL;
+
+	if (d->is_matrix) {
+		unsigned int i;
+		for (i = 0; i < d->nrow; i++) {
+			filter_clear(d);
+			filter_channel(d, d->input + (gsize) i * d->ncol,
+				       d->ncol,
+				       d->output + (gsize) i * d->ncol,
+				       d->hist, d->state);
+		}
+		d->n_input = 0;
+		return d->output;
+	}
+
+	/* drop the outputs of samples that have left the ring */
+	guint64 shift = d->first - d->out_first;
+	unsigned int keep = shift < d->out_len ? d->out_len - shift : 0;
+	if (keep > 0 && shift > 0) {
+		memmove(d->output, d->output + shift, keep * sizeof(double));
+	}
+	filter_channel(d, d->input, d->n_input, d->output + keep, d->hist,
+		       d->state);
+	d->out_first = d->first;
+	d->out_len = keep + d->n_input;
+	d->n_input = 0;
+	return d->output;
+}
+
+static void y_filter_operation_class_init(YFilterOperationClass * klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->set_property = y_filter_operation_set_property;
+	gobject_klass->get_property = y_filter_operation_get_property;
+	gobject_klass->finalize = y_filter_operation_finalize;
+	YOperationClass *op_klass = (YOperationClass *) klass;
+	op_klass->thread_safe = TRUE;
+	op_klass->op_size = filter_size;
+	op_klass->op_func = filter_op;
+	op_klass->op_data = filter_op_create_data;
+	op_klass->op_data_free = filter_op_data_free;
+
+	g_object_class_install_property(gobject_klass, FILTER_PROP_KERNEL,
+					g_param_spec_boxed("kernel", "Kernel",
+							   "Array of doubles holding the FIR kernel",
+							   G_TYPE_ARRAY,
+							   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, FILTER_PROP_SECTIONS,
+					g_param_spec_boxed("sections", "Sections",
+							   "Array of doubles holding six coefficients b0 b1 b2 a0 a1 a2 for each IIR section",
+							   G_TYPE_ARRAY,
+							   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, FILTER_PROP_METHOD,
+					g_param_spec_int("method", "Method",
+							 "How to apply the FIR kernel",
+							 FILTER_AUTO, FILTER_FFT,
+							 FILTER_AUTO,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void y_filter_operation_init(YFilterOperation * sop)
+{
+	g_assert(Y_IS_FILTER_OPERATION(sop));
+	sop->kernel = array_copy(NULL, 0);
+	sop->sections = array_copy(NULL, 0);
+	sop->method = FILTER_AUTO;
+}
+
+/**
+ * y_filter_operation_set_kernel:
+ * @op: a #YFilterOperation
+ * @kernel: (array length=n): the FIR kernel
+ * @n: number of taps
+ *
+ * Set the FIR kernel. With no taps, only the IIR sections are applied.
+ **/
+void y_filter_operation_set_kernel(YFilterOperation * op,
+				   const double *kernel, unsigned int n)
+{
+	g_return_if_fail(Y_IS_FILTER_OPERATION(op));
+	GArray *a = array_copy(kernel, n);
+	g_object_set(op, "kernel", a, NULL);
+	g_array_unref(a);
+}
+
+/**
+ * y_filter_operation_set_sections:
+ * @op: a #YFilterOperation
+ * @sections: (array length=n_sections): six coefficients b0 b1 b2 a0 a1 a2
+ * for each section
+ * @n_sections: number of sections
+ *
+ * Set the biquad sections of the IIR filter, which are applied in order
+ * after the FIR kernel.
+ **/
+void y_filter_operation_set_sections(YFilterOperation * op,
+				     const double *sections,
+				     unsigned int n_sections)
+{
+	g_return_if_fail(Y_IS_FILTER_OPERATION(op));
+	GArray *a = array_copy(sections, 6 * n_sections);
+	g_object_set(op, "sections", a, NULL);
+	g_array_unref(a);
+}
+
+/**
+ * y_filter_operation_new_fir:
+ * @kernel: (array length=n): the FIR kernel
+ * @n: number of taps
+ *
+ * Create a new FIR filter operation.
+ *
+ * Returns: a #YOperation
+ **/
+YOperation *y_filter_operation_new_fir(const double *kernel, unsigned int n)
+{
+	YOperation *o = g_object_new(Y_TYPE_FILTER_OPERATION, NULL);
+	y_filter_operation_set_kernel(Y_FILTER_OPERATION(o), kernel, n);
+	return o;
+}
+
+/**
+ * y_filter_operation_new_iir:
+ * @sections: (array length=n_sections): six coefficients b0 b1 b2 a0 a1 a2
+ * for each section
+ * @n_sections: number of sections
+ *
+ * Create a new IIR filter operation from a cascade of biquad sections.
+ *
+ * Returns: a #YOperation
+ **/
+YOperation *y_filter_operation_new_iir(const double *sections,
+				       unsigned int n_sections)
+{
+	YOperation *o = g_object_new(Y_TYPE_FILTER_OPERATION, NULL);
+	y_filter_operation_set_sections(Y_FILTER_OPERATION(o), sections,
+					n_sections);
+	return o;
+}
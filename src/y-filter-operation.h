@@ -0,0 +1,49 @@
+/*
+ * y-filter-operation.h :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef OP_FILTER_H
+#define OP_FILTER_H
+
+#include <y-data-class.h>
+#include <y-operation.h>
+#include <y-fft-util.h>
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE(YFilterOperation,y_filter_operation,Y,FILTER_OPERATION,YOperation)
+
+#define Y_TYPE_FILTER_OPERATION  (y_filter_operation_get_type ())
+
+/* how FIR kernels are applied */
+enum {
+	FILTER_AUTO = 0,
+	FILTER_DIRECT,
+	FILTER_FFT
+};
+
+YOperation *y_filter_operation_new_fir (const double *kernel, unsigned int n);
+YOperation *y_filter_operation_new_iir (const double *sections, unsigned int n_sections);
+void y_filter_operation_set_kernel (YFilterOperation *op, const double *kernel, unsigned int n);
+void y_filter_operation_set_sections (YFilterOperation *op, const double *sections, unsigned int n_sections);
+
+G_END_DECLS
+
+#endif
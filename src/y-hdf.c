@@ -31,8 +31,19 @@
  *
  * Utility functions for saving to and loading from HDF5 files.
  *
+ * The HDF5 library is usually built without thread safety, and its state is
+ * shared by all files in the process. The functions here take y_hdf5_lock()
+ * around their HDF5 calls, and so does #YSpill, which writes from a
+ * background thread. While any spill exists, HDF5 calls made directly by the
+ * caller, for instance on the handle from y_file_get_handle(), must either be
+ * made while holding y_hdf5_lock() or only after y_spill_flush() has been
+ * called on every spill that data is still being appended to. Don't call
+ * #YSpill functions while holding the lock.
+ *
  **/
 
+static GRecMutex hdf5_lock;
+
 struct _YFile {
 	GObject	 base;
 	hid_t handle;
@@ -45,7 +56,9 @@ static
 void y_file_finalize (GObject *obj)
 {
 	YFile *f = (YFile *) obj;
+	y_hdf5_lock();
 	H5Fclose(f->handle);
+	y_hdf5_unlock();
 }
 
 static
@@ -61,6 +74,26 @@ void y_file_init(YFile *file)
 
 }
 
+/**
+ * y_hdf5_lock:
+ *
+ * Take the lock that serializes use of the HDF5 library between threads.
+ **/
+void y_hdf5_lock(void)
+{
+	g_rec_mutex_lock(&hdf5_lock);
+}
+
+/**
+ * y_hdf5_unlock:
+ *
+ * Release the lock taken by y_hdf5_lock().
+ **/
+void y_hdf5_unlock(void)
+{
+	g_rec_mutex_unlock(&hdf5_lock);
+}
+
 /**
  * y_file_open_for_writing:
  * @filename: filename
@@ -83,8 +116,10 @@ YFile * y_file_open_for_writing(const gchar * filename, gboolean overwrite, GErr
 		if (!overwrite)
 			return 0;
 	}
+	y_hdf5_lock();
 	hid_t hfile =
 		H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+	y_hdf5_unlock();
 	YFile *f = g_object_new(Y_TYPE_FILE,NULL);
 	f->handle = hfile;
 	f->write = TRUE;
@@ -112,7 +147,9 @@ YFile * y_file_open_for_reading(const gchar *filename, GError **err)
                     "file not found: %s", filename);
 		return 0;
 	}
+	y_hdf5_lock();
 	hid_t hfile = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+	y_hdf5_unlock();
 	YFile *f = g_object_new(Y_TYPE_FILE,NULL);
 	f->handle = hfile;
 	f->write = FALSE;
@@ -140,7 +177,11 @@ hid_t y_file_get_handle(YFile *f)
 hid_t y_hdf5_create_group(hid_t id, const gchar * name)
 {
 	g_assert(id != 0);
-	return H5Gcreate(id, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	y_hdf5_lock();
+	hid_t group_id = H5Gcreate(id, name, H5P_DEFAULT, H5P_DEFAULT,
+				   H5P_DEFAULT);
+	y_hdf5_unlock();
+	return group_id;
 }
 
 /**
@@ -161,7 +202,10 @@ void y_vector_attach_h5(YVector * v, hid_t group_id, const gchar * data_name)
 		g_warning("skipping HDF5 save due to zero length vector");
 		return;
 	}
+	/* before taking the lock, as loading may read from a spill */
+	const double *data = y_vector_get_values(v);
 
+	y_hdf5_lock();
 	hid_t dataspace_id = H5Screate_simple(1, dims, NULL);
 	hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
 
@@ -171,7 +215,6 @@ void y_vector_attach_h5(YVector * v, hid_t group_id, const gchar * data_name)
 	hid_t id =
 	    H5Dcreate2(group_id, data_name, H5T_NATIVE_DOUBLE, dataspace_id,
 		       H5P_DEFAULT, plist_id, H5P_DEFAULT);
-	const double *data = y_vector_get_values(v);
 	H5Dwrite(id, H5T_NATIVE_DOUBLE, dataspace_id, dataspace_id, H5P_DEFAULT,
 		 data);
 
@@ -179,6 +222,7 @@ void y_vector_attach_h5(YVector * v, hid_t group_id, const gchar * data_name)
 
 	H5Pclose(plist_id);
 	H5Dclose(id);
+	y_hdf5_unlock();
 }
 
 /**
@@ -204,7 +248,9 @@ void y_vector_attach_attr_h5(YVector * v, hid_t group_id,
 		return;
 	}
 
+	y_hdf5_lock();
 	H5LTset_attribute_double(group_id, obj_name, attr_name, d, l);
+	y_hdf5_unlock();
 }
 
 /**
@@ -220,7 +266,9 @@ void y_matrix_attach_h5(YMatrix * m, hid_t group_id, const gchar * data_name)
 	g_return_if_fail(Y_IS_MATRIX(m));
 	g_return_if_fail(group_id != 0);
 	hsize_t dims[2] = { y_matrix_get_rows(m), y_matrix_get_columns(m) };
+	const double *data = y_matrix_get_values(m);
 
+	y_hdf5_lock();
 	hid_t dataspace_id = H5Screate_simple(2, dims, NULL);
 	hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
 
@@ -231,12 +279,13 @@ void y_matrix_attach_h5(YMatrix * m, hid_t group_id, const gchar * data_name)
 	    H5Dcreate2(group_id, data_name, H5T_NATIVE_DOUBLE, dataspace_id,
 		       H5P_DEFAULT, plist_id, H5P_DEFAULT);
 	H5Dwrite(id, H5T_NATIVE_DOUBLE, dataspace_id, dataspace_id, H5P_DEFAULT,
-		 y_matrix_get_values(m));
+		 data);
 
 	H5Sclose(dataspace_id);
 
 	H5Pclose(plist_id);
 	H5Dclose(id);
+	y_hdf5_unlock();
 }
 
 static
@@ -280,14 +329,15 @@ void y_data_attach_h5(YData * d, hid_t group_id, const gchar * data_name)
 	switch (n) {
 	case -1:
 		if (data_name)
-			subgroup_id =
-			    H5Gcreate(group_id, data_name, H5P_DEFAULT,
-				      H5P_DEFAULT, H5P_DEFAULT);
+			subgroup_id = y_hdf5_create_group(group_id, data_name);
 		else
 			subgroup_id = group_id;
 		y_struct_foreach(Y_STRUCT(d), save_func, &subgroup_id);
-		if (data_name != NULL)
+		if (data_name != NULL) {
+			y_hdf5_lock();
 			H5Gclose(subgroup_id);
+			y_hdf5_unlock();
+		}
 		break;
 	case 0:
 		g_warning("scalar save to h5 not implemented");
@@ -316,12 +366,15 @@ void y_data_attach_h5(YData * d, hid_t group_id, const gchar * data_name)
 YData *y_vector_from_h5(hid_t group_id, const gchar * data_name)
 {
 	g_return_val_if_fail(group_id != 0, NULL);
+	y_hdf5_lock();
 	htri_t exists = H5Lexists(group_id, data_name, H5P_DEFAULT);
 	if (exists == 0) {
+		y_hdf5_unlock();
 		return NULL;
 	}
 	hid_t dataset_h5 = H5Dopen(group_id, data_name, H5P_DEFAULT);
 	if (dataset_h5 < 0) {
+		y_hdf5_unlock();
 		return NULL;
 	}
 	hid_t dspace_id = H5Dget_space(dataset_h5);
@@ -337,6 +390,7 @@ YData *y_vector_from_h5(hid_t group_id, const gchar * data_name)
 	double *d = g_new(double, current_dims[0]);
 	H5Dread(dataset_h5, H5T_NATIVE_DOUBLE, H5S_ALL, dspace_id, H5P_DEFAULT,
 		d);
+	y_hdf5_unlock();
 	YData *y = y_val_vector_new(d, current_dims[0], g_free);
 	return y;
 }
@@ -353,12 +407,15 @@ YData *y_vector_from_h5(hid_t group_id, const gchar * data_name)
 YData *y_matrix_from_h5(hid_t group_id, const gchar * data_name)
 {
 	g_return_val_if_fail(group_id != 0, NULL);
+	y_hdf5_lock();
 	htri_t exists = H5Lexists(group_id, data_name, H5P_DEFAULT);
 	if (exists == 0) {
+		y_hdf5_unlock();
 		return NULL;
 	}
 	hid_t dataset_h5 = H5Dopen(group_id, data_name, H5P_DEFAULT);
 	if (dataset_h5 < 0) {
+		y_hdf5_unlock();
 		return NULL;
 	}
 	hid_t dspace_id = H5Dget_space(dataset_h5);
@@ -375,6 +432,7 @@ YData *y_matrix_from_h5(hid_t group_id, const gchar * data_name)
 	double *d = g_new(double, current_dims[0] * current_dims[1]);
 	H5Dread(dataset_h5, H5T_NATIVE_DOUBLE, H5S_ALL, dspace_id, H5P_DEFAULT,
 		d);
+	y_hdf5_unlock();
 	YData *y =
 	    y_val_matrix_new(d, current_dims[0], current_dims[1], g_free);
 	return y;
@@ -392,8 +450,10 @@ void y_val_vector_replace_h5(YValVector * v, hid_t group_id,
 			     const gchar * data_name)
 {
 	g_return_if_fail(group_id != 0);
+	y_hdf5_lock();
 	htri_t exists = H5Lexists(group_id, data_name, H5P_DEFAULT);
 	if (exists == 0) {
+		y_hdf5_unlock();
 		g_warning("H5 dataset doesn't exist");
 		return;
 	}
@@ -411,5 +471,6 @@ void y_val_vector_replace_h5(YValVector * v, hid_t group_id,
 	double *d = g_new(double, current_dims[0]);
 	H5Dread(dataset_h5, H5T_NATIVE_DOUBLE, H5S_ALL, dspace_id, H5P_DEFAULT,
 		d);
+	y_hdf5_unlock();
 	y_val_vector_replace_array(v, d, current_dims[0], g_free);
 }
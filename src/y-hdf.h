@@ -38,6 +38,8 @@ YFile * y_file_open_for_reading(const gchar *filename, GError **err);
 hid_t y_file_get_handle(YFile *f);
 void y_file_attach_data(YFile *f, const gchar *data_name, YData *d);
 
+void y_hdf5_lock(void);
+void y_hdf5_unlock(void);
 hid_t y_hdf5_create_group(hid_t id, const gchar *name);
 #define y_hdf5_close_group(id) H5Gclose(id);
 
@@ -0,0 +1,502 @@
+/*
+ * y-history.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <string.h>
+#include <math.h>
+#include "y-history.h"
+
+/**
+ * SECTION: y-history
+ * @short_description: Compressed store of timestamped samples.
+ *
+ * A #YHistory keeps a long record of (timestamp, value) samples in a
+ * fraction of the 16 bytes per sample they would take as pairs of doubles.
+ * It is meant to sit behind a #YRingVector, set with
+ * y_ring_vector_set_history(), and receive the samples that the ring
+ * throws away, so that the ring holds recent data for plotting and the
+ * history holds hours or days of slow-control data.
+ *
+ * Samples are compressed as in Facebook's Gorilla time series store.
+ * Timestamps are stored to the nearest microsecond as the difference
+ * between successive intervals, which is zero or small for regular
+ * sampling. Each value is stored as its XOR with the previous one, keeping
+ * only the bits between the leading and trailing zeros. Samples are
+ * grouped into blocks of 512, each with its time range, and
+ * y_history_get_range() only decompresses the blocks that overlap the
+ * requested times. Timestamps should not decrease.
+ *
+ * If "max-age" is positive, blocks whose samples are all older than that
+ * many seconds before the newest sample are discarded.
+ */
+
+#define Y_HISTORY_BLOCK 512
+
+enum {
+	HISTORY_PROP_0,
+	HISTORY_PROP_MAX_AGE,
+	N_PROPERTIES
+};
+
+typedef struct {
+	gint64 t0;		/* first timestamp, in microseconds */
+	double v0;		/* first value */
+	double tmin, tmax;
+	unsigned int count;
+	guint64 *words;		/* compressed samples after the first */
+	gsize nbits;
+	gsize nwords;
+} HistoryBlock;
+
+struct _YHistory {
+	GObject base;
+	double max_age;
+	HistoryBlock *blocks;
+	unsigned int n_blocks;
+	unsigned int blocks_size;
+	guint64 len;
+	/* encoder state for the last block */
+	gint64 prev_t;
+	gint64 prev_delta;
+	guint64 prev_v;
+	unsigned int prev_lead;
+	unsigned int prev_trail;
+};
+
+G_DEFINE_TYPE(YHistory, y_history, G_TYPE_OBJECT);
+
+static inline guint64 double_bits(double v)
+{
+	guint64 b;
+	memcpy(&b, &v, sizeof(b));
+	return b;
+}
+
+static inline double bits_double(guint64 b)
+{
+	double v;
+	memcpy(&v, &b, sizeof(v));
+	return v;
+}
+
+static inline unsigned int leading_zeros(guint64 x)
+{
+#ifdef __GNUC__
+	return __builtin_clzll(x);
+#else
+	unsigned int n = 0;
+	while (!(x & G_GUINT64_CONSTANT(0x8000000000000000))) {
+		x <<= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+static inline unsigned int trailing_zeros(guint64 x)
+{
+#ifdef __GNUC__
+	return __builtin_ctzll(x);
+#else
+	unsigned int n = 0;
+	while (!(x & 1)) {
+		x >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+/* append the low nbits of v, most significant first */
+static void block_put_bits(HistoryBlock * b, guint64 v, unsigned int nbits)
+{
+	if (nbits == 0)
+		return;
+	gsize need = (b->nbits + nbits + 63) / 64;
+	if (need > b->nwords) {
+		gsize size = MAX(need, 2 * b->nwords);
+		b->words = g_renew(guint64, b->words, size);
+		memset(b->words + b->nwords, 0,
+		       (size - b->nwords) * sizeof(guint64));
+		b->nwords = size;
+	}
+	if (nbits < 64)
+		v &= (G_GUINT64_CONSTANT(1) << nbits) - 1;
+	gsize i = b->nbits / 64;
+	unsigned int free = 64 - b->nbits % 64;
+	if (nbits <= free) {
+		b->words[i] |= v << (free - nbits);
+	} else {
+		b->words[i] |= v >> (nbits - free);
+		b->words[i + 1] |= v << (64 - (nbits - free));
+	}
+	b->nbits += nbits;
+}
+
+typedef struct {
+	const guint64 *words;
+	gsize pos;
+} BitReader;
+
+static guint64 reader_get_bits(BitReader * r, unsigned int nbits)
+{
+	if (nbits == 0)
+		return 0;
+	gsize i = r->pos / 64;
+	unsigned int avail = 64 - r->pos % 64;
+	guint64 v;
+	if (nbits <= avail) {
+		v = r->words[i] >> (avail - nbits);
+	} else {
+		v = r->words[i] << (nbits - avail);
+		v |= r->words[i + 1] >> (64 - (nbits - avail));
+	}
+	r->pos += nbits;
+	if (nbits < 64)
+		v &= (G_GUINT64_CONSTANT(1) << nbits) - 1;
+	return v;
+}
+
+static void history_encode(YHistory * h, HistoryBlock * b, gint64 t, double v)
+{
+	/* timestamp: delta of delta */
+	gint64 delta = t - h->prev_t;
+	gint64 dod = delta - h->prev_delta;
+	if (dod == 0) {
+		block_put_bits(b, 0, 1);
+	} else if (dod >= -63 && dod <= 64) {
+		block_put_bits(b, 2, 2);
+		block_put_bits(b, dod + 63, 7);
+	} else if (dod >= -255 && dod <= 256) {
+		block_put_bits(b, 6, 3);
+		block_put_bits(b, dod + 255, 9);
+	} else if (dod >= -2047 && dod <= 2048) {
+		block_put_bits(b, 14, 4);
+		block_put_bits(b, dod + 2047, 12);
+	} else {
+		block_put_bits(b, 15, 4);
+		block_put_bits(b, (guint64) dod, 64);
+	}
+	h->prev_delta = delta;
+	h->prev_t = t;
+
+	/* value: XOR with the previous value */
+	guint64 bits = double_bits(v);
+	guint64 x = bits ^ h->prev_v;
+	h->prev_v = bits;
+	if (x == 0) {
+		block_put_bits(b, 0, 1);
+		return;
+	}
+	unsigned int lead = MIN(leading_zeros(x), 31);
+	unsigned int trail = trailing_zeros(x);
+	if (h->prev_lead + h->prev_trail < 64 && lead >= h->prev_lead
+	    && trail >= h->prev_trail) {
+		/* fits in the previous meaningful bits */
+		block_put_bits(b, 2, 2);
+		block_put_bits(b, x >> h->prev_trail,
+			       64 - h->prev_lead - h->prev_trail);
+	} else {
+		unsigned int sig = 64 - lead - trail;
+		block_put_bits(b, 3, 2);
+		block_put_bits(b, lead, 5);
+		block_put_bits(b, sig & 63, 6);
+		block_put_bits(b, x >> trail, sig);
+		h->prev_lead = lead;
+		h->prev_trail = trail;
+	}
+}
+
+/* decode all samples of a block */
+static void history_decode(const HistoryBlock * b, double *times,
+			   double *values)
+{
+	BitReader r = { b->words, 0 };
+	gint64 t = b->t0;
+	gint64 delta = 0;
+	guint64 bits = double_bits(b->v0);
+	unsigned int lead = 0, trail = 0;
+	unsigned int i;
+	times[0] = t / 1e6;
+	values[0] = b->v0;
+	for (i = 1; i < b->count; i++) {
+		gint64 dod;
+		if (reader_get_bits(&r, 1) == 0) {
+			dod = 0;
+		} else if (reader_get_bits(&r, 1) == 0) {
+			dod = (gint64) reader_get_bits(&r, 7) - 63;
+		} else if (reader_get_bits(&r, 1) == 0) {
+			dod = (gint64) reader_get_bits(&r, 9) - 255;
+		} else if (reader_get_bits(&r, 1) == 0) {
+			dod = (gint64) reader_get_bits(&r, 12) - 2047;
+		} else {
+			dod = (gint64) reader_get_bits(&r, 64);
+		}
+		delta += dod;
+		t += delta;
+		times[i] = t / 1e6;
+
+		if (reader_get_bits(&r, 1) == 1) {
+			if (reader_get_bits(&r, 1) == 1) {
+				lead = reader_get_bits(&r, 5);
+				unsigned int sig = reader_get_bits(&r, 6);
+				if (sig == 0)
+					sig = 64;
+				trail = 64 - lead - sig;
+			}
+			bits ^= reader_get_bits(&r, 64 - lead - trail) << trail;
+		}
+		values[i] = bits_double(bits);
+	}
+}
+
+static void history_drop_old(YHistory * h)
+{
+	if (h->max_age <= 0.0 || h->n_blocks < 2)
+		return;
+	double newest = h->blocks[h->n_blocks - 1].tmax;
+	unsigned int k = 0;
+	/* the last block is still being written, so it is always kept */
+	while (k + 1 < h->n_blocks && h->blocks[k].tmax < newest - h->max_age) {
+		h->len -= h->blocks[k].count;
+		g_free(h->blocks[k].words);
+		k++;
+	}
+	if (k > 0) {
+		memmove(h->blocks, h->blocks + k,
+			(h->n_blocks - k) * sizeof(HistoryBlock));
+		h->n_blocks -= k;
+	}
+}
+
+/**
+ * y_history_append :
+ * @h: #YHistory
+ * @t: timestamp in seconds
+ * @v: value
+ *
+ * Add a sample to the history. Its timestamp should not be earlier than
+ * that of the previous sample.
+ **/
+void y_history_append(YHistory * h, double t, double v)
+{
+	g_return_if_fail(Y_IS_HISTORY(h));
+	gint64 tus = llround(t * 1e6);
+	HistoryBlock *b = h->n_blocks ? &h->blocks[h->n_blocks - 1] : NULL;
+	if (b == NULL || b->count == Y_HISTORY_BLOCK) {
+		if (b) {
+			/* trim the finished block */
+			b->nwords = (b->nbits + 63) / 64;
+			b->words = g_renew(guint64, b->words, b->nwords);
+		}
+		if (h->n_blocks == h->blocks_size) {
+			h->blocks_size = MAX(16, 2 * h->blocks_size);
+			h->blocks = g_renew(HistoryBlock, h->blocks, h->blocks_size);
+		}
+		b = &h->blocks[h->n_blocks++];
+		memset(b, 0, sizeof(HistoryBlock));
+		b->t0 = tus;
+		b->v0 = v;
+		b->tmin = b->tmax = tus / 1e6;
+		b->count = 1;
+		h->prev_t = tus;
+		h->prev_delta = 0;
+		h->prev_v = double_bits(v);
+		h->prev_lead = 64;
+		h->prev_trail = 0;
+		h->len++;
+		history_drop_old(h);
+		return;
+	}
+	history_encode(h, b, tus, v);
+	b->tmin = MIN(b->tmin, tus / 1e6);
+	b->tmax = MAX(b->tmax, tus / 1e6);
+	b->count++;
+	h->len++;
+}
+
+/**
+ * y_history_get_len :
+ * @h: #YHistory
+ *
+ * Get the number of samples in the history.
+ *
+ * Returns: the number of samples
+ **/
+guint64 y_history_get_len(YHistory * h)
+{
+	g_return_val_if_fail(Y_IS_HISTORY(h), 0);
+	return h->len;
+}
+
+/**
+ * y_history_get_size :
+ * @h: #YHistory
+ *
+ * Get the memory used to store the samples, in bytes.
+ *
+ * Returns: the size in bytes
+ **/
+gsize y_history_get_size(YHistory * h)
+{
+	g_return_val_if_fail(Y_IS_HISTORY(h), 0);
+	gsize size = h->blocks_size * sizeof(HistoryBlock);
+	unsigned int k;
+	for (k = 0; k < h->n_blocks; k++) {
+		size += h->blocks[k].nwords * sizeof(guint64);
+	}
+	return size;
+}
+
+/**
+ * y_history_get_range :
+ * @h: #YHistory
+ * @start: earliest timestamp
+ * @end: latest timestamp
+ * @times: (out) (array length=return) (transfer full): timestamps
+ * @values: (out) (array length=return) (transfer full): values
+ *
+ * Get the samples with timestamps between @start and @end, inclusive.
+ * Only the blocks that overlap that range are decompressed.
+ *
+ * Returns: the number of samples
+ **/
+unsigned int y_history_get_range(YHistory * h, double start, double end,
+				 double **times, double **values)
+{
+	g_return_val_if_fail(Y_IS_HISTORY(h), 0);
+	g_return_val_if_fail(times != NULL && values != NULL, 0);
+
+	/* first block that ends at or after start */
+	unsigned int lo = 0, hi = h->n_blocks;
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		if (h->blocks[mid].tmax < start)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	unsigned int k, last = lo;
+	gsize total = 0;
+	while (last < h->n_blocks && h->blocks[last].tmin <= end) {
+		total += h->blocks[last].count;
+		last++;
+	}
+
+	*times = g_new(double, MAX(total, 1));
+	*values = g_new(double, MAX(total, 1));
+	double *bt = g_new(double, Y_HISTORY_BLOCK);
+	double *bv = g_new(double, Y_HISTORY_BLOCK);
+	unsigned int n = 0;
+	for (k = lo; k < last; k++) {
+		const HistoryBlock *b = &h->blocks[k];
+		unsigned int i;
+		history_decode(b, bt, bv);
+		for (i = 0; i < b->count; i++) {
+			if (bt[i] >= start && bt[i] <= end) {
+				(*times)[n] = bt[i];
+				(*values)[n] = bv[i];
+				n++;
+			}
+		}
+	}
+	g_free(bt);
+	g_free(bv);
+	return n;
+}
+
+static void y_history_finalize(GObject * obj)
+{
+	YHistory *h = (YHistory *) obj;
+	unsigned int k;
+	for (k = 0; k < h->n_blocks; k++) {
+		g_free(h->blocks[k].words);
+	}
+	g_free(h->blocks);
+
+	GObjectClass *obj_class = G_OBJECT_CLASS(y_history_parent_class);
+
+	(*obj_class->finalize) (obj);
+}
+
+static void
+y_history_set_property(GObject * gobject, guint param_id,
+		       GValue const *value, GParamSpec * pspec)
+{
+	YHistory *h = Y_HISTORY(gobject);
+
+	switch (param_id) {
+	case HISTORY_PROP_MAX_AGE:
+		h->max_age = g_value_get_double(value);
+		history_drop_old(h);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void
+y_history_get_property(GObject * gobject, guint param_id,
+		       GValue * value, GParamSpec * pspec)
+{
+	YHistory *h = Y_HISTORY(gobject);
+
+	switch (param_id) {
+	case HISTORY_PROP_MAX_AGE:
+		g_value_set_double(value, h->max_age);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void y_history_class_init(YHistoryClass * klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->finalize = y_history_finalize;
+	gobject_klass->set_property = y_history_set_property;
+	gobject_klass->get_property = y_history_get_property;
+
+	g_object_class_install_property(gobject_klass, HISTORY_PROP_MAX_AGE,
+					g_param_spec_double("max-age", "Maximum age",
+							    "Age in seconds after which samples are discarded, or 0 to keep them",
+							    0.0, G_MAXDOUBLE, 0.0,
+							    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void y_history_init(YHistory * h)
+{
+}
+
+/**
+ * y_history_new:
+ * @max_age: age in seconds after which samples are discarded, or 0 to
+ * keep them
+ *
+ * Create a new, empty history.
+ *
+ * Returns: a #YHistory
+ **/
+YHistory *y_history_new(double max_age)
+{
+	return g_object_new(Y_TYPE_HISTORY, "max-age", max_age, NULL);
+}
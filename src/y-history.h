@@ -0,0 +1,41 @@
+/*
+ * y-history.h :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef Y_HISTORY_H
+#define Y_HISTORY_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE(YHistory,y_history,Y,HISTORY,GObject)
+
+#define Y_TYPE_HISTORY  (y_history_get_type ())
+
+YHistory *y_history_new (double max_age);
+void y_history_append (YHistory *h, double t, double v);
+guint64 y_history_get_len (YHistory *h);
+gsize y_history_get_size (YHistory *h);
+unsigned int y_history_get_range (YHistory *h, double start, double end, double **times, double **values);
+
+G_END_DECLS
+
+#endif
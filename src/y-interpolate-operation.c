@@ -0,0 +1,498 @@
+/*
+ * y-interpolate-operation.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <memory.h>
+#include <math.h>
+#include "y-interpolate-operation.h"
+#include "y-linear-range.h"
+
+/**
+ * SECTION: y-interpolate-operation
+ * @short_description: Operation that resamples a vector onto a new axis.
+ *
+ * This operation takes a vector of values y, sampled at the points of the
+ * vector "x", and interpolates it onto the points of the vector "target",
+ * for example a uniform grid or the x axis of another data set. If "x" is
+ * %NULL, the values are taken to be sampled at their indices. The output has
+ * one element for each element of "target"; targets outside the range of
+ * "x" give NaN.
+ *
+ * The points of "x" must increase or decrease. %INTERPOLATE_LINEAR joins
+ * neighboring samples with straight lines, %INTERPOLATE_NEAREST takes the
+ * nearest sample, and %INTERPOLATE_CUBIC uses a natural cubic spline. The
+ * spline coefficients are kept in the task data and recomputed only when y
+ * or "x" emits "changed".
+ *
+ * If the targets increase or decrease, they are located with a single sweep
+ * through "x"; otherwise each is located by binary search. When "x" or
+ * "target" is a #YLinearRangeVector, its values are computed from its
+ * parameters rather than copied, and points are located in "x" directly.
+ */
+
+enum {
+	INTERPOLATE_PROP_0,
+	INTERPOLATE_PROP_X,
+	INTERPOLATE_PROP_TARGET,
+	INTERPOLATE_PROP_METHOD,
+	N_PROPERTIES
+};
+
+struct _YInterpolateOperation {
+	YOperation base;
+	YVector *x;
+	YVector *target;
+	gulong x_handler;
+	gulong target_handler;
+	int method;
+};
+
+G_DEFINE_TYPE(YInterpolateOperation, y_interpolate_operation,
+	      Y_TYPE_OPERATION);
+
+static void on_x_changed(YData * data, gpointer user_data)
+{
+	g_object_notify(G_OBJECT(user_data), "x");
+}
+
+static void on_target_changed(YData * data, gpointer user_data)
+{
+	g_object_notify(G_OBJECT(user_data), "target");
+}
+
+static void interpolate_set_vector(YInterpolateOperation * sop,
+				   YVector ** slot, gulong * handler,
+				   YVector * vec, GCallback cb)
+{
+	if (*slot == vec)
+		return;
+	if (*slot) {
+		g_signal_handler_disconnect(*slot, *handler);
+		g_object_unref(*slot);
+		*handler = 0;
+	}
+	*slot = vec;
+	if (vec) {
+		g_object_ref_sink(vec);
+		*handler = g_signal_connect(vec, "changed", cb, sop);
+	}
+}
+
+static void
+y_interpolate_operation_set_property(GObject * gobject, guint param_id,
+				     GValue const *value, GParamSpec * pspec)
+{
+	YInterpolateOperation *sop = Y_INTERPOLATE_OPERATION(gobject);
+
+	switch (param_id) {
+	case INTERPOLATE_PROP_X:
+		interpolate_set_vector(sop, &sop->x, &sop->x_handler,
+				       g_value_get_object(value),
+				       G_CALLBACK(on_x_changed));
+		break;
+	case INTERPOLATE_PROP_TARGET:
+		interpolate_set_vector(sop, &sop->target,
+				       &sop->target_handler,
+				       g_value_get_object(value),
+				       G_CALLBACK(on_target_changed));
+		break;
+	case INTERPOLATE_PROP_METHOD:
+		sop->method = g_value_get_int(value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void
+y_interpolate_operation_get_property(GObject * gobject, guint param_id,
+				     GValue * value, GParamSpec * pspec)
+{
+	YInterpolateOperation *sop = Y_INTERPOLATE_OPERATION(gobject);
+
+	switch (param_id) {
+	case INTERPOLATE_PROP_X:
+		g_value_set_object(value, sop->x);
+		break;
+	case INTERPOLATE_PROP_TARGET:
+		g_value_set_object(value, sop->target);
+		break;
+	case INTERPOLATE_PROP_METHOD:
+		g_value_set_int(value, sop->method);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void y_interpolate_operation_dispose(GObject * obj)
+{
+	YInterpolateOperation *sop = Y_INTERPOLATE_OPERATION(obj);
+	interpolate_set_vector(sop, &sop->x, &sop->x_handler, NULL, NULL);
+	interpolate_set_vector(sop, &sop->target, &sop->target_handler, NULL,
+			       NULL);
+	G_OBJECT_CLASS(y_interpolate_operation_parent_class)->dispose(obj);
+}
+
+static
+int interpolate_size(YOperation * op, YData * input, unsigned int *dims)
+{
+	YInterpolateOperation *sop = Y_INTERPOLATE_OPERATION(op);
+	g_assert(dims);
+	g_assert(Y_IS_VECTOR(input));
+	dims[0] = sop->target ? y_vector_get_len(sop->target) : 0;
+	return 1;
+}
+
+typedef struct {
+	YInterpolateOperation sop;	/* x and target are not valid in the copy */
+	/* the inputs the samples were copied from, and their generations */
+	YData *yref;
+	guint64 ygen;
+	YVector *xref;
+	guint64 xgen;
+	/* samples, sorted so x increases; if x_linear, x[i] = x0 + i*dx */
+	unsigned int n;
+	double *x;
+	double *y;
+	gboolean x_linear;
+	double x0, dx;
+	gboolean x_ok;
+	/* spline second derivatives */
+	double *m2;
+	gboolean spline_valid;
+	/* targets; if t_linear, t[i] = t0 + i*dt */
+	unsigned int nt;
+	double *t;
+	unsigned int t_size;
+	gboolean t_linear;
+	double t0, dt;
+	int t_dir;
+	double *output;
+	unsigned int output_size;
+} InterpolateOpData;
+
+/* direction of a vector: 1 if increasing, -1 if decreasing, 0 otherwise */
+static int interpolate_direction(YVector * vec)
+{
+	unsigned int n = y_vector_get_len(vec);
+	if (n < 2)
+		return 1;
+	if (!y_vector_is_varying_uniformly(vec))
+		return 0;
+	return y_vector_get_value(vec, n - 1) > y_vector_get_value(vec, 0) ?
+	    1 : -1;
+}
+
+static void interpolate_load_samples(InterpolateOpData * d, YData * input,
+				     YVector * xvec)
+{
+	unsigned int ny = y_vector_get_len(Y_VECTOR(input));
+	unsigned int i;
+	int dir = 1;
+	d->n = xvec ? MIN(ny, y_vector_get_len(xvec)) : ny;
+	d->x = g_renew(double, d->x, MAX(d->n, 1));
+	d->y = g_renew(double, d->y, MAX(d->n, 1));
+	d->m2 = g_renew(double, d->m2, MAX(d->n, 1));
+	d->spline_valid = FALSE;
+	y_vector_get_values_range(Y_VECTOR(input), 0, d->n, d->y);
+
+	d->x_ok = TRUE;
+	if (xvec == NULL) {
+		d->x_linear = TRUE;
+		d->x0 = 0.0;
+		d->dx = 1.0;
+	} else if (Y_IS_LINEAR_RANGE_VECTOR(xvec)) {
+		YLinearRangeVector *r = Y_LINEAR_RANGE_VECTOR(xvec);
+		d->x_linear = TRUE;
+		d->x0 = y_linear_range_vector_get_v0(r);
+		d->dx = y_linear_range_vector_get_dv(r);
+		if (d->dx < 0.0) {
+			d->x0 += (d->n - 1) * d->dx;
+			d->dx = -d->dx;
+			dir = -1;
+		}
+		d->x_ok = d->dx > 0.0 || d->n < 2;
+	} else {
+		d->x_linear = FALSE;
+		dir = interpolate_direction(xvec);
+		d->x_ok = dir != 0;
+		y_vector_get_values_range(xvec, 0, d->n, d->x);
+	}
+	if (dir < 0) {
+		/* sort so that x increases */
+		for (i = 0; i < d->n / 2; i++) {
+			unsigned int k = d->n - 1 - i;
+			double tmp = d->y[i];
+			d->y[i] = d->y[k];
+			d->y[k] = tmp;
+			tmp = d->x[i];
+			d->x[i] = d->x[k];
+			d->x[k] = tmp;
+		}
+	}
+	if (d->x_linear) {
+		for (i = 0; i < d->n; i++) {
+			d->x[i] = d->x0 + i * d->dx;
+		}
+	}
+}
+
+static
+gpointer interpolate_op_create_data(YOperation * op, gpointer data,
+				    YData * input)
+{
+	if (input == NULL)
+		return NULL;
+	InterpolateOpData *d;
+	YInterpolateOperation *sop = Y_INTERPOLATE_OPERATION(op);
+	if (data == NULL) {
+		d = g_new0(InterpolateOpData, 1);
+	} else {
+		d = (InterpolateOpData *) data;
+	}
+	d->sop = *sop;
+	d->sop.x = NULL;
+	d->sop.target = NULL;
+
+	/* samples and spline are kept until y or x changes */
+	guint64 ygen = y_data_get_generation(input);
+	guint64 xgen = sop->x ? y_data_get_generation(Y_DATA(sop->x)) : 0;
+	if (d->yref != input || d->ygen != ygen || d->xref != sop->x
+	    || d->xgen != xgen || d->x == NULL) {
+		if (d->yref != input) {
+			g_clear_object(&d->yref);
+			d->yref = g_object_ref(input);
+		}
+		if (d->xref != sop->x) {
+			g_clear_object(&d->xref);
+			d->xref = sop->x ? g_object_ref(sop->x) : NULL;
+		}
+		d->ygen = ygen;
+		d->xgen = xgen;
+		interpolate_load_samples(d, input, sop->x);
+	}
+
+	d->nt = 0;
+	if (sop->target) {
+		YVector *t = sop->target;
+		d->nt = y_vector_get_len(t);
+		if (Y_IS_LINEAR_RANGE_VECTOR(t)) {
+			d->t_linear = TRUE;
+			d->t0 = y_linear_range_vector_get_v0(Y_LINEAR_RANGE_VECTOR(t));
+			d->dt = y_linear_range_vector_get_dv(Y_LINEAR_RANGE_VECTOR(t));
+			d->t_dir = d->dt < 0.0 ? -1 : 1;
+		} else {
+			d->t_linear = FALSE;
+			d->t_dir = interpolate_direction(t);
+			if (d->nt > d->t_size) {
+				d->t_size = d->nt;
+				d->t = g_renew(double, d->t, d->t_size);
+			}
+			y_vector_get_values_range(t, 0, d->nt, d->t);
+		}
+	}
+	if (d->nt > d->output_size) {
+		d->output_size = d->nt;
+		d->output = g_renew(double, d->output, d->output_size);
+	}
+	return d;
+}
+
+static
+void interpolate_op_data_free(gpointer data)
+{
+	InterpolateOpData *d = (InterpolateOpData *) data;
+	g_clear_object(&d->yref);
+	g_clear_object(&d->xref);
+	g_free(d->x);
+	g_free(d->y);
+	g_free(d->m2);
+	g_free(d->t);
+	g_free(d->output);
+	g_free(d);
+}
+
+/* second derivatives of the natural cubic spline through the samples */
+static void interpolate_spline(InterpolateOpData * d)
+{
+	const double *x = d->x;
+	const double *y = d->y;
+	double *m = d->m2;
+	unsigned int n = d->n;
+	unsigned int i;
+	double *u = g_new(double, n);
+	m[0] = u[0] = 0.0;
+	for (i = 1; i + 1 < n; i++) {
+		double sig = (x[i] - x[i - 1]) / (x[i + 1] - x[i - 1]);
+		double p = sig * m[i - 1] + 2.0;
+		m[i] = (sig - 1.0) / p;
+		u[i] = (y[i + 1] - y[i]) / (x[i + 1] - x[i])
+		    - (y[i] - y[i - 1]) / (x[i] - x[i - 1]);
+		u[i] = (6.0 * u[i] / (x[i + 1] - x[i - 1]) - sig * u[i - 1]) / p;
+	}
+	m[n - 1] = 0.0;
+	for (i = n - 1; i-- > 0;) {
+		m[i] = m[i] * m[i + 1] + u[i];
+	}
+	g_free(u);
+	d->spline_valid = TRUE;
+}
+
+/* value at t, which lies in [x[j], x[j+1]] */
+static double interpolate_eval(const InterpolateOpData * d, unsigned int j,
+			       double t)
+{
+	const double *x = d->x;
+	const double *y = d->y;
+	double h = x[j + 1] - x[j];
+	double b = (t - x[j]) / h;
+	double a = 1.0 - b;
+	switch (d->sop.method) {
+	case INTERPOLATE_NEAREST:
+		return b <= 0.5 ? y[j] : y[j + 1];
+	case INTERPOLATE_CUBIC:
+		return a * y[j] + b * y[j + 1]
+		    + ((a * a * a - a) * d->m2[j]
+		       + (b * b * b - b) * d->m2[j + 1]) * h * h / 6.0;
+	default:
+		return a * y[j] + b * y[j + 1];
+	}
+}
+
+/* index j of the interval [x[j], x[j+1]] holding t, by binary search */
+static unsigned int interpolate_search(const InterpolateOpData * d, double t)
+{
+	unsigned int lo = 0, hi = d->n - 1;
+	while (hi - lo > 1) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		if (d->x[mid] <= t)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static
+gpointer interpolate_op(gpointer input)
+{
+	InterpolateOpData *d = (InterpolateOpData *) input;
+
+	if (d == NULL || d->nt == 0)
+		return NULL;
+
+	unsigned int n = d->n;
+	unsigned int k;
+	if (n < 2 || !d->x_ok) {
+		for (k = 0; k < d->nt; k++) {
+			double t = d->t_linear ? d->t0 + k * d->dt : d->t[k];
+			d->output[k] = (n == 1 && t == d->x[0]) ? d->y[0] : NAN;
+		}
+		return d->output;
+	}
+	if (d->sop.method == INTERPOLATE_CUBIC && !d->spline_valid) {
+		interpolate_spline(d);
+	}
+
+	double xmin = d->x[0];
+	double xmax = d->x[n - 1];
+	unsigned int j = 0;
+	unsigned int i;
+	for (i = 0; i < d->nt; i++) {
+		/* visit increasing targets in order, so j only moves forward */
+		k = d->t_dir < 0 ? d->nt - 1 - i : i;
+		double t = d->t_linear ? d->t0 + k * d->dt : d->t[k];
+		if (!(t >= xmin && t <= xmax)) {
+			d->output[k] = NAN;
+			continue;
+		}
+		if (d->x_linear) {
+			j = MIN((unsigned int)((t - d->x0) / d->dx), n - 2);
+		} else if (d->t_dir != 0) {
+			while (j < n - 2 && d->x[j + 1] <= t)
+				j++;
+		} else {
+			j = interpolate_search(d, t);
+		}
+		d->output[k] = interpolate_eval(d, j, t);
+	}
+	return d->output;
+}
+
+static void y_interpolate_operation_class_init(YInterpolateOperationClass *
+					       klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->set_property = y_interpolate_operation_set_property;
+	gobject_klass->get_property = y_interpolate_operation_get_property;
+	gobject_klass->dispose = y_interpolate_operation_dispose;
+	YOperationClass *op_klass = (YOperationClass *) klass;
+	op_klass->thread_safe = TRUE;
+	op_klass->op_size = interpolate_size;
+	op_klass->op_func = interpolate_op;
+	op_klass->op_data = interpolate_op_create_data;
+	op_klass->op_data_free = interpolate_op_data_free;
+
+	g_object_class_install_property(gobject_klass, INTERPOLATE_PROP_X,
+					g_param_spec_object("x", "X",
+							    "Points the input is sampled at, or NULL for its indices",
+							    Y_TYPE_VECTOR,
+							    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, INTERPOLATE_PROP_TARGET,
+					g_param_spec_object("target", "Target",
+							    "Points to interpolate onto",
+							    Y_TYPE_VECTOR,
+							    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, INTERPOLATE_PROP_METHOD,
+					g_param_spec_int("method", "Method",
+							 "Interpolation method",
+							 INTERPOLATE_LINEAR,
+							 INTERPOLATE_NEAREST,
+							 INTERPOLATE_LINEAR,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void y_interpolate_operation_init(YInterpolateOperation * sop)
+{
+	g_assert(Y_IS_INTERPOLATE_OPERATION(sop));
+	sop->method = INTERPOLATE_LINEAR;
+}
+
+/**
+ * y_interpolate_operation_new:
+ * @x: (nullable): points the input is sampled at, or %NULL for its indices
+ * @target: points to interpolate onto
+ * @method: %INTERPOLATE_LINEAR, %INTERPOLATE_CUBIC or %INTERPOLATE_NEAREST
+ *
+ * Create a new interpolation operation.
+ *
+ * Returns: a #YOperation
+ **/
+YOperation *y_interpolate_operation_new(YVector * x, YVector * target,
+					int method)
+{
+	return g_object_new(Y_TYPE_INTERPOLATE_OPERATION, "x", x, "target",
+			    target, "method", method, NULL);
+}
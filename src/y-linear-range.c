@@ -21,6 +21,7 @@
  */
 
 #include "y-linear-range.h"
+#include "y-fft-util.h"
 #include <math.h>
 
 /**
@@ -28,6 +29,27 @@
  * @short_description: Vector for equally spaced data.
  *
  * A vector y_i = v_0 + i*dv, where i ranges from 0 to n-1.
+ *
+ * The values are computed from v_0, dv and n when needed. Looking up single
+ * values, the minimum and maximum, whether the vector is monotonic, the index
+ * of a value with y_vector_find_index(), and copying part of the vector with
+ * y_vector_get_values_range() are all done without filling the cache, which
+ * is only allocated if y_vector_get_values() is called.
+ *
+ * A #YFourierLinearRangeVector holds the frequencies of the one-sided
+ * spectrum of data sampled on a #YLinearRangeVector. If the transform is zero
+ * padded, set the same padding policy with
+ * y_fourier_linear_range_vector_set_padding() so the frequency axis follows
+ * the padded length.
+ *
+ * A #YLinearRangeMatrix is one of the two coordinate matrices of the grid
+ * spanned by two #YLinearRangeVector objects, like the output of NumPy's
+ * meshgrid: with %MESHGRID_X, element (i,j) is element j of the x vector, and
+ * with %MESHGRID_Y it is element i of the y vector. The matrix has a row for
+ * each element of y and a column for each element of x. Values and the
+ * minimum and maximum are computed from the vectors, and operations that copy
+ * their input with y_matrix_get_values_range() never fill the cache, so a
+ * large grid costs no memory unless y_matrix_get_values() is called.
  */
 
 struct _YLinearRangeVector {
@@ -85,6 +107,35 @@ linear_range_vector_get_value (YVector *vec, unsigned i)
 	return get_val(val,i);
 }
 
+static double
+linear_range_vector_locate (YVector *vec, double x)
+{
+	YLinearRangeVector const *val = (YLinearRangeVector const *)vec;
+	if(val->dv == 0.0)
+		return 0.0;
+	return (x - val->v0)/val->dv;
+}
+
+static void
+linear_range_vector_load_range (YVector *vec, unsigned start, unsigned n, double *out)
+{
+	YLinearRangeVector const *val = (YLinearRangeVector const *)vec;
+	unsigned int i;
+	for (i = 0; i < n; i++) {
+		out[i] = get_val(val, (start + i));
+	}
+}
+
+static void
+linear_range_vector_minmax_range (YVector *vec, unsigned start, unsigned end, double *min, double *max)
+{
+	YLinearRangeVector const *val = (YLinearRangeVector const *)vec;
+	double a = get_val(val, start);
+	double b = get_val(val, (end - 1));
+	*min = MIN(a, b);
+	*max = MAX(a, b);
+}
+
 static gboolean
 linear_range_vector_has_value (YData *dat)
 {
@@ -108,6 +159,9 @@ y_linear_range_vector_class_init (YLinearRangeVectorClass *klass)
 	vector_klass->load_len    = linear_range_vector_load_len;
 	vector_klass->load_values = linear_range_vector_load_values;
 	vector_klass->get_value   = linear_range_vector_get_value;
+	vector_klass->locate      = linear_range_vector_locate;
+	vector_klass->load_range  = linear_range_vector_load_range;
+	vector_klass->minmax_range = linear_range_vector_minmax_range;
 }
 
 /**
@@ -217,6 +271,7 @@ struct _YFourierLinearRangeVector {
 	YLinearRangeVector *range;
 	unsigned int n;
 	gboolean inverse;
+	int padding;
 };
 
 G_DEFINE_TYPE (YFourierLinearRangeVector, y_fourier_linear_range_vector, Y_TYPE_VECTOR);
@@ -238,14 +293,23 @@ fourier_linear_range_vector_dup (YData *src)
 	YFourierLinearRangeVector *dst = g_object_new (G_OBJECT_TYPE (src), NULL);
 	YFourierLinearRangeVector const *src_val = (YFourierLinearRangeVector const *)src;
 	dst->range = g_object_ref(src_val->range);
+	dst->inverse = src_val->inverse;
+	dst->padding = src_val->padding;
 	return Y_DATA (dst);
 }
 
+/* length of the transform, after zero padding */
+static unsigned int
+fourier_padded_n (YFourierLinearRangeVector const *f)
+{
+	return y_fft_padded_length(f->padding, f->range->n);
+}
+
 static unsigned int
 fourier_linear_range_vector_load_len (YVector *vec)
 {
 	YFourierLinearRangeVector *f = (YFourierLinearRangeVector *) vec;
-	return f->range->n/2 + 1;
+	return fourier_padded_n(f)/2 + 1;
 }
 
 static double *
@@ -253,16 +317,17 @@ fourier_linear_range_vector_load_values (YVector *vec)
 {
 	YFourierLinearRangeVector *val = (YFourierLinearRangeVector *)vec;
 	YLinearRangeVector *range = val->range;
-	int i = range->n/2 + 1;
+	unsigned int n = fourier_padded_n(val);
+	int i = n/2 + 1;
 
 	g_assert(isfinite(range->v0));
 	g_assert(isfinite(range->dv));
 	if(range->n ==0 )
 		return NULL;
 
-	double *values = y_vector_replace_cache(vec,range->n/2+1);
+	double *values = y_vector_replace_cache(vec,n/2+1);
 
-	double df = 1./range->n/range->dv;
+	double df = 1./n/range->dv;
 	if(val->inverse) {
 		df *= 2*M_PI;
 	}
@@ -279,13 +344,42 @@ fourier_linear_range_vector_get_value (YVector *vec, unsigned i)
 	YFourierLinearRangeVector const *val = (YFourierLinearRangeVector const *)vec;
 	YLinearRangeVector *range = val->range;
 
-	double df = 1./range->n/range->dv;
+	double df = 1./fourier_padded_n(val)/range->dv;
 	if(val->inverse) {
 		df *= 2*M_PI;
 	}
 	return i*df;
 }
 
+static void
+fourier_linear_range_vector_load_range (YVector *vec, unsigned start, unsigned n, double *out)
+{
+	double df = fourier_linear_range_vector_get_value(vec, 1);
+	unsigned int i;
+	for (i = 0; i < n; i++) {
+		out[i] = (start + i)*df;
+	}
+}
+
+static void
+fourier_linear_range_vector_minmax_range (YVector *vec, unsigned start, unsigned end, double *min, double *max)
+{
+	double df = fourier_linear_range_vector_get_value(vec, 1);
+	double a = start*df;
+	double b = (end - 1)*df;
+	*min = MIN(a, b);
+	*max = MAX(a, b);
+}
+
+static double
+fourier_linear_range_vector_locate (YVector *vec, double x)
+{
+	double df = fourier_linear_range_vector_get_value(vec, 1);
+	if(df == 0.0 || !isfinite(df))
+		return 0.0;
+	return x/df;
+}
+
 static gboolean
 fourier_linear_range_vector_has_value (YData *dat)
 {
@@ -310,6 +404,9 @@ y_fourier_linear_range_vector_class_init (YFourierLinearRangeVectorClass *klass)
 	vector_klass->load_len    = fourier_linear_range_vector_load_len;
 	vector_klass->load_values = fourier_linear_range_vector_load_values;
 	vector_klass->get_value   = fourier_linear_range_vector_get_value;
+	vector_klass->locate      = fourier_linear_range_vector_locate;
+	vector_klass->load_range  = fourier_linear_range_vector_load_range;
+	vector_klass->minmax_range = fourier_linear_range_vector_minmax_range;
 }
 
 static void
@@ -319,8 +416,8 @@ on_range_changed (YData *d, gpointer user_data)
 	YFourierLinearRangeVector *res = Y_FOURIER_LINEAR_RANGE_VECTOR(user_data);
 	g_assert(Y_IS_LINEAR_RANGE_VECTOR(res->range));
 	g_assert(d == Y_DATA(res->range));
-	if(res->n != res->range->n/2 + 1) {
-		res->n = res->range->n/2 + 1;
+	if(res->n != fourier_padded_n(res)/2 + 1) {
+		res->n = fourier_padded_n(res)/2 + 1;
 	}
 	y_data_emit_changed(dat);
 }
@@ -334,6 +431,26 @@ y_fourier_linear_range_vector_set_inverse(YFourierLinearRangeVector *v, gboolean
 	}
 }
 
+/**
+ * y_fourier_linear_range_vector_set_padding :
+ * @v: a #YFourierLinearRangeVector
+ * @padding: the padding policy, e.g. %FFT_PAD_POW2
+ *
+ * Set the zero padding policy of the transform, as with the "padding"
+ * property of #YFFTOperation, so that the frequencies match the padded
+ * length.
+ **/
+void
+y_fourier_linear_range_vector_set_padding(YFourierLinearRangeVector *v, int padding)
+{
+	g_return_if_fail(Y_IS_FOURIER_LINEAR_RANGE_VECTOR(v));
+	if(v->padding!=padding) {
+		v->padding = padding;
+		v->n = fourier_padded_n(v)/2 + 1;
+		y_data_emit_changed(Y_DATA(v));
+	}
+}
+
 /**
  * y_fourier_linear_range_vector_new :
  * @v: real space range
@@ -353,3 +470,178 @@ y_fourier_linear_range_vector_new (YLinearRangeVector *v)
 	g_signal_connect_after(res->range,"changed",G_CALLBACK(on_range_changed),res);
 	return Y_DATA (res);
 }
+
+/******************************************************************/
+
+struct _YLinearRangeMatrix {
+	YMatrix base;
+	YLinearRangeVector *x;
+	YLinearRangeVector *y;
+	int axis;
+};
+
+G_DEFINE_TYPE (YLinearRangeMatrix, y_linear_range_matrix, Y_TYPE_MATRIX);
+
+static GObjectClass *matrix_parent_klass;
+
+static void
+linear_range_matrix_finalize (GObject *obj)
+{
+	YLinearRangeMatrix *mat = (YLinearRangeMatrix *)obj;
+
+	g_signal_handlers_disconnect_by_data(mat->x, obj);
+	g_signal_handlers_disconnect_by_data(mat->y, obj);
+	g_object_unref(mat->x);
+	g_object_unref(mat->y);
+
+	(*matrix_parent_klass->finalize) (obj);
+}
+
+static YData *
+linear_range_matrix_dup (YData *src)
+{
+	YLinearRangeMatrix const *src_val = (YLinearRangeMatrix const *)src;
+	return y_linear_range_matrix_new(src_val->x, src_val->y, src_val->axis);
+}
+
+static YMatrixSize
+linear_range_matrix_load_size (YMatrix *mat)
+{
+	YLinearRangeMatrix const *val = (YLinearRangeMatrix const *)mat;
+	YMatrixSize size;
+	size.rows = val->y->n;
+	size.columns = val->x->n;
+	return size;
+}
+
+static double
+linear_range_matrix_get_value (YMatrix *mat, unsigned i, unsigned j)
+{
+	YLinearRangeMatrix const *val = (YLinearRangeMatrix const *)mat;
+	if(val->axis == MESHGRID_X)
+		return get_val(val->x, j);
+	return get_val(val->y, i);
+}
+
+static void
+linear_range_matrix_load_range (YMatrix *mat, unsigned start, unsigned n, double *out)
+{
+	YLinearRangeMatrix const *val = (YLinearRangeMatrix const *)mat;
+	unsigned int ncol = val->x->n;
+	if (n == 0 || ncol == 0)
+		return;
+	unsigned int i = start / ncol;
+	unsigned int j = start % ncol;
+	unsigned int k;
+	for (k = 0; k < n; k++) {
+		out[k] = val->axis == MESHGRID_X ? get_val(val->x, j) : get_val(val->y, i);
+		if (++j == ncol) {
+			j = 0;
+			i++;
+		}
+	}
+}
+
+static double *
+linear_range_matrix_load_values (YMatrix *mat)
+{
+	YLinearRangeMatrix *val = (YLinearRangeMatrix *)mat;
+	unsigned int n = val->x->n * val->y->n;
+	if (n == 0)
+		return NULL;
+	double *values = y_matrix_replace_cache(mat, n);
+	linear_range_matrix_load_range(mat, 0, n, values);
+	return values;
+}
+
+static void
+linear_range_matrix_load_minmax (YMatrix *mat, double *min, double *max)
+{
+	YLinearRangeMatrix const *val = (YLinearRangeMatrix const *)mat;
+	if(val->x->n == 0 || val->y->n == 0) {
+		*min = DBL_MAX;
+		*max = -DBL_MAX;
+		return;
+	}
+	y_vector_get_minmax(Y_VECTOR(val->axis == MESHGRID_X ? val->x : val->y), min, max);
+}
+
+static gboolean
+linear_range_matrix_has_value (YData *dat)
+{
+	YLinearRangeMatrix const *val = (YLinearRangeMatrix const *)dat;
+	return linear_range_vector_has_value(Y_DATA(val->x)) &&
+		linear_range_vector_has_value(Y_DATA(val->y));
+}
+
+static void
+y_linear_range_matrix_init(YLinearRangeMatrix *m) {}
+
+static void
+y_linear_range_matrix_class_init (YLinearRangeMatrixClass *klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	YDataClass *ydata_klass = (YDataClass *) klass;
+	YMatrixClass *matrix_klass = (YMatrixClass *) klass;
+
+	matrix_parent_klass = g_type_class_peek_parent (gobject_klass);
+	gobject_klass->finalize = linear_range_matrix_finalize;
+	ydata_klass->dup	= linear_range_matrix_dup;
+	ydata_klass->has_value = linear_range_matrix_has_value;
+	matrix_klass->load_size   = linear_range_matrix_load_size;
+	matrix_klass->load_values = linear_range_matrix_load_values;
+	matrix_klass->get_value   = linear_range_matrix_get_value;
+	matrix_klass->load_range  = linear_range_matrix_load_range;
+	matrix_klass->load_minmax = linear_range_matrix_load_minmax;
+}
+
+static void
+on_grid_range_changed (YData *d, gpointer user_data)
+{
+	y_data_emit_changed(Y_DATA(user_data));
+}
+
+/**
+ * y_linear_range_matrix_new :
+ * @x: range for the columns
+ * @y: range for the rows
+ * @axis: %MESHGRID_X or %MESHGRID_Y
+ *
+ * Create a new #YLinearRangeMatrix holding the x or y coordinate of each
+ * point of the grid spanned by @x and @y.
+ *
+ * Returns: a new #YLinearRangeMatrix as a #YData
+ **/
+
+YData *
+y_linear_range_matrix_new (YLinearRangeVector *x, YLinearRangeVector *y, int axis)
+{
+	g_return_val_if_fail(Y_IS_LINEAR_RANGE_VECTOR(x), NULL);
+	g_return_val_if_fail(Y_IS_LINEAR_RANGE_VECTOR(y), NULL);
+	YLinearRangeMatrix *res = g_object_new (Y_TYPE_LINEAR_RANGE_MATRIX, NULL);
+	res->x = g_object_ref_sink(x);
+	res->y = g_object_ref_sink(y);
+	res->axis = axis;
+	g_signal_connect_after(res->x,"changed",G_CALLBACK(on_grid_range_changed),res);
+	g_signal_connect_after(res->y,"changed",G_CALLBACK(on_grid_range_changed),res);
+	return Y_DATA (res);
+}
+
+/**
+ * y_linear_range_meshgrid :
+ * @x: range for the columns
+ * @y: range for the rows
+ * @xgrid: (out)(transfer full): return location for the x coordinates
+ * @ygrid: (out)(transfer full): return location for the y coordinates
+ *
+ * Create both coordinate matrices of the grid spanned by @x and @y.
+ **/
+
+void
+y_linear_range_meshgrid (YLinearRangeVector *x, YLinearRangeVector *y, YData **xgrid, YData **ygrid)
+{
+	if(xgrid)
+		*xgrid = y_linear_range_matrix_new(x, y, MESHGRID_X);
+	if(ygrid)
+		*ygrid = y_linear_range_matrix_new(x, y, MESHGRID_Y);
+}
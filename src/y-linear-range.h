@@ -46,8 +46,22 @@ G_DECLARE_FINAL_TYPE(YFourierLinearRangeVector,y_fourier_linear_range_vector,Y,F
 #define Y_TYPE_FOURIER_LINEAR_RANGE_VECTOR  (y_fourier_linear_range_vector_get_type ())
 
 void y_fourier_linear_range_vector_set_inverse(YFourierLinearRangeVector *v, gboolean val);
+void y_fourier_linear_range_vector_set_padding(YFourierLinearRangeVector *v, int padding);
 YData *y_fourier_linear_range_vector_new( YLinearRangeVector *v);
 
+G_DECLARE_FINAL_TYPE(YLinearRangeMatrix,y_linear_range_matrix,Y,LINEAR_RANGE_MATRIX,YMatrix)
+
+#define Y_TYPE_LINEAR_RANGE_MATRIX  (y_linear_range_matrix_get_type ())
+
+/* which coordinate a YLinearRangeMatrix holds */
+enum {
+	MESHGRID_X = 0,
+	MESHGRID_Y
+};
+
+YData *y_linear_range_matrix_new(YLinearRangeVector *x, YLinearRangeVector *y, int axis);
+void y_linear_range_meshgrid(YLinearRangeVector *x, YLinearRangeVector *y, YData **xgrid, YData **ygrid);
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,449 @@
+/*
+ * y-lock-in-operation.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <memory.h>
+#include <math.h>
+#include <complex.h>
+#include "y-lock-in-operation.h"
+#include "y-vector-ring.h"
+
+/**
+ * SECTION: y-lock-in-operation
+ * @short_description: Operation that demodulates a signal against a reference frequency.
+ *
+ * This operation works like a digital lock-in amplifier. The input is
+ * multiplied by a reference oscillator at "frequency", with phase "phase" in
+ * radians, and the products are low-pass filtered by "order" cascaded first
+ * order filters with time constant "time-constant". A sinusoid
+ * A cos(2 pi f t + phi) at the reference frequency gives X = A cos(phi -
+ * phase) and Y = A sin(phi - phase), so R is the amplitude A. Frequencies and
+ * times are in units of "sample-rate".
+ *
+ * The output is a matrix with "rows" rows and four columns, %LOCK_IN_X,
+ * %LOCK_IN_Y, %LOCK_IN_R and %LOCK_IN_THETA. One row is written every
+ * "decimation" input samples, with the newest at the bottom; rows that have
+ * not been filled yet are zero. Single columns can be taken out as vectors
+ * with a #YSliceOperation.
+ *
+ * When the input is a #YRingVector, the filter state is kept between runs and
+ * only samples appended since the last run are processed, found with
+ * y_ring_vector_get_n_appended(). Samples are mixed in blocks, against a
+ * table of the oscillator over one block that is rotated to the phase of
+ * each block, in loops the compiler can vectorize. For other vectors, the
+ * whole input is demodulated each time, starting from a zero filter state.
+ *
+ * Changing any property restarts the demodulation from the data currently
+ * in the input.
+ */
+
+enum {
+	LOCK_IN_PROP_0,
+	LOCK_IN_PROP_FREQUENCY,
+	LOCK_IN_PROP_PHASE,
+	LOCK_IN_PROP_SAMPLE_RATE,
+	LOCK_IN_PROP_TIME_CONSTANT,
+	LOCK_IN_PROP_ORDER,
+	LOCK_IN_PROP_DECIMATION,
+	LOCK_IN_PROP_ROWS,
+	N_PROPERTIES
+};
+
+/* number of samples mixed at a time */
+#define LOCK_IN_BLOCK 256
+#define LOCK_IN_MAX_ORDER 8
+
+struct _YLockInOperation {
+	YOperation base;
+	double frequency;
+	double phase;
+	double sample_rate;
+	double time_constant;
+	int order;
+	int decimation;
+	int rows;
+};
+
+G_DEFINE_TYPE(YLockInOperation, y_lock_in_operation, Y_TYPE_OPERATION);
+
+static void
+y_lock_in_operation_set_property(GObject * gobject, guint param_id,
+				 GValue const *value, GParamSpec * pspec)
+{
+	YLockInOperation *sop = Y_LOCK_IN_OPERATION(gobject);
+
+	switch (param_id) {
+	case LOCK_IN_PROP_FREQUENCY:
+		sop->frequency = g_value_get_double(value);
+		break;
+	case LOCK_IN_PROP_PHASE:
+		sop->phase = g_value_get_double(value);
+		break;
+	case LOCK_IN_PROP_SAMPLE_RATE:
+		sop->sample_rate = g_value_get_double(value);
+		break;
+	case LOCK_IN_PROP_TIME_CONSTANT:
+		sop->time_constant = g_value_get_double(value);
+		break;
+	case LOCK_IN_PROP_ORDER:
+		sop->order = g_value_get_int(value);
+		break;
+	case LOCK_IN_PROP_DECIMATION:
+		sop->decimation = g_value_get_int(value);
+		break;
+	case LOCK_IN_PROP_ROWS:
+		sop->rows = g_value_get_int(value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void
+y_lock_in_operation_get_property(GObject * gobject, guint param_id,
+				 GValue * value, GParamSpec * pspec)
+{
+	YLockInOperation *sop = Y_LOCK_IN_OPERATION(gobject);
+
+	switch (param_id) {
+	case LOCK_IN_PROP_FREQUENCY:
+		g_value_set_double(value, sop->frequency);
+		break;
+	case LOCK_IN_PROP_PHASE:
+		g_value_set_double(value, sop->phase);
+		break;
+	case LOCK_IN_PROP_SAMPLE_RATE:
+		g_value_set_double(value, sop->sample_rate);
+		break;
+	case LOCK_IN_PROP_TIME_CONSTANT:
+		g_value_set_double(value, sop->time_constant);
+		break;
+	case LOCK_IN_PROP_ORDER:
+		g_value_set_int(value, sop->order);
+		break;
+	case LOCK_IN_PROP_DECIMATION:
+		g_value_set_int(value, sop->decimation);
+		break;
+	case LOCK_IN_PROP_ROWS:
+		g_value_set_int(value, sop->rows);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static
+int lock_in_size(YOperation * op, YData * input, unsigned int *dims)
+{
+	g_assert(Y_IS_VECTOR(input));
+	g_assert(dims);
+	YLockInOperation *sop = Y_LOCK_IN_OPERATION(op);
+	dims[0] = 4;
+	dims[1] = sop->rows;
+	return 2;
+}
+
+typedef struct {
+	YLockInOperation sop;
+	/* oscillator over one block, e^(-i w n) for n = 0..LOCK_IN_BLOCK-1 */
+	double osc_re[LOCK_IN_BLOCK];
+	double osc_im[LOCK_IN_BLOCK];
+	double mix_re[LOCK_IN_BLOCK];
+	double mix_im[LOCK_IN_BLOCK];
+	double w;		/* radians per sample */
+	double alpha;		/* filter coefficient */
+	double theta;		/* reference phase of the next sample */
+	complex double z[LOCK_IN_MAX_ORDER];	/* filter state */
+	unsigned int dec_count;
+	/* samples appended since the operation last ran */
+	double *pending;
+	unsigned int n_pending;
+	unsigned int pending_size;
+	guint64 seen;		/* sample number after the last one seen */
+	gboolean started;
+	double *rows;		/* rows produced by the current run */
+	unsigned int rows_size;
+	double *output;
+} LockInOpData;
+
+static gboolean lock_in_pars_equal(const YLockInOperation * a,
+				   const YLockInOperation * b)
+{
+	return a->frequency == b->frequency && a->phase == b->phase
+	    && a->sample_rate == b->sample_rate
+	    && a->time_constant == b->time_constant && a->order == b->order
+	    && a->decimation == b->decimation && a->rows == b->rows;
+}
+
+/* forget the filter state; the next sample processed is sample number n */
+static void lock_in_clear(LockInOpData * d, guint64 n)
+{
+	memset(d->z, 0, sizeof(d->z));
+	d->dec_count = 0;
+	d->n_pending = 0;
+	d->theta = fmod(d->w * (double)n, 2 * G_PI) + d->sop.phase;
+}
+
+static void lock_in_reset(LockInOpData * d)
+{
+	unsigned int i;
+	d->w = 2 * G_PI * d->sop.frequency / d->sop.sample_rate;
+	d->alpha = -expm1(-1.0 / (d->sop.time_constant * d->sop.sample_rate));
+	for (i = 0; i < LOCK_IN_BLOCK; i++) {
+		d->osc_re[i] = cos(d->w * i);
+		d->osc_im[i] = -sin(d->w * i);
+	}
+	g_free(d->output);
+	d->output = g_new0(double, 4 * (gsize) d->sop.rows);
+	d->started = FALSE;
+}
+
+static void lock_in_add_pending(LockInOpData * d, const double *v,
+				unsigned int n)
+{
+	if (d->n_pending + n > d->pending_size) {
+		d->pending_size = d->n_pending + n;
+		d->pending = g_renew(double, d->pending, d->pending_size);
+	}
+	memcpy(d->pending + d->n_pending, v, n * sizeof(double));
+	d->n_pending += n;
+}
+
+static
+gpointer lock_in_op_create_data(YOperation * op, gpointer data,
+				YData * input)
+{
+	if (input == NULL)
+		return NULL;
+	g_return_val_if_fail(Y_IS_VECTOR(input), NULL);
+	LockInOpData *d;
+	YLockInOperation *sop = Y_LOCK_IN_OPERATION(op);
+	gboolean reset = FALSE;
+	if (data == NULL) {
+		d = g_new0(LockInOpData, 1);
+		reset = TRUE;
+	} else {
+		d = (LockInOpData *) data;
+		reset = !lock_in_pars_equal(&d->sop, sop);
+	}
+	d->sop = *sop;
+	if (reset) {
+		lock_in_reset(d);
+	}
+
+	YVector *vec = Y_VECTOR(input);
+	unsigned int n = y_vector_get_len(vec);
+	const double *v = y_vector_get_values(vec);
+	guint64 total = n;
+	if (Y_IS_RING_VECTOR(input)) {
+		total = y_ring_vector_get_n_appended(Y_RING_VECTOR(input));
+	} else if (d->started) {
+		/* no way to tell what is new, so start over */
+		memset(d->output, 0, 4 * sizeof(double) * d->sop.rows);
+		d->started = FALSE;
+	}
+	guint64 first = total - n;	/* sample number of v[0] */
+	if (!d->started) {
+		lock_in_clear(d, first);
+		d->seen = first;
+		d->started = TRUE;
+	}
+	if (d->seen < first) {
+		/* samples were lost before we saw them */
+		lock_in_clear(d, first);
+		d->seen = first;
+	}
+	if (d->seen < total) {
+		lock_in_add_pending(d, v + (d->seen - first), total - d->seen);
+	}
+	d->seen = total;
+	return d;
+}
+
+static
+void lock_in_op_data_free(gpointer data)
+{
+	LockInOpData *d = (LockInOpData *) data;
+	g_free(d->pending);
+	g_free(d->rows);
+	g_free(d->output);
+	g_free(d);
+}
+
+static
+gpointer lock_in_op(gpointer input)
+{
+	LockInOpData *d = (LockInOpData *) input;
+
+	if (d == NULL)
+		return NULL;
+
+	unsigned int nrows = d->sop.rows;
+	unsigned int order = CLAMP(d->sop.order, 1, LOCK_IN_MAX_ORDER);
+	unsigned int dec = d->sop.decimation;
+	unsigned int max_new = (d->dec_count + d->n_pending) / dec;
+	if (max_new > d->rows_size) {
+		d->rows_size = max_new;
+		d->rows = g_renew(double, d->rows, 4 * (gsize) d->rows_size);
+	}
+	unsigned int n_new = 0;
+	double a = d->alpha;
+	unsigned int start, i, k;
+	for (start = 0; start < d->n_pending; start += LOCK_IN_BLOCK) {
+		unsigned int len = MIN(LOCK_IN_BLOCK, d->n_pending - start);
+		const double *x = d->pending + start;
+		/* rotate the oscillator table to the phase of this block, and
+		 * mix; the factor 2 makes R the amplitude */
+		double pr = 2 * cos(d->theta);
+		double pi = -2 * sin(d->theta);
+		for (i = 0; i < len; i++) {
+			double cr = d->osc_re[i] * pr - d->osc_im[i] * pi;
+			double ci = d->osc_re[i] * pi + d->osc_im[i] * pr;
+			d->mix_re[i] = x[i] * cr;
+			d->mix_im[i] = x[i] * ci;
+		}
+		d->theta = fmod(d->theta + d->w * len, 2 * G_PI);
+		for (i = 0; i < len; i++) {
+			complex double u = d->mix_re[i] + I * d->mix_im[i];
+			for (k = 0; k < order; k++) {
+				d->z[k] += a * (u - d->z[k]);
+				u = d->z[k];
+			}
+			if (++d->dec_count == dec) {
+				double *row = d->rows + 4 * (gsize) n_new;
+				row[LOCK_IN_X] = creal(u);
+				row[LOCK_IN_Y] = cimag(u);
+				row[LOCK_IN_R] = cabs(u);
+				row[LOCK_IN_THETA] = carg(u);
+				n_new++;
+				d->dec_count = 0;
+			}
+		}
+	}
+	d->n_pending = 0;
+
+	/* scroll the old rows up and copy in the new ones */
+	if (n_new == 0) {
+		return d->output;
+	} else if (n_new < nrows) {
+		memmove(d->output, d->output + 4 * (gsize) n_new,
+			4 * (gsize) (nrows - n_new) * sizeof(double));
+		memcpy(d->output + 4 * (gsize) (nrows - n_new), d->rows,
+		       4 * (gsize) n_new * sizeof(double));
+	} else {
+		memcpy(d->output, d->rows + 4 * (gsize) (n_new - nrows),
+		       4 * (gsize) nrows * sizeof(double));
+	}
+	return d->output;
+}
+
+static void y_lock_in_operation_class_init(YLockInOperationClass * klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->set_property = y_lock_in_operation_set_property;
+	gobject_klass->get_property = y_lock_in_operation_get_property;
+	YOperationClass *op_klass = (YOperationClass *) klass;
+	op_klass->thread_safe = TRUE;
+	op_klass->op_size = lock_in_size;
+	op_klass->op_func = lock_in_op;
+	op_klass->op_data = lock_in_op_create_data;
+	op_klass->op_data_free = lock_in_op_data_free;
+
+	g_object_class_install_property(gobject_klass, LOCK_IN_PROP_FREQUENCY,
+					g_param_spec_double("frequency",
+							    "Frequency",
+							    "Reference frequency",
+							    0.0, G_MAXDOUBLE, 0.1,
+							    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, LOCK_IN_PROP_PHASE,
+					g_param_spec_double("phase", "Phase",
+							    "Reference phase in radians",
+							    -G_MAXDOUBLE, G_MAXDOUBLE,
+							    0.0,
+							    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass,
+					LOCK_IN_PROP_SAMPLE_RATE,
+					g_param_spec_double("sample-rate",
+							    "Sample rate",
+							    "Sample rate of the input",
+							    G_MINDOUBLE, G_MAXDOUBLE, 1.0,
+							    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass,
+					LOCK_IN_PROP_TIME_CONSTANT,
+					g_param_spec_double("time-constant",
+							    "Time constant",
+							    "Time constant of each low-pass filter stage",
+							    G_MINDOUBLE, G_MAXDOUBLE,
+							    10.0,
+							    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, LOCK_IN_PROP_ORDER,
+					g_param_spec_int("order", "Order",
+							 "Number of low-pass filter stages",
+							 1, LOCK_IN_MAX_ORDER, 2,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, LOCK_IN_PROP_DECIMATION,
+					g_param_spec_int("decimation",
+							 "Decimation",
+							 "Number of input samples per output row",
+							 1, 1 << 24, 1,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, LOCK_IN_PROP_ROWS,
+					g_param_spec_int("rows", "Rows",
+							 "Number of output rows to keep",
+							 1, 1 << 24, 1000,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void y_lock_in_operation_init(YLockInOperation * sop)
+{
+	g_assert(Y_IS_LOCK_IN_OPERATION(sop));
+	sop->frequency = 0.1;
+	sop->phase = 0.0;
+	sop->sample_rate = 1.0;
+	sop->time_constant = 10.0;
+	sop->order = 2;
+	sop->decimation = 1;
+	sop->rows = 1000;
+}
+
+/**
+ * y_lock_in_operation_new:
+ * @frequency: reference frequency
+ * @sample_rate: sample rate of the input
+ *
+ * Create a new lock-in operation.
+ *
+ * Returns: a #YOperation
+ **/
+YOperation *y_lock_in_operation_new(double frequency, double sample_rate)
+{
+	YOperation *o = g_object_new(Y_TYPE_LOCK_IN_OPERATION,
+				     "frequency", frequency,
+				     "sample-rate", sample_rate, NULL);
+	return o;
+}
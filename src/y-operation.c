@@ -56,7 +56,7 @@ double *y_create_input_array_from_vector(YVector * input, gboolean is_new,
 	} else {
 		d = g_new(double, size);
 	}
-	memcpy(d, y_vector_get_values(input), size * sizeof(double));
+	y_vector_get_values_range(input, 0, size, d);
 	return d;
 }
 
@@ -82,9 +82,7 @@ double *y_create_input_array_from_matrix(YMatrix * input, gboolean is_new,
 	if(d==NULL) {
 		d = g_new(double, size.rows * size.columns);
 	}
-	g_assert(y_matrix_get_values(input));
-	memcpy(d, y_matrix_get_values(input),
-	       size.rows * size.columns * sizeof(double));
+	y_matrix_get_values_range(input, 0, size.rows * size.columns, d);
 	return d;
 }
 
@@ -0,0 +1,415 @@
+/*
+ * y-psd-operation.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <memory.h>
+#include <math.h>
+#include <complex.h>
+#include "y-psd-operation.h"
+
+/**
+ * SECTION: y-psd-operation
+ * @short_description: Operation that estimates the power spectral density of a vector.
+ *
+ * This operation uses Welch's method: the input is split into segments of
+ * "segment-length" samples that overlap by "overlap" samples, each segment is
+ * multiplied by a window function and transformed, and the squared
+ * magnitudes are averaged. With a rectangular window and no overlap this is
+ * Bartlett's method. The output is one-sided, with segment-length/2+1
+ * elements. The overlap must be less than the segment length; otherwise a
+ * warning is given and the output is NaN.
+ *
+ * With %PSD_DENSITY scaling the output is a power spectral density, in units
+ * of input squared per unit of "sample-rate". With %PSD_SPECTRUM scaling it is
+ * a power spectrum, so a sinusoid of amplitude A gives a peak of A^2/2; this
+ * is most accurate with %FFT_WINDOW_FLAT_TOP. If "db" is set, the output is
+ * 10*log10 of the estimate.
+ *
+ * Segments are windowed into a buffer that is allocated once and transformed
+ * in batches with a single batched plan, which uses several threads for
+ * large inputs when FFTW was built with thread support. Segments left over
+ * after the last full batch are transformed one at a time. The plans only
+ * depend on the segment length and "rigor", so a new input length does not
+ * make new plans.
+ */
+
+enum {
+	PSD_PROP_0,
+	PSD_PROP_SEGMENT_LENGTH,
+	PSD_PROP_OVERLAP,
+	PSD_PROP_WINDOW,
+	PSD_PROP_SCALING,
+	PSD_PROP_DB,
+	PSD_PROP_SAMPLE_RATE,
+	PSD_PROP_RIGOR,
+	N_PROPERTIES
+};
+
+/* maximum number of samples transformed by one batch */
+#define PSD_BATCH_SAMPLES (1<<18)
+
+struct _YPSDOperation {
+	YOperation base;
+	int segment_length;
+	int overlap;
+	double sample_rate;
+	gboolean db;
+	guchar window;
+	guchar scaling;
+	guchar rigor;
+};
+
+G_DEFINE_TYPE(YPSDOperation, y_psd_operation, Y_TYPE_OPERATION);
+
+static void
+y_psd_operation_set_property(GObject * gobject, guint param_id,
+			     GValue const *value, GParamSpec * pspec)
+{
+	YPSDOperation *sop = Y_PSD_OPERATION(gobject);
+
+	switch (param_id) {
+	case PSD_PROP_SEGMENT_LENGTH:
+		sop->segment_length = g_value_get_int(value);
+		break;
+	case PSD_PROP_OVERLAP:
+		sop->overlap = g_value_get_int(value);
+		break;
+	case PSD_PROP_WINDOW:
+		sop->window = g_value_get_int(value);
+		break;
+	case PSD_PROP_SCALING:
+		sop->scaling = g_value_get_int(value);
+		break;
+	case PSD_PROP_DB:
+		sop->db = g_value_get_boolean(value);
+		break;
+	case PSD_PROP_SAMPLE_RATE:
+		sop->sample_rate = g_value_get_double(value);
+		break;
+	case PSD_PROP_RIGOR:
+		sop->rigor = g_value_get_int(value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void
+y_psd_operation_get_property(GObject * gobject, guint param_id,
+			     GValue * value, GParamSpec * pspec)
+{
+	YPSDOperation *sop = Y_PSD_OPERATION(gobject);
+
+	switch (param_id) {
+	case PSD_PROP_SEGMENT_LENGTH:
+		g_value_set_int(value, sop->segment_length);
+		break;
+	case PSD_PROP_OVERLAP:
+		g_value_set_int(value, sop->overlap);
+		break;
+	case PSD_PROP_WINDOW:
+		g_value_set_int(value, sop->window);
+		break;
+	case PSD_PROP_SCALING:
+		g_value_set_int(value, sop->scaling);
+		break;
+	case PSD_PROP_DB:
+		g_value_set_boolean(value, sop->db);
+		break;
+	case PSD_PROP_SAMPLE_RATE:
+		g_value_set_double(value, sop->sample_rate);
+		break;
+	case PSD_PROP_RIGOR:
+		g_value_set_int(value, sop->rigor);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static
+int psd_size(YOperation * op, YData * input, unsigned int *dims)
+{
+	g_assert(Y_IS_VECTOR(input));
+	g_assert(dims);
+	YPSDOperation *sop = Y_PSD_OPERATION(op);
+	dims[0] = sop->segment_length / 2 + 1;
+	return 1;
+}
+
+typedef struct {
+	YPSDOperation sop;
+	double *input;
+	unsigned int len;
+	unsigned int hop;
+	unsigned int nseg;
+	double *window;
+	double scale;
+	unsigned int batch;	/* segments per transform */
+	double *segs;		/* batch windowed segments */
+	fftw_complex *spec;	/* batch spectra */
+	fftw_plan plan;		/* for a full batch */
+	fftw_plan plan_rest;	/* for one segment after the last full batch */
+	unsigned int nbins;
+	double *output;
+} PSDOpData;
+
+static gboolean psd_pars_equal(const YPSDOperation * a,
+			       const YPSDOperation * b)
+{
+	return a->segment_length == b->segment_length
+	    && a->window == b->window;
+}
+
+static
+gpointer psd_op_create_data(YOperation * op, gpointer data, YData * input)
+{
+	if (input == NULL)
+		return NULL;
+	g_return_val_if_fail(Y_IS_VECTOR(input), NULL);
+	PSDOpData *d;
+	YPSDOperation *sop = Y_PSD_OPERATION(op);
+	gboolean neu = TRUE;
+	gboolean reset = TRUE;
+	gboolean changed = TRUE;
+	gboolean replan = TRUE;
+	if (data == NULL) {
+		d = g_new0(PSDOpData, 1);
+	} else {
+		d = (PSDOpData *) data;
+		neu = FALSE;
+		reset = !psd_pars_equal(&d->sop, sop);
+		changed = reset || d->sop.overlap != sop->overlap;
+		replan = reset || d->sop.rigor != sop->rigor;
+	}
+	d->sop = *sop;
+	unsigned int sl = sop->segment_length;
+	YVector *vec = Y_VECTOR(input);
+	d->input = y_create_input_array_from_vector(vec, neu, d->len, d->input);
+	d->len = y_vector_get_len(vec);
+	if (sop->overlap < sop->segment_length) {
+		d->hop = sl - sop->overlap;
+		d->nseg = (d->len >= sl) ? (d->len - sl) / d->hop + 1 : 0;
+	} else {
+		/* no segments, so the output is NaN */
+		if (changed) {
+			g_warning("PSD overlap %d must be less than the segment length %d",
+				  sop->overlap, sop->segment_length);
+		}
+		d->hop = sl;
+		d->nseg = 0;
+	}
+
+	if (reset) {
+		d->nbins = sl / 2 + 1;
+		g_free(d->window);
+		g_free(d->output);
+		d->window = g_new(double, sl);
+		d->output = g_new(double, d->nbins);
+		y_fft_window_fill(sop->window, d->window, sl);
+	}
+	double sum = 0.0, sum2 = 0.0;
+	unsigned int i;
+	for (i = 0; i < sl; i++) {
+		sum += d->window[i];
+		sum2 += d->window[i] * d->window[i];
+	}
+	if (sop->scaling == PSD_SPECTRUM) {
+		d->scale = 1.0 / (sum * sum);
+	} else {
+		d->scale = 1.0 / (sop->sample_rate * sum2);
+	}
+
+	if (reset) {
+		d->batch = MAX(1, PSD_BATCH_SAMPLES / sl);
+		fftw_free(d->segs);
+		fftw_free(d->spec);
+		d->segs = fftw_alloc_real((gsize) d->batch * sl);
+		d->spec = fftw_alloc_complex((gsize) d->batch * d->nbins);
+	}
+	if (replan) {
+		y_fft_plan_release(d->plan);
+		y_fft_plan_release(d->plan_rest);
+		d->plan = y_fft_plan_r2c_many(sl, d->batch, 1, sl, 1, d->nbins,
+					      d->segs, d->spec, sop->rigor);
+		d->plan_rest = y_fft_plan_r2c_many(sl, 1, 1, sl, 1, d->nbins,
+						   d->segs, d->spec,
+						   sop->rigor);
+	}
+	return d;
+}
+
+static
+void psd_op_data_free(gpointer data)
+{
+	PSDOpData *d = (PSDOpData *) data;
+	y_fft_plan_release(d->plan);
+	y_fft_plan_release(d->plan_rest);
+	g_free(d->input);
+	g_free(d->window);
+	fftw_free(d->segs);
+	fftw_free(d->spec);
+	g_free(d->output);
+	g_free(d);
+}
+
+static
+gpointer psd_op(gpointer input)
+{
+	PSDOpData *d = (PSDOpData *) input;
+
+	if (d == NULL || d->plan == NULL || d->plan_rest == NULL)
+		return NULL;
+
+	unsigned int sl = d->sop.segment_length;
+	unsigned int nbins = d->nbins;
+	unsigned int i, k, s;
+	if (d->nseg == 0) {
+		for (k = 0; k < nbins; k++) {
+			d->output[k] = NAN;
+		}
+		return d->output;
+	}
+	memset(d->output, 0, nbins * sizeof(double));
+	unsigned int nfull = d->nseg - d->nseg % d->batch;
+	unsigned int nb;
+	for (s = 0; s < d->nseg; s += nb) {
+		nb = (s < nfull) ? d->batch : 1;
+		for (i = 0; i < nb; i++) {
+			const double *x = d->input + (gsize) (s + i) * d->hop;
+			double *seg = d->segs + (gsize) i * sl;
+			for (k = 0; k < sl; k++) {
+				seg[k] = x[k] * d->window[k];
+			}
+		}
+		fftw_plan plan = (nb == d->batch) ? d->plan : d->plan_rest;
+		fftw_execute_dft_r2c(plan, d->segs, d->spec);
+		for (i = 0; i < nb; i++) {
+			const fftw_complex *x = d->spec + (gsize) i * nbins;
+			for (k = 0; k < nbins; k++) {
+				double re = creal((complex double)x[k]);
+				double im = cimag((complex double)x[k]);
+				d->output[k] += re * re + im * im;
+			}
+		}
+	}
+	double scale = d->scale / d->nseg;
+	for (k = 0; k < nbins; k++) {
+		/* one-sided: count negative frequencies, except at DC and Nyquist */
+		double f = (k == 0 || 2 * k == sl) ? 1.0 : 2.0;
+		d->output[k] *= f * scale;
+		if (d->sop.db) {
+			d->output[k] = 10.0 * log10(d->output[k]);
+		}
+	}
+	return d->output;
+}
+
+static void y_psd_operation_class_init(YPSDOperationClass * klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->set_property = y_psd_operation_set_property;
+	gobject_klass->get_property = y_psd_operation_get_property;
+	YOperationClass *op_klass = (YOperationClass *) klass;
+	op_klass->thread_safe = TRUE;
+	op_klass->op_size = psd_size;
+	op_klass->op_func = psd_op;
+	op_klass->op_data = psd_op_create_data;
+	op_klass->op_data_free = psd_op_data_free;
+
+	g_object_class_install_property(gobject_klass, PSD_PROP_SEGMENT_LENGTH,
+					g_param_spec_int("segment-length",
+							 "Segment length",
+							 "Number of samples in each segment",
+							 2, 1 << 24, 256,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, PSD_PROP_OVERLAP,
+					g_param_spec_int("overlap", "Overlap",
+							 "Number of samples shared by successive segments, less than the segment length",
+							 0, 1 << 24, 128,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, PSD_PROP_WINDOW,
+					g_param_spec_int("window", "Window",
+							 "Window function",
+							 FFT_WINDOW_RECTANGULAR,
+							 FFT_WINDOW_FLAT_TOP,
+							 FFT_WINDOW_HANN,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, PSD_PROP_SCALING,
+					g_param_spec_int("scaling", "Scaling",
+							 "Whether to output a density or a power spectrum",
+							 PSD_DENSITY, PSD_SPECTRUM,
+							 PSD_DENSITY,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, PSD_PROP_DB,
+					g_param_spec_boolean("db", "dB",
+							     "Whether to output in decibels",
+							     FALSE,
+							     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, PSD_PROP_SAMPLE_RATE,
+					g_param_spec_double("sample-rate",
+							    "Sample rate",
+							    "Sample rate of the input, used for density scaling",
+							    G_MINDOUBLE, G_MAXDOUBLE, 1.0,
+							    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, PSD_PROP_RIGOR,
+					g_param_spec_int("rigor", "Rigor",
+							 "How hard the FFTW planner should look for a fast plan",
+							 FFT_ESTIMATE, FFT_PATIENT,
+							 FFT_ESTIMATE,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void y_psd_operation_init(YPSDOperation * sop)
+{
+	g_assert(Y_IS_PSD_OPERATION(sop));
+	sop->segment_length = 256;
+	sop->overlap = 128;
+	sop->window = FFT_WINDOW_HANN;
+	sop->scaling = PSD_DENSITY;
+	sop->sample_rate = 1.0;
+	sop->rigor = FFT_ESTIMATE;
+}
+
+/**
+ * y_psd_operation_new:
+ * @segment_length: number of samples in each segment
+ * @overlap: number of samples shared by successive segments, less than
+ * @segment_length
+ *
+ * Create a new power spectral density operation.
+ *
+ * Returns: a #YOperation
+ **/
+YOperation *y_psd_operation_new(int segment_length, int overlap)
+{
+	YOperation *o = g_object_new(Y_TYPE_PSD_OPERATION,
+				     "segment-length", segment_length,
+				     "overlap", overlap, NULL);
+	return o;
+}
@@ -0,0 +1,479 @@
+/*
+ * y-rolling-stats-operation.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <memory.h>
+#include <math.h>
+#include "y-rolling-stats-operation.h"
+#include "y-vector-ring.h"
+
+/**
+ * SECTION: y-rolling-stats-operation
+ * @short_description: Operation that computes statistics over a sliding
+ * window.
+ *
+ * This operation outputs, for each element of a vector, the mean, variance,
+ * standard deviation, minimum or maximum of the window of samples ending at
+ * that element. The window holds the last "window" samples, or, if
+ * "window-time" is positive and the input is a #YRingVector that tracks
+ * timestamps, the samples appended less than "window-time" seconds before
+ * the element. Near the start of the input the window holds fewer samples.
+ * The variance is the sample variance, with denominator one less than the
+ * number of samples, and is zero for a single sample.
+ *
+ * The mean and variance are kept with Welford's running update, which is
+ * reversed when samples leave the window and recomputed from the window
+ * once as many samples have left as it holds, so rounding errors do not
+ * accumulate. The minimum and maximum are kept with monotonic deques, and are
+ * those of the finite samples in the window, or NaN if there are none. Each
+ * sample therefore costs amortized constant time whatever the window length.
+ *
+ * When the input is a #YRingVector, the window state is kept between runs,
+ * and only samples appended since the last run are processed. New samples
+ * are found with y_ring_vector_get_n_appended(). If samples were dropped
+ * from the ring before the operation saw them, it starts again. For other
+ * inputs, everything is computed each time.
+ */
+
+enum {
+	ROLLING_PROP_0,
+	ROLLING_PROP_STATISTIC,
+	ROLLING_PROP_WINDOW,
+	ROLLING_PROP_WINDOW_TIME,
+	N_PROPERTIES
+};
+
+struct _YRollingStatsOperation {
+	YOperation base;
+	int statistic;
+	unsigned int window;
+	double window_time;
+};
+
+G_DEFINE_TYPE(YRollingStatsOperation, y_rolling_stats_operation,
+	      Y_TYPE_OPERATION);
+
+static void
+y_rolling_stats_operation_set_property(GObject * gobject, guint param_id,
+				       GValue const *value, GParamSpec * pspec)
+{
+	YRollingStatsOperation *sop = Y_ROLLING_STATS_OPERATION(gobject);
+
+	switch (param_id) {
+	case ROLLING_PROP_STATISTIC:
+		sop->statistic = g_value_get_int(value);
+		break;
+	case ROLLING_PROP_WINDOW:
+		sop->window = g_value_get_int(value);
+		break;
+	case ROLLING_PROP_WINDOW_TIME:
+		sop->window_time = g_value_get_double(value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void
+y_rolling_stats_operation_get_property(GObject * gobject, guint param_id,
+				       GValue * value, GParamSpec * pspec)
+{
+	YRollingStatsOperation *sop = Y_ROLLING_STATS_OPERATION(gobject);
+
+	switch (param_id) {
+	case ROLLING_PROP_STATISTIC:
+		g_value_set_int(value, sop->statistic);
+		break;
+	case ROLLING_PROP_WINDOW:
+		g_value_set_int(value, sop->window);
+		break;
+	case ROLLING_PROP_WINDOW_TIME:
+		g_value_set_double(value, sop->window_time);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static
+int rolling_size(YOperation * op, YData * input, unsigned int *dims)
+{
+	g_assert(dims);
+	g_assert(Y_IS_VECTOR(input));
+	dims[0] = y_vector_get_len(Y_VECTOR(input));
+	return 1;
+}
+
+/* double-ended queue of doubles in a growable circular buffer */
+typedef struct {
+	double *v;
+	unsigned int cap;
+	unsigned int head;
+	unsigned int len;
+} Queue;
+
+static inline double queue_get(const Queue * q, unsigned int i)
+{
+	return q->v[(q->head + i) & (q->cap - 1)];
+}
+
+static inline double queue_front(const Queue * q)
+{
+	return q->v[q->head];
+}
+
+static inline double queue_back(const Queue * q)
+{
+	return queue_get(q, q->len - 1);
+}
+
+static void queue_push_back(Queue * q, double x)
+{
+	if (q->len == q->cap) {
+		/* the capacity is kept a power of two */
+		unsigned int cap = q->cap ? 2 * q->cap : 64;
+		double *v = g_new(double, cap);
+		unsigned int i;
+		for (i = 0; i < q->len; i++) {
+			v[i] = queue_get(q, i);
+		}
+		g_free(q->v);
+		q->v = v;
+		q->cap = cap;
+		q->head = 0;
+	}
+	q->v[(q->head + q->len) & (q->cap - 1)] = x;
+	q->len++;
+}
+
+static inline void queue_pop_back(Queue * q)
+{
+	q->len--;
+}
+
+static inline void queue_pop_front(Queue * q)
+{
+	q->head = (q->head + 1) & (q->cap - 1);
+	q->len--;
+}
+
+static inline void queue_clear(Queue * q)
+{
+	q->head = 0;
+	q->len = 0;
+}
+
+typedef struct {
+	YRollingStatsOperation sop;
+	gboolean use_time;
+	/* samples in the window, with their times */
+	Queue win;
+	Queue wint;
+	/* nondecreasing and nonincreasing finite values for the minimum and
+	 * maximum */
+	Queue qmin;
+	Queue qmax;
+	double mean;
+	double m2;
+	unsigned int removed;
+	/* samples not yet processed */
+	double *input;
+	double *times;
+	unsigned int n_input;
+	unsigned int input_size;
+	/* the output holds samples out_first to out_first+out_len */
+	guint64 first;
+	guint64 out_first;
+	unsigned int out_len;
+	guint64 seen;
+	gboolean started;
+	double *output;
+	unsigned int output_size;
+} RollingOpData;
+
+static void rolling_clear(RollingOpData * d)
+{
+	queue_clear(&d->win);
+	queue_clear(&d->wint);
+	queue_clear(&d->qmin);
+	queue_clear(&d->qmax);
+	d->mean = 0.0;
+	d->m2 = 0.0;
+	d->removed = 0;
+}
+
+static
+gpointer rolling_op_create_data(YOperation * op, gpointer data, YData * input)
+{
+	if (input == NULL)
+		return NULL;
+	RollingOpData *d;
+	YRollingStatsOperation *sop = Y_ROLLING_STATS_OPERATION(op);
+	YVector *vec = Y_VECTOR(input);
+	unsigned int n = y_vector_get_len(vec);
+	const double *v = y_vector_get_values(vec);
+	const double *t = NULL;
+	if (Y_IS_RING_VECTOR(input) && sop->window_time > 0.0) {
+		YRingVector *ts =
+		    y_ring_vector_get_timestamps(Y_RING_VECTOR(input));
+		if (ts != NULL && y_vector_get_len(Y_VECTOR(ts)) == n) {
+			t = y_vector_get_values(Y_VECTOR(ts));
+		}
+	}
+	if (data == NULL) {
+		d = g_new0(RollingOpData, 1);
+	} else {
+		d = (RollingOpData *) data;
+		if (d->sop.statistic != sop->statistic
+		    || d->sop.window != sop->window
+		    || d->sop.window_time != sop->window_time
+		    || d->use_time != (t != NULL)) {
+			d->started = FALSE;
+		}
+	}
+	d->sop = *sop;
+	d->use_time = t != NULL;
+
+	guint64 total = n;
+	if (Y_IS_RING_VECTOR(input)) {
+		total = y_ring_vector_get_n_appended(Y_RING_VECTOR(input));
+	} else {
+		/* no way to tell what is new, so start over */
+		d->started = FALSE;
+	}
+	guint64 first = total - n;	/* sample number of v[0] */
+	if (!d->started || d->seen < first || d->n_input + total - d->seen > n) {
+		rolling_clear(d);
+		d->seen = first;
+		d->out_first = first;
+		d->out_len = 0;
+		d->n_input = 0;
+		d->started = TRUE;
+	}
+	d->first = first;
+	unsigned int nnew = total - d->seen;
+	if (d->n_input + nnew > d->input_size) {
+		d->input_size = d->n_input + nnew;
+		d->input = g_renew(double, d->input, d->input_size);
+		d->times = g_renew(double, d->times, d->input_size);
+	}
+	memcpy(d->input + d->n_input, v + (d->seen - first),
+	       nnew * sizeof(double));
+	if (t != NULL) {
+		memcpy(d->times + d->n_input, t + (d->seen - first),
+		       nnew * sizeof(double));
+	} else {
+		memset(d->times + d->n_input, 0, nnew * sizeof(double));
+	}
+	d->n_input += nnew;
+	d->seen = total;
+	if (n > d->output_size) {
+		/* keeps the values already computed */
+		d->output_size = n;
+		d->output = g_renew(double, d->output, d->output_size);
+	}
+	return d;
+}
+
+static
+void rolling_op_data_free(gpointer data)
+{
+	RollingOpData *d = (RollingOpData *) data;
+	g_free(d->win.v);
+	g_free(d->wint.v);
+	g_free(d->qmin.v);
+	g_free(d->qmax.v);
+	g_free(d->input);
+	g_free(d->times);
+	g_free(d->output);
+	g_free(d);
+}
+
+/* recompute the mean and variance from the window */
+static void rolling_resync(RollingOpData * d)
+{
+	unsigned int i;
+	unsigned int n = d->win.len;
+	double mean = 0.0;
+	double m2 = 0.0;
+	for (i = 0; i < n; i++) {
+		mean += queue_get(&d->win, i);
+	}
+	mean /= n;
+	for (i = 0; i < n; i++) {
+		double dx = queue_get(&d->win, i) - mean;
+		m2 += dx * dx;
+	}
+	d->mean = mean;
+	d->m2 = m2;
+	d->removed = 0;
+}
+
+static void rolling_remove(RollingOpData * d)
+{
+	double y = queue_front(&d->win);
+	queue_pop_front(&d->win);
+	queue_pop_front(&d->wint);
+	if (d->qmin.len > 0 && queue_front(&d->qmin) == y) {
+		queue_pop_front(&d->qmin);
+	}
+	if (d->qmax.len > 0 && queue_front(&d->qmax) == y) {
+		queue_pop_front(&d->qmax);
+	}
+	double delta = y - d->mean;
+	d->mean -= delta / d->win.len;
+	d->m2 -= delta * (y - d->mean);
+	d->removed++;
+	if (d->removed > d->win.len) {
+		rolling_resync(d);
+	}
+}
+
+static double rolling_add(RollingOpData * d, double x, double t)
+{
+	queue_push_back(&d->win, x);
+	queue_push_back(&d->wint, t);
+	/* a NaN would never compare equal when it leaves the window */
+	if (isfinite(x)) {
+		while (d->qmin.len > 0 && queue_back(&d->qmin) > x) {
+			queue_pop_back(&d->qmin);
+		}
+		queue_push_back(&d->qmin, x);
+		while (d->qmax.len > 0 && queue_back(&d->qmax) < x) {
+			queue_pop_back(&d->qmax);
+		}
+		queue_push_back(&d->qmax, x);
+	}
+	double delta = x - d->mean;
+	d->mean += delta / d->win.len;
+	d->m2 += delta * (x - d->mean);
+
+	if (d->use_time) {
+		while (d->win.len > 1
+		       && queue_front(&d->wint) <= t - d->sop.window_time) {
+			rolling_remove(d);
+		}
+	} else {
+		while (d->win.len > MAX(d->sop.window, 1)) {
+			rolling_remove(d);
+		}
+	}
+
+	double var = d->win.len > 1 ? MAX(d->m2, 0.0) / (d->win.len - 1) : 0.0;
+	switch (d->sop.statistic) {
+	case ROLLING_VARIANCE:
+		return var;
+	case ROLLING_STDDEV:
+		return sqrt(var);
+	case ROLLING_MIN:
+		return d->qmin.len > 0 ? queue_front(&d->qmin) : NAN;
+	case ROLLING_MAX:
+		return d->qmax.len > 0 ? queue_front(&d->qmax) : NAN;
+	default:
+		return d->mean;
+	}
+}
+
+static
+gpointer rolling_op(gpointer input)
+{
+	RollingOpData *d = (RollingOpData *) input;
+
+	if (d == NULL)
+		return NULL;
+
+	/* drop the outputs of samples that have left the ring */
+	guint64 shift = d->first - d->out_first;
+	unsigned int keep = shift < d->out_len ? d->out_len - shift : 0;
+	if (keep > 0 && shift > 0) {
+		memmove(d->output, d->output + shift, keep * sizeof(double));
+	}
+	unsigned int i;
+	for (i = 0; i < d->n_input; i++) {
+		d->output[keep + i] = rolling_add(d, d->input[i], d->times[i]);
+	}
+	d->out_first = d->first;
+	d->out_len = keep + d->n_input;
+	d->n_input = 0;
+	return d->output;
+}
+
+static void y_rolling_stats_operation_class_init(YRollingStatsOperationClass *
+						 klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->set_property = y_rolling_stats_operation_set_property;
+	gobject_klass->get_property = y_rolling_stats_operation_get_property;
+	YOperationClass *op_klass = (YOperationClass *) klass;
+	op_klass->thread_safe = TRUE;
+	op_klass->op_size = rolling_size;
+	op_klass->op_func = rolling_op;
+	op_klass->op_data = rolling_op_create_data;
+	op_klass->op_data_free = rolling_op_data_free;
+
+	g_object_class_install_property(gobject_klass, ROLLING_PROP_STATISTIC,
+					g_param_spec_int("statistic",
+							 "Statistic",
+							 "Which statistic to output",
+							 ROLLING_MEAN,
+							 ROLLING_MAX,
+							 ROLLING_MEAN,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, ROLLING_PROP_WINDOW,
+					g_param_spec_int("window", "Window",
+							 "Number of samples in the window",
+							 1, G_MAXINT, 100,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass,
+					ROLLING_PROP_WINDOW_TIME,
+					g_param_spec_double("window-time",
+							    "Window time",
+							    "Length of the window in seconds, or 0 to use the number of samples",
+							    0.0, G_MAXDOUBLE,
+							    0.0,
+							    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void y_rolling_stats_operation_init(YRollingStatsOperation * sop)
+{
+	g_assert(Y_IS_ROLLING_STATS_OPERATION(sop));
+	sop->statistic = ROLLING_MEAN;
+	sop->window = 100;
+	sop->window_time = 0.0;
+}
+
+/**
+ * y_rolling_stats_operation_new:
+ * @statistic: the statistic, e.g. %ROLLING_MEAN or %ROLLING_MAX
+ * @window: number of samples in the window
+ *
+ * Create a new rolling statistics operation.
+ *
+ * Returns: a #YOperation
+ **/
+YOperation *y_rolling_stats_operation_new(int statistic, unsigned int window)
+{
+	return g_object_new(Y_TYPE_ROLLING_STATS_OPERATION, "statistic",
+			    statistic, "window", window, NULL);
+}
@@ -0,0 +1,47 @@
+/*
+ * y-rolling-stats-operation.h :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef OP_ROLLING_STATS_H
+#define OP_ROLLING_STATS_H
+
+#include <y-data-class.h>
+#include <y-operation.h>
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE(YRollingStatsOperation,y_rolling_stats_operation,Y,ROLLING_STATS_OPERATION,YOperation)
+
+#define Y_TYPE_ROLLING_STATS_OPERATION  (y_rolling_stats_operation_get_type ())
+
+/* statistic to output */
+enum {
+	ROLLING_MEAN = 0,
+	ROLLING_VARIANCE,
+	ROLLING_STDDEV,
+	ROLLING_MIN,
+	ROLLING_MAX
+};
+
+YOperation *y_rolling_stats_operation_new (int statistic, unsigned int window);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,413 @@
+/*
+ * y-sliding-dft-operation.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <memory.h>
+#include <math.h>
+#include <complex.h>
+#include "y-sliding-dft-operation.h"
+#include "y-vector-ring.h"
+
+/**
+ * SECTION: y-sliding-dft-operation
+ * @short_description: Operation that tracks a few frequency bins of a stream.
+ *
+ * This operation computes the discrete Fourier transform of the last
+ * "length" samples of the input, but only at a few frequencies, given in
+ * units of cycles per "length" samples by the "bins" property. Bins do not
+ * have to be integers. The output has one element per bin (two for
+ * %FFT_COMPLEX and %FFT_MAG_PHASE), with the same normalization and phase
+ * convention as the output of #YFFTOperation on the last "length" samples.
+ * Individual bins can be pulled out as scalars with a #YSliceOperation.
+ *
+ * When the input is a #YRingVector, each new sample updates every bin with
+ * the sliding DFT recursion, at a fixed cost per sample and bin, using
+ * y_ring_vector_get_n_appended() to find the samples appended since the
+ * operation last ran. To keep rounding errors from accumulating, the bins
+ * are recomputed from the stored window once every "length" samples, which
+ * does not change the cost per sample. Until "length" samples have arrived,
+ * the missing ones are treated as zero. For other vectors, the bins are
+ * computed from scratch each time.
+ *
+ * Changing "length" or "bins" restarts the computation from the data
+ * currently in the input.
+ */
+
+enum {
+	SLIDING_DFT_PROP_0,
+	SLIDING_DFT_PROP_LENGTH,
+	SLIDING_DFT_PROP_BINS,
+	SLIDING_DFT_PROP_TYPE,
+	N_PROPERTIES
+};
+
+struct _YSlidingDFTOperation {
+	YOperation base;
+	int length;
+	GArray *bins;
+	guchar type;
+};
+
+G_DEFINE_TYPE(YSlidingDFTOperation, y_sliding_dft_operation,
+	      Y_TYPE_OPERATION);
+
+static GArray *bins_copy(const double *bins, unsigned int n)
+{
+	GArray *a = g_array_sized_new(FALSE, FALSE, sizeof(double), n);
+	g_array_append_vals(a, bins, n);
+	return a;
+}
+
+static void
+y_sliding_dft_operation_set_property(GObject * gobject, guint param_id,
+				     GValue const *value, GParamSpec * pspec)
+{
+	YSlidingDFTOperation *sop = Y_SLIDING_DFT_OPERATION(gobject);
+
+	switch (param_id) {
+	case SLIDING_DFT_PROP_LENGTH:
+		sop->length = g_value_get_int(value);
+		break;
+	case SLIDING_DFT_PROP_BINS:
+		{
+			GArray *a = g_value_get_boxed(value);
+			g_array_unref(sop->bins);
+			if (a == NULL) {
+				sop->bins = bins_copy(NULL, 0);
+			} else {
+				sop->bins =
+				    bins_copy((const double *)a->data, a->len);
+			}
+		}
+		break;
+	case SLIDING_DFT_PROP_TYPE:
+		sop->type = g_value_get_int(value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void
+y_sliding_dft_operation_get_property(GObject * gobject, guint param_id,
+				     GValue * value, GParamSpec * pspec)
+{
+	YSlidingDFTOperation *sop = Y_SLIDING_DFT_OPERATION(gobject);
+
+	switch (param_id) {
+	case SLIDING_DFT_PROP_LENGTH:
+		g_value_set_int(value, sop->length);
+		break;
+	case SLIDING_DFT_PROP_BINS:
+		g_value_set_boxed(value, sop->bins);
+		break;
+	case SLIDING_DFT_PROP_TYPE:
+		g_value_set_int(value, sop->type);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void y_sliding_dft_operation_finalize(GObject * obj)
+{
+	YSlidingDFTOperation *sop = Y_SLIDING_DFT_OPERATION(obj);
+	g_array_unref(sop->bins);
+	G_OBJECT_CLASS(y_sliding_dft_operation_parent_class)->finalize(obj);
+}
+
+static
+int sliding_dft_size(YOperation * op, YData * input, unsigned int *dims)
+{
+	g_assert(Y_IS_VECTOR(input));
+	g_assert(dims);
+	YSlidingDFTOperation *sop = Y_SLIDING_DFT_OPERATION(op);
+	dims[0] = sop->bins->len * y_fft_output_width(sop->type);
+	return 1;
+}
+
+typedef struct {
+	YSlidingDFTOperation sop;	/* bins is not valid in the copy */
+	unsigned int n_bins;
+	double *bins;
+	complex double *rot;	/* e^(iw) */
+	complex double *tail;	/* e^(-iw(N-1)) */
+	complex double *sum;	/* current value of each bin */
+	double *hist;		/* the last N samples, circular */
+	unsigned int pos;	/* index of the oldest sample in hist */
+	unsigned int since_sync;
+	/* samples appended since the operation last ran */
+	double *pending;
+	unsigned int n_pending;
+	unsigned int pending_size;
+	guint64 seen;		/* sample number after the last one seen */
+	gboolean started;
+	double *output;
+} SlidingDFTOpData;
+
+static gboolean sliding_dft_pars_equal(const SlidingDFTOpData * d,
+				       const YSlidingDFTOperation * sop)
+{
+	return d->sop.length == sop->length && d->n_bins == sop->bins->len
+	    && memcmp(d->bins, sop->bins->data,
+		      d->n_bins * sizeof(double)) == 0;
+}
+
+static void sliding_dft_clear(SlidingDFTOpData * d)
+{
+	memset(d->hist, 0, d->sop.length * sizeof(double));
+	memset(d->sum, 0, d->n_bins * sizeof(complex double));
+	d->pos = 0;
+	d->since_sync = 0;
+	d->n_pending = 0;
+	d->started = FALSE;
+}
+
+static void sliding_dft_reset(SlidingDFTOpData * d,
+			      const YSlidingDFTOperation * sop)
+{
+	unsigned int n = sop->length;
+	unsigned int k;
+	g_free(d->bins);
+	g_free(d->rot);
+	g_free(d->tail);
+	g_free(d->sum);
+	g_free(d->hist);
+	d->n_bins = sop->bins->len;
+	d->bins = g_memdup(sop->bins->data, d->n_bins * sizeof(double));
+	d->rot = g_new(complex double, d->n_bins);
+	d->tail = g_new(complex double, d->n_bins);
+	d->sum = g_new(complex double, d->n_bins);
+	d->hist = g_new(double, n);
+	for (k = 0; k < d->n_bins; k++) {
+		double w = 2 * G_PI * d->bins[k] / n;
+		d->rot[k] = cexp(I * w);
+		d->tail[k] = cexp(-I * w * (n - 1));
+	}
+	d->sop.length = n;
+	sliding_dft_clear(d);
+}
+
+static void sliding_dft_add_pending(SlidingDFTOpData * d, const double *v,
+				    unsigned int n)
+{
+	if (d->n_pending + n > d->pending_size) {
+		d->pending_size = d->n_pending + n;
+		d->pending = g_renew(double, d->pending, d->pending_size);
+	}
+	memcpy(d->pending + d->n_pending, v, n * sizeof(double));
+	d->n_pending += n;
+}
+
+static
+gpointer sliding_dft_op_create_data(YOperation * op, gpointer data,
+				    YData * input)
+{
+	if (input == NULL)
+		return NULL;
+	g_return_val_if_fail(Y_IS_VECTOR(input), NULL);
+	SlidingDFTOpData *d;
+	YSlidingDFTOperation *sop = Y_SLIDING_DFT_OPERATION(op);
+	gboolean reset = FALSE;
+	if (data == NULL) {
+		d = g_new0(SlidingDFTOpData, 1);
+		reset = TRUE;
+	} else {
+		d = (SlidingDFTOpData *) data;
+		reset = !sliding_dft_pars_equal(d, sop);
+	}
+	if (reset) {
+		sliding_dft_reset(d, sop);
+	}
+	d->sop = *sop;
+	d->sop.bins = NULL;
+	unsigned int width = y_fft_output_width(d->sop.type);
+	d->output = g_renew(double, d->output, MAX(d->n_bins * width, 1));
+
+	YVector *vec = Y_VECTOR(input);
+	unsigned int n = y_vector_get_len(vec);
+	const double *v = y_vector_get_values(vec);
+	guint64 total = n;
+	if (Y_IS_RING_VECTOR(input)) {
+		total = y_ring_vector_get_n_appended(Y_RING_VECTOR(input));
+	} else if (d->started) {
+		/* no way to tell what is new, so start over */
+		sliding_dft_clear(d);
+	}
+	guint64 first = total - n;	/* sample number of v[0] */
+	guint64 len = d->sop.length;
+	guint64 next = d->started ? d->seen : first;
+	if (next < first || total - next > len) {
+		/* samples were lost, or only the last "length" of the new
+		 * ones matter; either way start from a clean window */
+		sliding_dft_clear(d);
+		next = MAX(first, total > len ? total - len : 0);
+	}
+	d->started = TRUE;
+	if (next < total) {
+		sliding_dft_add_pending(d, v + (next - first), total - next);
+	}
+	d->seen = total;
+	return d;
+}
+
+static
+void sliding_dft_op_data_free(gpointer data)
+{
+	SlidingDFTOpData *d = (SlidingDFTOpData *) data;
+	g_free(d->bins);
+	g_free(d->rot);
+	g_free(d->tail);
+	g_free(d->sum);
+	g_free(d->hist);
+	g_free(d->pending);
+	g_free(d->output);
+	g_free(d);
+}
+
+/* recompute each bin directly from the window */
+static void sliding_dft_sync(SlidingDFTOpData * d)
+{
+	unsigned int n = d->sop.length;
+	unsigned int k, m;
+	for (k = 0; k < d->n_bins; k++) {
+		complex double step = conj(d->rot[k]);
+		complex double ph = 1.0;
+		complex double s = 0.0;
+		for (m = 0; m < n; m++) {
+			s += d->hist[(d->pos + m) % n] * ph;
+			ph *= step;
+		}
+		d->sum[k] = s;
+	}
+	d->since_sync = 0;
+}
+
+static
+gpointer sliding_dft_op(gpointer input)
+{
+	SlidingDFTOpData *d = (SlidingDFTOpData *) input;
+
+	if (d == NULL)
+		return NULL;
+
+	unsigned int n = d->sop.length;
+	unsigned int i, k;
+	for (i = 0; i < d->n_pending; i++) {
+		double x = d->pending[i];
+		double old = d->hist[d->pos];
+		d->hist[d->pos] = x;
+		d->pos = (d->pos + 1) % n;
+		for (k = 0; k < d->n_bins; k++) {
+			d->sum[k] = d->rot[k] * (d->sum[k] - old) +
+			    x * d->tail[k];
+		}
+		if (++d->since_sync == n) {
+			sliding_dft_sync(d);
+		}
+	}
+	d->n_pending = 0;
+
+	y_fft_write_output(d->sop.type, (const fftw_complex *)d->sum,
+			   d->output, d->n_bins);
+	return d->output;
+}
+
+static void
+y_sliding_dft_operation_class_init(YSlidingDFTOperationClass * klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->set_property = y_sliding_dft_operation_set_property;
+	gobject_klass->get_property = y_sliding_dft_operation_get_property;
+	gobject_klass->finalize = y_sliding_dft_operation_finalize;
+	YOperationClass *op_klass = (YOperationClass *) klass;
+	op_klass->thread_safe = TRUE;
+	op_klass->op_size = sliding_dft_size;
+	op_klass->op_func = sliding_dft_op;
+	op_klass->op_data = sliding_dft_op_create_data;
+	op_klass->op_data_free = sliding_dft_op_data_free;
+
+	g_object_class_install_property(gobject_klass, SLIDING_DFT_PROP_LENGTH,
+					g_param_spec_int("length", "Length",
+							 "Number of samples in the transform",
+							 1, 1 << 24, 1024,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, SLIDING_DFT_PROP_BINS,
+					g_param_spec_boxed("bins", "Bins",
+							   "Array of doubles holding the frequencies to track, in cycles per length",
+							   G_TYPE_ARRAY,
+							   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, SLIDING_DFT_PROP_TYPE,
+					g_param_spec_int("type", "Type",
+							 "What to output for each bin",
+							 FFT_MAG, FFT_MAG_PHASE,
+							 FFT_MAG,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void y_sliding_dft_operation_init(YSlidingDFTOperation * sop)
+{
+	g_assert(Y_IS_SLIDING_DFT_OPERATION(sop));
+	sop->length = 1024;
+	sop->bins = bins_copy(NULL, 0);
+	sop->type = FFT_MAG;
+}
+
+/**
+ * y_sliding_dft_operation_set_bins:
+ * @op: a #YSlidingDFTOperation
+ * @bins: (array length=n_bins): frequencies to track, in cycles per length
+ * @n_bins: number of bins
+ *
+ * Set the frequencies to track.
+ **/
+void y_sliding_dft_operation_set_bins(YSlidingDFTOperation * op,
+				      const double *bins,
+				      unsigned int n_bins)
+{
+	g_return_if_fail(Y_IS_SLIDING_DFT_OPERATION(op));
+	GArray *a = bins_copy(bins, n_bins);
+	g_object_set(op, "bins", a, NULL);
+	g_array_unref(a);
+}
+
+/**
+ * y_sliding_dft_operation_new:
+ * @length: number of samples in the transform
+ * @bins: (array length=n_bins): frequencies to track, in cycles per length
+ * @n_bins: number of bins
+ *
+ * Create a new sliding DFT operation.
+ *
+ * Returns: a #YOperation
+ **/
+YOperation *y_sliding_dft_operation_new(int length, const double *bins,
+					unsigned int n_bins)
+{
+	YOperation *o = g_object_new(Y_TYPE_SLIDING_DFT_OPERATION,
+				     "length", length, NULL);
+	y_sliding_dft_operation_set_bins(Y_SLIDING_DFT_OPERATION(o), bins,
+					 n_bins);
+	return o;
+}
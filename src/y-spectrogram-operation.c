@@ -0,0 +1,405 @@
+/*
+ * y-spectrogram-operation.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <memory.h>
+#include <math.h>
+#include "y-spectrogram-operation.h"
+#include "y-vector-ring.h"
+
+/**
+ * SECTION: y-spectrogram-operation
+ * @short_description: Operation that computes a spectrogram of a vector.
+ *
+ * This operation takes windowed Fourier transforms of successive segments of
+ * the input, "window-length" samples long and starting every "hop" samples,
+ * so successive segments overlap by window-length minus hop samples. Each
+ * spectrum is a row of the output matrix, with the newest at the bottom. The
+ * output always has "rows" rows; rows that have not been filled yet are zero.
+ *
+ * When the input is a #YRingVector, the operation keeps track of which
+ * samples it has already seen, using y_ring_vector_get_n_appended(), and only
+ * transforms segments that were completed since it last ran. The previous
+ * rows are kept, so the cost per new sample does not depend on the size of
+ * the ring. For other vectors, the whole spectrogram is recomputed each time.
+ *
+ * Changing any property restarts the spectrogram from the data currently in
+ * the input.
+ */
+
+enum {
+	SPECTROGRAM_PROP_0,
+	SPECTROGRAM_PROP_WINDOW_LENGTH,
+	SPECTROGRAM_PROP_HOP,
+	SPECTROGRAM_PROP_WINDOW,
+	SPECTROGRAM_PROP_TYPE,
+	SPECTROGRAM_PROP_ROWS,
+	SPECTROGRAM_PROP_RIGOR,
+	N_PROPERTIES
+};
+
+struct _YSpectrogramOperation {
+	YOperation base;
+	int window_length;
+	int hop;
+	int rows;
+	guchar window;
+	guchar type;
+	guchar rigor;
+};
+
+G_DEFINE_TYPE(YSpectrogramOperation, y_spectrogram_operation,
+	      Y_TYPE_OPERATION);
+
+static void
+y_spectrogram_operation_set_property(GObject * gobject, guint param_id,
+				     GValue const *value, GParamSpec * pspec)
+{
+	YSpectrogramOperation *sop = Y_SPECTROGRAM_OPERATION(gobject);
+
+	switch (param_id) {
+	case SPECTROGRAM_PROP_WINDOW_LENGTH:
+		sop->window_length = g_value_get_int(value);
+		break;
+	case SPECTROGRAM_PROP_HOP:
+		sop->hop = g_value_get_int(value);
+		break;
+	case SPECTROGRAM_PROP_WINDOW:
+		sop->window = g_value_get_int(value);
+		break;
+	case SPECTROGRAM_PROP_TYPE:
+		sop->type = g_value_get_int(value);
+		break;
+	case SPECTROGRAM_PROP_ROWS:
+		sop->rows = g_value_get_int(value);
+		break;
+	case SPECTROGRAM_PROP_RIGOR:
+		sop->rigor = g_value_get_int(value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static void
+y_spectrogram_operation_get_property(GObject * gobject, guint param_id,
+				     GValue * value, GParamSpec * pspec)
+{
+	YSpectrogramOperation *sop = Y_SPECTROGRAM_OPERATION(gobject);
+
+	switch (param_id) {
+	case SPECTROGRAM_PROP_WINDOW_LENGTH:
+		g_value_set_int(value, sop->window_length);
+		break;
+	case SPECTROGRAM_PROP_HOP:
+		g_value_set_int(value, sop->hop);
+		break;
+	case SPECTROGRAM_PROP_WINDOW:
+		g_value_set_int(value, sop->window);
+		break;
+	case SPECTROGRAM_PROP_TYPE:
+		g_value_set_int(value, sop->type);
+		break;
+	case SPECTROGRAM_PROP_ROWS:
+		g_value_set_int(value, sop->rows);
+		break;
+	case SPECTROGRAM_PROP_RIGOR:
+		g_value_set_int(value, sop->rigor);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID(gobject, param_id, pspec);
+		return;		/* NOTE : RETURN */
+	}
+}
+
+static
+int spectrogram_size(YOperation * op, YData * input, unsigned int *dims)
+{
+	g_assert(Y_IS_VECTOR(input));
+	g_assert(dims);
+	YSpectrogramOperation *sop = Y_SPECTROGRAM_OPERATION(op);
+	dims[0] = sop->window_length / 2 + 1;
+	dims[1] = sop->rows;
+	return 2;
+}
+
+typedef struct {
+	YSpectrogramOperation sop;
+	/* input samples not yet consumed; buf[0] is sample number buf_start */
+	double *buf;
+	unsigned int buf_len;
+	unsigned int buf_size;
+	guint64 buf_start;
+	gboolean started;
+	double *window;
+	double *in;
+	fftw_complex *inter;
+	fftw_plan plan;
+	unsigned int nbins;
+	double *output;
+} SpectrogramOpData;
+
+static gboolean spectrogram_pars_equal(const YSpectrogramOperation * a,
+				       const YSpectrogramOperation * b)
+{
+	return a->window_length == b->window_length && a->hop == b->hop
+	    && a->rows == b->rows && a->window == b->window
+	    && a->type == b->type;
+}
+
+static void spectrogram_reset(SpectrogramOpData * d)
+{
+	unsigned int n = d->sop.window_length;
+	fftw_free(d->in);
+	fftw_free(d->inter);
+	g_free(d->window);
+	g_free(d->output);
+	d->nbins = n / 2 + 1;
+	d->in = fftw_alloc_real(n);
+	d->inter = fftw_alloc_complex(d->nbins);
+	d->window = g_new(double, n);
+	y_fft_window_fill(d->sop.window, d->window, n);
+	d->output = g_new0(double, (gsize) d->nbins * d->sop.rows);
+	d->buf_len = 0;
+	d->started = FALSE;
+}
+
+static
+gpointer spectrogram_op_create_data(YOperation * op, gpointer data,
+				    YData * input)
+{
+	if (input == NULL)
+		return NULL;
+	g_return_val_if_fail(Y_IS_VECTOR(input), NULL);
+	SpectrogramOpData *d;
+	YSpectrogramOperation *sop = Y_SPECTROGRAM_OPERATION(op);
+	gboolean reset = FALSE;
+	if (data == NULL) {
+		d = g_new0(SpectrogramOpData, 1);
+		reset = TRUE;
+	} else {
+		d = (SpectrogramOpData *) data;
+		reset = !spectrogram_pars_equal(&d->sop, sop);
+	}
+	d->sop = *sop;
+	if (reset) {
+		spectrogram_reset(d);
+	}
+	y_fft_plan_release(d->plan);
+	d->plan = y_fft_plan_r2c_1d(d->sop.window_length, d->in, d->inter,
+				    d->sop.rigor);
+
+	YVector *vec = Y_VECTOR(input);
+	unsigned int n = y_vector_get_len(vec);
+	const double *v = y_vector_get_values(vec);
+	guint64 total = n;
+	if (Y_IS_RING_VECTOR(input)) {
+		total = y_ring_vector_get_n_appended(Y_RING_VECTOR(input));
+	} else if (d->started) {
+		/* no way to tell what is new, so start over */
+		memset(d->output, 0, sizeof(double) * d->nbins * d->sop.rows);
+		d->started = FALSE;
+	}
+	guint64 first = total - n;	/* sample number of v[0] */
+	if (!d->started) {
+		d->buf_start = first;
+		d->buf_len = 0;
+		d->started = TRUE;
+	}
+	guint64 next = d->buf_start + d->buf_len;
+	if (next < first) {
+		/* samples were lost before we saw them */
+		d->buf_start = first;
+		d->buf_len = 0;
+		next = first;
+	}
+	/* only the last "rows" segments can be displayed */
+	guint64 hop = d->sop.hop;
+	guint64 needed = (guint64) (d->sop.rows - 1) * hop +
+	    d->sop.window_length;
+	if (total > d->buf_start + needed) {
+		guint64 skip = (total - d->buf_start - needed + hop - 1) / hop
+		    * hop;
+		if (skip < d->buf_len) {
+			memmove(d->buf, d->buf + skip,
+				(d->buf_len - skip) * sizeof(double));
+			d->buf_len -= skip;
+		} else {
+			d->buf_len = 0;
+		}
+		d->buf_start += skip;
+		next = MAX(next, d->buf_start);
+	}
+	if (next < total) {
+		unsigned int nnew = total - next;
+		if (d->buf_len + nnew > d->buf_size) {
+			d->buf_size = d->buf_len + nnew;
+			d->buf = g_renew(double, d->buf, d->buf_size);
+		}
+		memcpy(d->buf + d->buf_len, v + (next - first),
+		       nnew * sizeof(double));
+		d->buf_len += nnew;
+	}
+	return d;
+}
+
+static
+void spectrogram_op_data_free(gpointer data)
+{
+	SpectrogramOpData *d = (SpectrogramOpData *) data;
+	y_fft_plan_release(d->plan);
+	g_free(d->buf);
+	g_free(d->window);
+	fftw_free(d->in);
+	fftw_free(d->inter);
+	g_free(d->output);
+	g_free(d);
+}
+
+static
+gpointer spectrogram_op(gpointer input)
+{
+	SpectrogramOpData *d = (SpectrogramOpData *) input;
+
+	if (d == NULL || d->plan == NULL)
+		return NULL;
+
+	unsigned int wl = d->sop.window_length;
+	unsigned int hop = d->sop.hop;
+	unsigned int rows = d->sop.rows;
+	unsigned int nbins = d->nbins;
+	if (d->buf_len < wl)
+		return d->output;
+	unsigned int k = (d->buf_len - wl) / hop + 1;	/* completed segments */
+
+	/* scroll the old rows up */
+	if (k < rows) {
+		memmove(d->output, d->output + (gsize) k * nbins,
+			(gsize) (rows - k) * nbins * sizeof(double));
+	}
+	unsigned int s, i;
+	for (s = (k > rows) ? k - rows : 0; s < k; s++) {
+		const double *x = d->buf + (gsize) s * hop;
+		for (i = 0; i < wl; i++) {
+			d->in[i] = x[i] * d->window[i];
+		}
+		fftw_execute_dft_r2c(d->plan, d->in, d->inter);
+		y_fft_write_output(d->sop.type, d->inter,
+				   d->output + (gsize) (rows - k + s) * nbins,
+				   nbins);
+	}
+
+	/* drop the samples that no segment will need again */
+	guint64 consumed = (guint64) k * hop;
+	if (consumed < d->buf_len) {
+		memmove(d->buf, d->buf + consumed,
+			(d->buf_len - consumed) * sizeof(double));
+		d->buf_len -= consumed;
+	} else {
+		d->buf_len = 0;
+	}
+	d->buf_start += consumed;
+	return d->output;
+}
+
+static void
+y_spectrogram_operation_class_init(YSpectrogramOperationClass * klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->set_property = y_spectrogram_operation_set_property;
+	gobject_klass->get_property = y_spectrogram_operation_get_property;
+	YOperationClass *op_klass = (YOperationClass *) klass;
+	op_klass->thread_safe = TRUE;
+	op_klass->op_size = spectrogram_size;
+	op_klass->op_func = spectrogram_op;
+	op_klass->op_data = spectrogram_op_create_data;
+	op_klass->op_data_free = spectrogram_op_data_free;
+
+	g_object_class_install_property(gobject_klass,
+					SPECTROGRAM_PROP_WINDOW_LENGTH,
+					g_param_spec_int("window-length",
+							 "Window length",
+							 "Number of samples in each transform",
+							 2, 1 << 24, 256,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, SPECTROGRAM_PROP_HOP,
+					g_param_spec_int("hop", "Hop",
+							 "Number of samples between the starts of successive transforms",
+							 1, 1 << 24, 128,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, SPECTROGRAM_PROP_WINDOW,
+					g_param_spec_int("window", "Window",
+							 "Window function",
+							 FFT_WINDOW_RECTANGULAR,
+							 FFT_WINDOW_FLAT_TOP,
+							 FFT_WINDOW_HANN,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, SPECTROGRAM_PROP_TYPE,
+					g_param_spec_int("type", "Type",
+							 "What to output from each spectrum",
+							 FFT_MAG, FFT_LOG_POWER,
+							 FFT_POWER,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, SPECTROGRAM_PROP_ROWS,
+					g_param_spec_int("rows", "Rows",
+							 "Number of spectra to keep",
+							 1, 1 << 24, 100,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	g_object_class_install_property(gobject_klass, SPECTROGRAM_PROP_RIGOR,
+					g_param_spec_int("rigor", "Rigor",
+							 "How hard the FFTW planner should look for a fast plan",
+							 FFT_ESTIMATE, FFT_PATIENT,
+							 FFT_ESTIMATE,
+							 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void y_spectrogram_operation_init(YSpectrogramOperation * sop)
+{
+	g_assert(Y_IS_SPECTROGRAM_OPERATION(sop));
+	sop->window_length = 256;
+	sop->hop = 128;
+	sop->rows = 100;
+	sop->window = FFT_WINDOW_HANN;
+	sop->type = FFT_POWER;
+	sop->rigor = FFT_ESTIMATE;
+}
+
+/**
+ * y_spectrogram_operation_new:
+ * @window_length: number of samples in each transform
+ * @hop: number of samples between the starts of successive transforms
+ *
+ * Create a new spectrogram operation.
+ *
+ * Returns: a #YOperation
+ **/
+YOperation *y_spectrogram_operation_new(int window_length, int hop)
+{
+	YOperation *o = g_object_new(Y_TYPE_SPECTROGRAM_OPERATION,
+				     "window-length", window_length,
+				     "hop", hop, NULL);
+	return o;
+}
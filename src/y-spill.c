@@ -0,0 +1,518 @@
+/*
+ * y-spill.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <math.h>
+#include <string.h>
+#include <gio/gio.h>
+#include "y-spill.h"
+
+/**
+ * SECTION: y-spill
+ * @short_description: Extendable HDF5 dataset that ring data spills into.
+ *
+ * A #YSpill appends rows of data to an HDF5 dataset whose length is
+ * unlimited, so that a #YRingVector or #YRingMatrix can record a long
+ * experiment at full resolution without keeping it all in memory. Set it
+ * with y_ring_vector_set_spill() or y_ring_matrix_set_spill(), and the
+ * elements or rows that the ring throws away are written to disk instead
+ * of being lost. y_ring_vector_get_range() and y_ring_matrix_get_range()
+ * then read a time range from the spill and the ring together.
+ *
+ * The spill creates a group in the file holding a "values" dataset, with
+ * one column per ring column, and, if it tracks timestamps, a
+ * "timestamps" dataset. Rows are collected in memory into blocks of 4096,
+ * which are also the compressed chunks of the datasets, and each full block
+ * is written by a background thread, so appending to the ring does not wait
+ * for the disk. The first and last timestamp of each block are kept in
+ * memory, so a time range read only touches the blocks it needs.
+ *
+ * The writer thread makes its HDF5 calls while holding y_hdf5_lock(). HDF5
+ * is not thread safe across files, so see the HDF5 utilities for how other
+ * HDF5 code must be called while a spill exists.
+ *
+ * If a block can't be written, the spill stops writing, and the error is
+ * reported by y_spill_flush() and y_spill_read_range(). Rows written before
+ * the error can still be read.
+ */
+
+#define SPILL_BLOCK 4096
+#define DEFLATE_LEVEL 5
+
+typedef struct {
+	guint64 row0;
+	unsigned int n;
+	double *times;
+	double *values;
+} SpillBlock;
+
+typedef struct {
+	guint64 row0;
+	unsigned int n;
+	double t0, t1;
+} SpillIndex;
+
+struct _YSpill {
+	GObject base;
+	YFile *file;
+	unsigned int columns;
+	gboolean timed;
+	hid_t values_id;
+	hid_t times_id;
+	/* block being filled, owned by the main thread */
+	SpillBlock *pending;
+	GArray *index;
+	guint64 n_queued;	/* rows handed to the writer */
+	/* writer thread */
+	GThread *writer;
+	GAsyncQueue *queue;
+	GMutex lock;		/* protects the fields below */
+	GCond cond;
+	guint64 n_written;	/* rows the writer is done with */
+	guint64 n_good;		/* rows in the file, before any error */
+	GError *error;		/* first write error */
+};
+
+G_DEFINE_TYPE(YSpill, y_spill, G_TYPE_OBJECT);
+
+static SpillBlock spill_stop;
+
+static SpillBlock *spill_block_new(YSpill * s, guint64 row0)
+{
+	SpillBlock *b = g_new0(SpillBlock, 1);
+	b->row0 = row0;
+	b->values = g_new(double, SPILL_BLOCK * s->columns);
+	if (s->timed)
+		b->times = g_new(double, SPILL_BLOCK);
+	return b;
+}
+
+static void spill_block_free(SpillBlock * b)
+{
+	g_free(b->times);
+	g_free(b->values);
+	g_free(b);
+}
+
+/* write or read rows [row0, row0+n) of a dataset, with the HDF5 lock held */
+static gboolean spill_rows_h5(hid_t id, unsigned int columns, guint64 row0,
+			      unsigned int n, double *buf, gboolean write)
+{
+	int rank = columns > 1 ? 2 : 1;
+	hsize_t start[2] = { row0, 0 };
+	hsize_t count[2] = { n, columns };
+	if (write) {
+		hsize_t size[2] = { row0 + n, columns };
+		if (H5Dset_extent(id, size) < 0)
+			return FALSE;
+	}
+	hid_t fspace = H5Dget_space(id);
+	if (fspace < 0)
+		return FALSE;
+	hid_t mspace = H5Screate_simple(rank, count, NULL);
+	herr_t status = -1;
+	if (mspace >= 0
+	    && H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, NULL,
+				   count, NULL) >= 0) {
+		if (write)
+			status = H5Dwrite(id, H5T_NATIVE_DOUBLE, mspace, fspace,
+					  H5P_DEFAULT, buf);
+		else
+			status = H5Dread(id, H5T_NATIVE_DOUBLE, mspace, fspace,
+					 H5P_DEFAULT, buf);
+	}
+	if (mspace >= 0)
+		H5Sclose(mspace);
+	H5Sclose(fspace);
+	return status >= 0;
+}
+
+static gpointer spill_writer(gpointer data)
+{
+	YSpill *s = (YSpill *) data;
+	for (;;) {
+		SpillBlock *b = g_async_queue_pop(s->queue);
+		if (b == &spill_stop)
+			break;
+		/* after an error, later rows would leave a gap in the file */
+		gboolean ok = FALSE;
+		if (s->n_good == b->row0) {
+			y_hdf5_lock();
+			ok = spill_rows_h5(s->values_id, s->columns, b->row0,
+					   b->n, b->values, TRUE)
+			    && (!s->timed
+				|| spill_rows_h5(s->times_id, 1, b->row0, b->n,
+						 b->times, TRUE));
+			y_hdf5_unlock();
+		}
+		g_mutex_lock(&s->lock);
+		if (ok) {
+			s->n_good = b->row0 + b->n;
+		} else if (s->error == NULL) {
+			s->error = g_error_new(G_IO_ERROR, G_IO_ERROR_FAILED,
+					       "could not write rows %"
+					       G_GUINT64_FORMAT " to %"
+					       G_GUINT64_FORMAT
+					       " of spill, later rows are lost",
+					       b->row0, b->row0 + b->n);
+		}
+		s->n_written = b->row0 + b->n;
+		g_cond_broadcast(&s->cond);
+		g_mutex_unlock(&s->lock);
+		spill_block_free(b);
+	}
+	return NULL;
+}
+
+/* hand the pending block to the writer */
+static void spill_queue_pending(YSpill * s)
+{
+	SpillBlock *b = s->pending;
+	if (b->n == 0)
+		return;
+	if (s->timed) {
+		SpillIndex e = { b->row0, b->n, b->times[0], b->times[b->n - 1] };
+		g_array_append_val(s->index, e);
+	}
+	s->n_queued = b->row0 + b->n;
+	g_async_queue_push(s->queue, b);
+	s->pending = spill_block_new(s, s->n_queued);
+}
+
+/* wait for the writer to catch up, and get the number of rows in the file;
+ * returns FALSE with @err set if a write failed */
+static gboolean spill_wait(YSpill * s, guint64 * n_good, GError ** err)
+{
+	g_mutex_lock(&s->lock);
+	while (s->n_written < s->n_queued)
+		g_cond_wait(&s->cond, &s->lock);
+	*n_good = s->n_good;
+	gboolean ok = s->error == NULL;
+	if (!ok)
+		g_propagate_error(err, g_error_copy(s->error));
+	g_mutex_unlock(&s->lock);
+	return ok;
+}
+
+static void y_spill_dispose(GObject * obj)
+{
+	YSpill *s = (YSpill *) obj;
+	if (s->writer) {
+		spill_queue_pending(s);
+		g_async_queue_push(s->queue, &spill_stop);
+		g_thread_join(s->writer);
+		s->writer = NULL;
+		/* nobody is left to ask */
+		if (s->error)
+			g_warning("%s", s->error->message);
+	}
+	G_OBJECT_CLASS(y_spill_parent_class)->dispose(obj);
+}
+
+static void y_spill_finalize(GObject * obj)
+{
+	YSpill *s = (YSpill *) obj;
+	y_hdf5_lock();
+	if (s->values_id >= 0)
+		H5Dclose(s->values_id);
+	if (s->times_id >= 0)
+		H5Dclose(s->times_id);
+	y_hdf5_unlock();
+	g_clear_object(&s->file);
+	if (s->pending)
+		spill_block_free(s->pending);
+	if (s->index)
+		g_array_unref(s->index);
+	if (s->queue)
+		g_async_queue_unref(s->queue);
+	g_clear_error(&s->error);
+	g_mutex_clear(&s->lock);
+	g_cond_clear(&s->cond);
+
+	GObjectClass *obj_class = G_OBJECT_CLASS(y_spill_parent_class);
+
+	(*obj_class->finalize) (obj);
+}
+
+static void y_spill_class_init(YSpillClass * klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->dispose = y_spill_dispose;
+	gobject_klass->finalize = y_spill_finalize;
+}
+
+static void y_spill_init(YSpill * s)
+{
+	s->values_id = -1;
+	s->times_id = -1;
+	g_mutex_init(&s->lock);
+	g_cond_init(&s->cond);
+}
+
+static hid_t spill_create_dataset(hid_t group, const gchar * name,
+				  unsigned int columns)
+{
+	int rank = columns > 1 ? 2 : 1;
+	hsize_t dims[2] = { 0, columns };
+	hsize_t max_dims[2] = { H5S_UNLIMITED, columns };
+	hsize_t chunk[2] = { SPILL_BLOCK, columns };
+	hid_t dataspace_id = H5Screate_simple(rank, dims, max_dims);
+	hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
+	H5Pset_chunk(plist_id, rank, chunk);
+	H5Pset_deflate(plist_id, DEFLATE_LEVEL);
+	hid_t id = H5Dcreate2(group, name, H5T_NATIVE_DOUBLE, dataspace_id,
+			      H5P_DEFAULT, plist_id, H5P_DEFAULT);
+	H5Pclose(plist_id);
+	H5Sclose(dataspace_id);
+	return id;
+}
+
+/**
+ * y_spill_new:
+ * @file: a #YFile open for writing
+ * @name: name of the group to create in @file
+ * @columns: number of values per row, 1 for a #YRingVector
+ * @timestamps: whether to store a timestamp for each row
+ * @err: (nullable): a #GError or %NULL
+ *
+ * Create a spill that writes to a new group in @file.
+ *
+ * Returns: (transfer full): a #YSpill, or %NULL on error
+ **/
+YSpill *y_spill_new(YFile * file, const gchar * name, unsigned columns,
+		    gboolean timestamps, GError ** err)
+{
+	g_return_val_if_fail(Y_IS_FILE(file), NULL);
+	g_return_val_if_fail(columns > 0, NULL);
+	YSpill *s = g_object_new(Y_TYPE_SPILL, NULL);
+	s->file = g_object_ref(file);
+	s->columns = columns;
+	s->timed = timestamps;
+	y_hdf5_lock();
+	hid_t group = y_hdf5_create_group(y_file_get_handle(file), name);
+	if (group >= 0) {
+		s->values_id = spill_create_dataset(group, "values", columns);
+		if (timestamps)
+			s->times_id = spill_create_dataset(group, "timestamps", 1);
+		y_hdf5_close_group(group);
+	}
+	y_hdf5_unlock();
+	if (group < 0) {
+		g_set_error(err, G_IO_ERROR, G_IO_ERROR_FAILED,
+			    "could not create group: %s", name);
+		g_object_unref(s);
+		return NULL;
+	}
+	if (s->values_id < 0 || (timestamps && s->times_id < 0)) {
+		g_set_error(err, G_IO_ERROR, G_IO_ERROR_FAILED,
+			    "could not create datasets in %s", name);
+		g_object_unref(s);
+		return NULL;
+	}
+	s->pending = spill_block_new(s, 0);
+	s->index = g_array_new(FALSE, FALSE, sizeof(SpillIndex));
+	s->queue = g_async_queue_new();
+	s->writer = g_thread_new("y-spill", spill_writer, s);
+	return s;
+}
+
+/**
+ * y_spill_push:
+ * @s: #YSpill
+ * @times: (nullable) (array length=rows): timestamps, or %NULL
+ * @values: (array): @rows rows of values
+ * @rows: number of rows
+ *
+ * Add rows to the end of the spill. Full blocks are written by the
+ * background thread. If the spill stores timestamps and @times is %NULL,
+ * the timestamps are NaN.
+ **/
+void y_spill_push(YSpill * s, const double *times, const double *values,
+		  unsigned rows)
+{
+	g_return_if_fail(Y_IS_SPILL(s));
+	while (rows > 0) {
+		SpillBlock *b = s->pending;
+		unsigned int k = MIN(rows, SPILL_BLOCK - b->n);
+		memcpy(b->values + b->n * s->columns, values,
+		       k * s->columns * sizeof(double));
+		if (s->timed) {
+			unsigned int i;
+			for (i = 0; i < k; i++) {
+				b->times[b->n + i] = times ? times[i] : NAN;
+			}
+			times = times ? times + k : NULL;
+		}
+		values += k * s->columns;
+		b->n += k;
+		rows -= k;
+		if (b->n == SPILL_BLOCK)
+			spill_queue_pending(s);
+	}
+}
+
+/**
+ * y_spill_flush:
+ * @s: #YSpill
+ * @err: (nullable): a #GError or %NULL
+ *
+ * Write all rows pushed so far to the file, and wait until they are
+ * written.
+ *
+ * Returns: %FALSE if any rows could not be written
+ **/
+gboolean y_spill_flush(YSpill * s, GError ** err)
+{
+	g_return_val_if_fail(Y_IS_SPILL(s), FALSE);
+	guint64 n_good;
+	spill_queue_pending(s);
+	gboolean ok = spill_wait(s, &n_good, err);
+	y_hdf5_lock();
+	if (H5Fflush(y_file_get_handle(s->file), H5F_SCOPE_LOCAL) < 0 && ok) {
+		g_set_error(err, G_IO_ERROR, G_IO_ERROR_FAILED,
+			    "could not flush spill file");
+		ok = FALSE;
+	}
+	y_hdf5_unlock();
+	return ok;
+}
+
+/**
+ * y_spill_get_n_rows:
+ * @s: #YSpill
+ *
+ * Get the number of rows pushed to the spill, including those not yet
+ * written.
+ *
+ * Returns: the number of rows
+ **/
+guint64 y_spill_get_n_rows(YSpill * s)
+{
+	g_return_val_if_fail(Y_IS_SPILL(s), 0);
+	return s->pending->row0 + s->pending->n;
+}
+
+/**
+ * y_spill_get_columns:
+ * @s: #YSpill
+ *
+ * Get the number of values per row.
+ *
+ * Returns: the number of columns
+ **/
+unsigned int y_spill_get_columns(YSpill * s)
+{
+	g_return_val_if_fail(Y_IS_SPILL(s), 0);
+	return s->columns;
+}
+
+/**
+ * y_spill_read_range:
+ * @s: #YSpill
+ * @start: earliest timestamp
+ * @end: latest timestamp
+ * @times: (out) (array length=return) (transfer full): timestamps
+ * @values: (out) (transfer full): values, one row per timestamp
+ * @err: (nullable): a #GError or %NULL
+ *
+ * Get the rows with timestamps between @start and @end, inclusive. Only
+ * the blocks of the file that overlap the range are read. The spill must
+ * store timestamps. If some rows could not be written or read, @err is
+ * set, and the rows that could be are still returned.
+ *
+ * Returns: the number of rows
+ **/
+unsigned int y_spill_read_range(YSpill * s, double start, double end,
+				double **times, double **values,
+				GError ** err)
+{
+	g_return_val_if_fail(Y_IS_SPILL(s), 0);
+	g_return_val_if_fail(s->timed, 0);
+	g_return_val_if_fail(times != NULL && values != NULL, 0);
+
+	SpillIndex *idx = (SpillIndex *) s->index->data;
+	unsigned int nb = s->index->len;
+	/* first block that ends at or after start */
+	unsigned int lo = 0, hi = nb;
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		if (idx[mid].t1 < start)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	unsigned int k, last = lo;
+	gsize total = s->pending->n;
+	while (last < nb && idx[last].t0 <= end) {
+		total += idx[last].n;
+		last++;
+	}
+
+	unsigned int c = s->columns;
+	*times = g_new(double, MAX(total, 1));
+	*values = g_new(double, MAX(total, 1) * c);
+	unsigned int n = 0;
+	if (last > lo) {
+		guint64 n_good;
+		gboolean ok = spill_wait(s, &n_good, err);
+		double *bt = g_new(double, SPILL_BLOCK);
+		double *bv = g_new(double, SPILL_BLOCK * c);
+		y_hdf5_lock();
+		for (k = lo; k < last && idx[k].row0 + idx[k].n <= n_good; k++) {
+			unsigned int i;
+			if (!spill_rows_h5(s->times_id, 1, idx[k].row0,
+					   idx[k].n, bt, FALSE)
+			    || !spill_rows_h5(s->values_id, c, idx[k].row0,
+					      idx[k].n, bv, FALSE)) {
+				if (ok)
+					g_set_error(err, G_IO_ERROR,
+						    G_IO_ERROR_FAILED,
+						    "could not read rows %"
+						    G_GUINT64_FORMAT
+						    " of spill", idx[k].row0);
+				ok = FALSE;
+				continue;
+			}
+			for (i = 0; i < idx[k].n; i++) {
+				if (bt[i] >= start && bt[i] <= end) {
+					(*times)[n] = bt[i];
+					memcpy(*values + n * c, bv + i * c,
+					       c * sizeof(double));
+					n++;
+				}
+			}
+		}
+		y_hdf5_unlock();
+		g_free(bt);
+		g_free(bv);
+	}
+
+	/* rows not yet handed to the writer */
+	SpillBlock *b = s->pending;
+	for (k = 0; k < b->n; k++) {
+		if (b->times[k] >= start && b->times[k] <= end) {
+			(*times)[n] = b->times[k];
+			memcpy(*values + n * c, b->values + k * c,
+			       c * sizeof(double));
+			n++;
+		}
+	}
+	return n;
+}
@@ -0,0 +1,43 @@
+/*
+ * y-spill.h :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef Y_SPILL_H
+#define Y_SPILL_H
+
+#include <glib-object.h>
+#include <y-hdf.h>
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE(YSpill,y_spill,Y,SPILL,GObject)
+
+#define Y_TYPE_SPILL  (y_spill_get_type ())
+
+YSpill *y_spill_new (YFile *file, const gchar *name, unsigned columns, gboolean timestamps, GError **err);
+void y_spill_push (YSpill *s, const double *times, const double *values, unsigned rows);
+gboolean y_spill_flush (YSpill *s, GError **err);
+guint64 y_spill_get_n_rows (YSpill *s);
+unsigned int y_spill_get_columns (YSpill *s);
+unsigned int y_spill_read_range (YSpill *s, double start, double end, double **times, double **values, GError **err);
+
+G_END_DECLS
+
+#endif
@@ -112,9 +112,9 @@ int subset_size(YOperation * op, YData * input, unsigned int *dims)
 
 	if (Y_IS_VECTOR(input)) {
 		unsigned int l = y_vector_get_len(Y_VECTOR(input));
-		dims[0] =
-		    (sop->start1 + sop->length1 >
-		     l) ? l - sop->start1 : sop->length1;
+		/* must agree with subset_op_create_data */
+		dims[0] = (unsigned int)sop->start1 < l ?
+		    MIN((unsigned int)sop->length1, l - sop->start1) : 0;
 		n_dims = 1;
 		return n_dims;
 	}
@@ -139,6 +139,7 @@ int subset_size(YOperation * op, YData * input, unsigned int *dims)
 typedef struct {
 	YSubsetOperation sop;
 	double *input;
+	unsigned int vlen;	/* for vectors, the length of the subset */
 	YMatrixSize size;
 	double *output;
 	YMatrixSize output_size;
@@ -160,13 +161,22 @@ gpointer subset_op_create_data(YOperation * op, gpointer data, YData * input)
 	YSubsetOperation *sop = Y_SUBSET_OPERATION(op);
 	d->sop = *sop;
 	if (Y_IS_VECTOR(input)) {
+		/* copy only the subset, which for vectors like
+		 * YLinearRangeVector is computed without loading the rest */
 		YVector *vec = Y_VECTOR(input);
-		d->input =
-		    y_create_input_array_from_vector(vec, neu, d->size.rows,
-						     d->input);
-		if (d->output_size.columns != sop->length1) {
-			d->output = g_new(double, sop->length1);
+		unsigned int l = y_vector_get_len(vec);
+		unsigned int n = (unsigned int)sop->start1 < l ?
+		    MIN((unsigned int)sop->length1, l - sop->start1) : 0;
+		if (neu || n != d->vlen) {
+			g_free(d->input);
+			g_free(d->output);
+			d->input = g_new(double, MAX(n, 1));
+			d->output = g_new(double, MAX(n, 1));
+			d->vlen = n;
 		}
+		y_vector_get_values_range(vec, sop->start1, n, d->input);
+		d->size.rows = 0;
+		d->size.columns = 0;
 		return d;
 	}
 	YMatrix *mat = Y_MATRIX(input);
@@ -206,9 +216,7 @@ gpointer subset_op(gpointer input)
 	unsigned int i, j;
 
 	if (d->size.rows==0) {
-		for (j = 0; j < d->sop.length1; j++) {
-			v[j] = m[j + d->sop.start1];
-		}
+		memcpy(v, m, d->vlen * sizeof(double));
 	} else {
 		for (j = 0; j < d->sop.length1; j++) {
 			for (i = 0; i < d->sop.length2; i++) {
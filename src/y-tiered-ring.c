@@ -0,0 +1,337 @@
+/*
+ * y-tiered-ring.c :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "y-tiered-ring.h"
+
+/**
+ * SECTION: y-tiered-ring
+ * @short_description: Ring vectors at several time resolutions, for long
+ * strip charts.
+ *
+ * A #YTieredRing keeps recent samples at full resolution and older samples
+ * at progressively lower resolutions, so that a strip chart can show a
+ * week of fast data without keeping every sample. Tier 0 holds the last
+ * "length" samples. Each following tier holds "length" buckets, each
+ * summarizing "factor" items of the tier before it by the time of its
+ * first sample and its minimum, maximum and mean. Tier k therefore covers
+ * length*factor^k samples. Every tier is stored in #YRingVector objects,
+ * which can be plotted directly, and appending a sample costs amortized
+ * constant time.
+ *
+ * Items enter a tier only when their bucket is complete, so the newest
+ * samples appear in the coarser tiers with a delay. y_tiered_ring_query()
+ * picks the tier to plot for a time range and a width in pixels.
+ */
+
+typedef struct {
+	YRingVector *times;
+	YRingVector *min;
+	YRingVector *max;
+	YRingVector *mean;
+	/* bucket being filled */
+	unsigned int count;
+	double t0, mn, mx, sum;
+} Tier;
+
+struct _YTieredRing {
+	GObject base;
+	unsigned int length;
+	unsigned int factor;
+	unsigned int n_tiers;
+	Tier *tiers;
+};
+
+G_DEFINE_TYPE(YTieredRing, y_tiered_ring, G_TYPE_OBJECT);
+
+static void y_tiered_ring_finalize(GObject * obj)
+{
+	YTieredRing *r = (YTieredRing *) obj;
+	unsigned int k;
+	for (k = 0; k < r->n_tiers; k++) {
+		Tier *tr = &r->tiers[k];
+		g_object_unref(tr->times);
+		g_object_unref(tr->min);
+		if (k > 0) {
+			g_object_unref(tr->max);
+			g_object_unref(tr->mean);
+		}
+	}
+	g_free(r->tiers);
+
+	GObjectClass *obj_class = G_OBJECT_CLASS(y_tiered_ring_parent_class);
+
+	(*obj_class->finalize) (obj);
+}
+
+static void y_tiered_ring_class_init(YTieredRingClass * klass)
+{
+	GObjectClass *gobject_klass = (GObjectClass *) klass;
+	gobject_klass->finalize = y_tiered_ring_finalize;
+}
+
+static void y_tiered_ring_init(YTieredRing * r)
+{
+}
+
+static YRingVector *tier_ring_new(unsigned int length)
+{
+	return Y_RING_VECTOR(g_object_ref_sink(y_ring_vector_new(length, 0, FALSE)));
+}
+
+/**
+ * y_tiered_ring_new:
+ * @length: number of items kept in each tier
+ * @factor: number of items of a tier summarized by each item of the next
+ * @n_tiers: number of tiers, including the full resolution one
+ *
+ * Create a new, empty tiered ring.
+ *
+ * Returns: a #YTieredRing
+ **/
+YTieredRing *y_tiered_ring_new(unsigned length, unsigned factor,
+			       unsigned n_tiers)
+{
+	g_return_val_if_fail(length > 0, NULL);
+	g_return_val_if_fail(factor > 1, NULL);
+	g_return_val_if_fail(n_tiers > 0, NULL);
+	YTieredRing *r = g_object_new(Y_TYPE_TIERED_RING, NULL);
+	r->length = length;
+	r->factor = factor;
+	r->n_tiers = n_tiers;
+	r->tiers = g_new0(Tier, n_tiers);
+	unsigned int k;
+	for (k = 0; k < n_tiers; k++) {
+		Tier *tr = &r->tiers[k];
+		tr->times = tier_ring_new(length);
+		tr->min = tier_ring_new(length);
+		if (k == 0) {
+			/* at full resolution these are all the samples */
+			tr->max = tr->mean = tr->min;
+		} else {
+			tr->max = tier_ring_new(length);
+			tr->mean = tier_ring_new(length);
+		}
+	}
+	return r;
+}
+
+/* add an item from tier k-1 to the bucket being filled in tier k */
+static void tiered_ring_feed(YTieredRing * r, unsigned int k, double t,
+			     double mn, double mx, double mean)
+{
+	for (; k < r->n_tiers; k++) {
+		Tier *tr = &r->tiers[k];
+		if (tr->count == 0) {
+			tr->t0 = t;
+			tr->mn = mn;
+			tr->mx = mx;
+			tr->sum = mean;
+		} else {
+			tr->mn = MIN(tr->mn, mn);
+			tr->mx = MAX(tr->mx, mx);
+			tr->sum += mean;
+		}
+		if (++tr->count < r->factor)
+			return;
+		/* the bucket is complete; it becomes an item of the next tier */
+		t = tr->t0;
+		mn = tr->mn;
+		mx = tr->mx;
+		mean = tr->sum / r->factor;
+		tr->count = 0;
+		y_ring_vector_append(tr->times, t);
+		y_ring_vector_append(tr->min, mn);
+		y_ring_vector_append(tr->max, mx);
+		y_ring_vector_append(tr->mean, mean);
+	}
+}
+
+/**
+ * y_tiered_ring_append :
+ * @r: #YTieredRing
+ * @t: time of the sample, in seconds
+ * @v: value
+ *
+ * Append a sample. Times should not decrease.
+ **/
+void y_tiered_ring_append(YTieredRing * r, double t, double v)
+{
+	g_return_if_fail(Y_IS_TIERED_RING(r));
+	y_ring_vector_append(r->tiers[0].times, t);
+	y_ring_vector_append(r->tiers[0].min, v);
+	tiered_ring_feed(r, 1, t, v, v, v);
+}
+
+/**
+ * y_tiered_ring_get_n_tiers :
+ * @r: #YTieredRing
+ *
+ * Get the number of tiers.
+ *
+ * Returns: the number of tiers
+ **/
+unsigned int y_tiered_ring_get_n_tiers(YTieredRing * r)
+{
+	g_return_val_if_fail(Y_IS_TIERED_RING(r), 0);
+	return r->n_tiers;
+}
+
+/**
+ * y_tiered_ring_get_times :
+ * @r: #YTieredRing
+ * @tier: tier number
+ *
+ * Get the times of the items in a tier. For tiers after the first, this is
+ * the time of the first sample in each bucket.
+ *
+ * Returns: (transfer none): the times
+ **/
+YRingVector *y_tiered_ring_get_times(YTieredRing * r, unsigned tier)
+{
+	g_return_val_if_fail(Y_IS_TIERED_RING(r), NULL);
+	g_return_val_if_fail(tier < r->n_tiers, NULL);
+	return r->tiers[tier].times;
+}
+
+/**
+ * y_tiered_ring_get_min :
+ * @r: #YTieredRing
+ * @tier: tier number
+ *
+ * Get the minimum of each bucket in a tier. For tier 0, this is the
+ * samples themselves.
+ *
+ * Returns: (transfer none): the minima
+ **/
+YRingVector *y_tiered_ring_get_min(YTieredRing * r, unsigned tier)
+{
+	g_return_val_if_fail(Y_IS_TIERED_RING(r), NULL);
+	g_return_val_if_fail(tier < r->n_tiers, NULL);
+	return r->tiers[tier].min;
+}
+
+/**
+ * y_tiered_ring_get_max :
+ * @r: #YTieredRing
+ * @tier: tier number
+ *
+ * Get the maximum of each bucket in a tier. For tier 0, this is the
+ * samples themselves.
+ *
+ * Returns: (transfer none): the maxima
+ **/
+YRingVector *y_tiered_ring_get_max(YTieredRing * r, unsigned tier)
+{
+	g_return_val_if_fail(Y_IS_TIERED_RING(r), NULL);
+	g_return_val_if_fail(tier < r->n_tiers, NULL);
+	return r->tiers[tier].max;
+}
+
+/**
+ * y_tiered_ring_get_mean :
+ * @r: #YTieredRing
+ * @tier: tier number
+ *
+ * Get the mean of each bucket in a tier. For tier 0, this is the samples
+ * themselves.
+ *
+ * Returns: (transfer none): the means
+ **/
+YRingVector *y_tiered_ring_get_mean(YTieredRing * r, unsigned tier)
+{
+	g_return_val_if_fail(Y_IS_TIERED_RING(r), NULL);
+	g_return_val_if_fail(tier < r->n_tiers, NULL);
+	return r->tiers[tier].mean;
+}
+
+/* number of times before x (or at or before x, if after is TRUE) */
+static unsigned int tier_bound(const double *t, unsigned int n, double x,
+			       gboolean after)
+{
+	unsigned int lo = 0, hi = n;
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		if (t[mid] < x || (after && t[mid] == x))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/**
+ * y_tiered_ring_query :
+ * @r: #YTieredRing
+ * @start: start of the time range
+ * @end: end of the time range
+ * @pixels: number of points wanted across the range
+ * @first: (out) (optional): index of the first item in the range
+ * @n: (out) (optional): number of items in the range
+ *
+ * Choose the tier to plot a time range with. This is the coarsest tier that
+ * reaches back to @start and still has at least @pixels items in the range.
+ * If no tier has that many, it is the finest tier that reaches back to
+ * @start, and if none does, the coarsest tier. The items in the range are
+ * found by binary search on the tier's times.
+ *
+ * Returns: the tier number
+ **/
+unsigned int y_tiered_ring_query(YTieredRing * r, double start, double end,
+				 unsigned pixels, unsigned *first, unsigned *n)
+{
+	g_return_val_if_fail(Y_IS_TIERED_RING(r), 0);
+	if (end < start)
+		end = start;
+	unsigned int k = r->n_tiers;
+	unsigned int best = r->n_tiers - 1;
+	gboolean found = FALSE;
+	while (k-- > 0) {
+		YVector *times = Y_VECTOR(r->tiers[k].times);
+		unsigned int len = y_vector_get_len(times);
+		if (len == 0)
+			continue;
+		const double *t = y_vector_get_values(times);
+		if (t[0] > start)
+			continue;
+		unsigned int count = tier_bound(t, len, end, TRUE)
+		    - tier_bound(t, len, start, FALSE);
+		best = k;
+		found = TRUE;
+		if (count >= pixels)
+			break;
+	}
+	if (!found) {
+		/* nothing reaches back far enough, so use the longest tier */
+		best = r->n_tiers - 1;
+		while (best > 0 && y_vector_get_len(Y_VECTOR(r->tiers[best].times)) == 0)
+			best--;
+	}
+	YVector *times = Y_VECTOR(r->tiers[best].times);
+	unsigned int len = y_vector_get_len(times);
+	const double *t = y_vector_get_values(times);
+	unsigned int a = len ? tier_bound(t, len, start, FALSE) : 0;
+	unsigned int b = len ? tier_bound(t, len, end, TRUE) : 0;
+	if (first)
+		*first = a;
+	if (n)
+		*n = b - a;
+	return best;
+}
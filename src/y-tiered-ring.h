@@ -0,0 +1,45 @@
+/*
+ * y-tiered-ring.h :
+ *
+ * Copyright (C) 2026 Scott O. Johnson (scojo202@gmail.com)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef Y_TIERED_RING_H
+#define Y_TIERED_RING_H
+
+#include <glib-object.h>
+#include <y-vector-ring.h>
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE(YTieredRing,y_tiered_ring,Y,TIERED_RING,GObject)
+
+#define Y_TYPE_TIERED_RING  (y_tiered_ring_get_type ())
+
+YTieredRing *y_tiered_ring_new (unsigned length, unsigned factor, unsigned n_tiers);
+void y_tiered_ring_append (YTieredRing *r, double t, double v);
+unsigned int y_tiered_ring_get_n_tiers (YTieredRing *r);
+YRingVector *y_tiered_ring_get_times (YTieredRing *r, unsigned tier);
+YRingVector *y_tiered_ring_get_min (YTieredRing *r, unsigned tier);
+YRingVector *y_tiered_ring_get_max (YTieredRing *r, unsigned tier);
+YRingVector *y_tiered_ring_get_mean (YTieredRing *r, unsigned tier);
+unsigned int y_tiered_ring_query (YTieredRing *r, double start, double end, unsigned pixels, unsigned *first, unsigned *n);
+
+G_END_DECLS
+
+#endif
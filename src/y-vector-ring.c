@@ -34,6 +34,16 @@
  *
  * Data class #YRingVector
  *
+ * Elements thrown away from a ring that tracks timestamps can be kept in a
+ * compressed #YHistory, set with y_ring_vector_set_history(), or written to
+ * an HDF5 file through a #YSpill, set with y_ring_vector_set_spill() or
+ * y_ring_matrix_set_spill(). y_ring_vector_get_range() and
+ * y_ring_matrix_get_range() read a time range from the spill and the ring
+ * together.
+ *
+ * A #YRingWindow shows the part of a #YRingVector appended during the last
+ * few seconds, such as for a plot that scrolls in time. It uses the ring's
+ * own storage rather than a copy.
  */
 
 /**
@@ -46,10 +56,14 @@ struct _YRingVector {
 	YVector base;
 	unsigned n;
 	unsigned int nmax;
-	double *val;
+	double *buf;		/* room for 2*nmax values */
+	double *val;		/* the current values, somewhere in buf */
 	YScalar *source;
 	gulong handler;
 	YRingVector *timestamps;
+	guint64 n_appended;	/* total number of values ever appended */
+	YHistory *history;
+	YSpill *spill;
 };
 
 G_DEFINE_TYPE(YRingVector, y_ring_vector, Y_TYPE_VECTOR);
@@ -57,12 +71,16 @@ G_DEFINE_TYPE(YRingVector, y_ring_vector, Y_TYPE_VECTOR);
 static void y_ring_vector_finalize(GObject * obj)
 {
 	YRingVector *vec = (YRingVector *) obj;
-	if (vec->val)
-		g_free(vec->val);
+	if (vec->buf)
+		g_free(vec->buf);
 	if (vec->source) {
 		g_object_unref(vec->source);
 		g_signal_handler_disconnect(vec->source, vec->handler);
 	}
+	if (vec->history)
+		g_object_unref(vec->history);
+	if (vec->spill)
+		g_object_unref(vec->spill);
 
 	GObjectClass *obj_class = G_OBJECT_CLASS(y_ring_vector_parent_class);
 
@@ -73,9 +91,11 @@ static YData *y_ring_vector_dup(YData * src)
 {
 	YRingVector *dst = g_object_new(G_OBJECT_TYPE(src), NULL);
 	YRingVector const *src_val = (YRingVector const *)src;
-	dst->val = g_new0(double, src_val->nmax);
+	dst->buf = g_new0(double, 2 * src_val->nmax);
+	dst->val = dst->buf;
 	memcpy(dst->val, src_val->val, src_val->n * sizeof(double));
 	dst->n = src_val->n;
+	dst->nmax = src_val->nmax;
 	return Y_DATA(dst);
 }
 
@@ -142,7 +162,8 @@ static void y_ring_vector_init(YRingVector * val)
 YData *y_ring_vector_new(unsigned nmax, unsigned n, gboolean track_timestamps)
 {
 	YRingVector *res = g_object_new(Y_TYPE_RING_VECTOR, NULL);
-	res->val = g_new0(double, nmax);
+	res->buf = g_new0(double, 2 * nmax);
+	res->val = res->buf;
 	res->n = n;
 	res->nmax = nmax;
 	if(track_timestamps) {
@@ -151,6 +172,17 @@ YData *y_ring_vector_new(unsigned nmax, unsigned n, gboolean track_timestamps)
 	return Y_DATA(res);
 }
 
+/* make room for extra values after the current ones. The values only move
+ * back to the start of the buffer after the window has slid nmax places, so
+ * appending to a full ring costs amortized O(1). */
+static void ring_vector_reserve(YRingVector * d, unsigned int extra)
+{
+	if (d->val + d->n + extra > d->buf + 2 * d->nmax) {
+		memmove(d->buf, d->val, d->n * sizeof(double));
+		d->val = d->buf;
+	}
+}
+
 /**
  * y_ring_vector_append :
  * @d: #YRingVector
@@ -163,18 +195,30 @@ void y_ring_vector_append(YRingVector * d, double val)
 {
 	g_assert(Y_IS_RING_VECTOR(d));
 	unsigned int l = MIN(d->nmax, y_vector_get_len(Y_VECTOR(d)));
-	double *frames = d->val;
 	if (l < d->nmax) {
-		frames[l] = val;
-		y_ring_vector_set_length(d, l + 1);
+		ring_vector_reserve(d, 1);
+		d->val[l] = val;
+		/* the timestamps grow below, so don't use set_length() */
+		d->n = l + 1;
 	}
 	else if (l == d->nmax) {
-		memmove(frames, &frames[1], (l - 1) * sizeof(double));
-		frames[l - 1] = val;
+		if (d->history) {
+			y_history_append(d->history, d->timestamps->val[0],
+					 d->val[0]);
+		}
+		if (d->spill) {
+			y_spill_push(d->spill,
+				     d->timestamps ? d->timestamps->val : NULL,
+				     d->val, 1);
+		}
+		ring_vector_reserve(d, 1);
+		d->val[l] = val;
+		d->val++;
 	}
 	else {
 		return;
 	}
+	d->n_appended++;
 	if(d->timestamps) {
 		y_ring_vector_append(d->timestamps,((double)g_get_real_time())/1e6);
 	}
@@ -187,7 +231,8 @@ void y_ring_vector_append(YRingVector * d, double val)
  * @arr: (array length=len): array
  * @len: array length
  *
- * Append a new array of values @arr to the vector.
+ * Append a new array of values @arr to the vector. If the vector would grow
+ * beyond its maximum length, the oldest elements are thrown away.
  *
  **/
 void y_ring_vector_append_array(YRingVector * d, double *arr, int len)
@@ -196,24 +241,58 @@ void y_ring_vector_append_array(YRingVector * d, double *arr, int len)
 	g_assert(arr);
 	g_assert(len>=0);
 	unsigned int l = MIN(d->nmax, y_vector_get_len(Y_VECTOR(d)));
-	double *frames = d->val;
 	int i;
 	double now = ((double)g_get_real_time())/1e6;
-	if (l + len < d->nmax) {
-		for (i = 0; i < len; i++) {
-			frames[i + l] = arr[i];
-			if(d->timestamps) {
-				y_ring_vector_append(d->timestamps,now);
+	if (d->history) {
+		/* pass on the samples that are about to be thrown away */
+		unsigned int drop = MIN(l, l + len > d->nmax ? l + len - d->nmax : 0);
+		for (i = 0; i < (int)drop; i++) {
+			y_history_append(d->history, d->timestamps->val[i],
+					 d->val[i]);
+		}
+		for (i = 0; i + d->nmax < (unsigned int)len; i++) {
+			y_history_append(d->history, now, arr[i]);
+		}
+	}
+	if (d->spill) {
+		unsigned int drop = MIN(l, l + len > d->nmax ? l + len - d->nmax : 0);
+		y_spill_push(d->spill, d->timestamps ? d->timestamps->val : NULL,
+			     d->val, drop);
+		if ((unsigned int)len > d->nmax) {
+			unsigned int over = len - d->nmax;
+			double *t = NULL;
+			if (d->timestamps) {
+				t = g_new(double, over);
+				for (i = 0; i < (int)over; i++)
+					t[i] = now;
 			}
+			y_spill_push(d->spill, t, arr, over);
+			g_free(t);
+		}
+	}
+	if (l + len <= d->nmax) {
+		ring_vector_reserve(d, len);
+		memcpy(&d->val[l], arr, len * sizeof(double));
+		d->n = l + len;
+	}
+	else if (len >= d->nmax) {
+		d->val = d->buf;
+		memcpy(d->val, &arr[len - d->nmax], d->nmax * sizeof(double));
+		d->n = d->nmax;
+	}
+	else {
+		unsigned int drop = l + len - d->nmax;
+		ring_vector_reserve(d, len);
+		memcpy(&d->val[l], arr, len * sizeof(double));
+		d->val += drop;
+		d->n = d->nmax;
+	}
+	d->n_appended += len;
+	if(d->timestamps) {
+		for (i = 0; i < len; i++) {
+			y_ring_vector_append(d->timestamps,now);
 		}
-		y_ring_vector_set_length(d, l + len);
 	}
-	/*else {
-	   memmove(frames, &frames[1], (l-1)*sizeof(double));
-	   frames[l-1]=val;
-	   } */
-	else
-		return;
 	y_data_emit_changed(Y_DATA(d));
 }
 
@@ -264,6 +343,8 @@ void y_ring_vector_set_length(YRingVector * d, unsigned newlength)
 {
 	g_assert(Y_IS_RING_VECTOR(d));
 	if (newlength <= d->nmax) {
+		if (newlength > d->n)
+			ring_vector_reserve(d, newlength - d->n);
 		d->n = newlength;
 		y_data_emit_changed(Y_DATA(d));
 		if(d->timestamps) {
@@ -288,6 +369,351 @@ YRingVector *y_ring_vector_get_timestamps(YRingVector *d)
 	return d->timestamps;
 }
 
+/**
+ * y_ring_vector_get_n_appended :
+ * @d: #YRingVector
+ *
+ * Get the total number of values that have been appended to the vector since
+ * it was created, including those that have since been thrown away. The
+ * last element of the vector is value number n_appended-1, so operations
+ * can use this to find out which elements are new since they last looked.
+ *
+ * Returns: The number of values appended.
+ **/
+
+guint64 y_ring_vector_get_n_appended(YRingVector *d)
+{
+	g_assert(Y_IS_RING_VECTOR(d));
+	return d->n_appended;
+}
+
+/**
+ * y_ring_vector_set_history :
+ * @d: #YRingVector
+ * @history: (nullable): a #YHistory, or %NULL
+ *
+ * Keep the elements that are thrown away from @d, with their timestamps,
+ * in a compressed history. @d must track timestamps.
+ **/
+void y_ring_vector_set_history(YRingVector *d, YHistory *history)
+{
+	g_assert(Y_IS_RING_VECTOR(d));
+	g_return_if_fail(history == NULL || d->timestamps != NULL);
+	if (history)
+		g_object_ref(history);
+	if (d->history)
+		g_object_unref(d->history);
+	d->history = history;
+}
+
+/**
+ * y_ring_vector_get_history :
+ * @d: #YRingVector
+ *
+ * Get the history that receives elements thrown away from @d.
+ *
+ * Returns: (transfer none) (nullable): The history, or %NULL.
+ **/
+YHistory *y_ring_vector_get_history(YRingVector *d)
+{
+	g_assert(Y_IS_RING_VECTOR(d));
+	return d->history;
+}
+
+/**
+ * y_ring_vector_set_spill :
+ * @d: #YRingVector
+ * @spill: (nullable): a #YSpill with one column, or %NULL
+ *
+ * Write the elements that are thrown away from @d, with their timestamps,
+ * to an HDF5 file.
+ **/
+void y_ring_vector_set_spill(YRingVector *d, YSpill *spill)
+{
+	g_assert(Y_IS_RING_VECTOR(d));
+	g_return_if_fail(spill == NULL || y_spill_get_columns(spill) == 1);
+	if (spill)
+		g_object_ref(spill);
+	if (d->spill)
+		g_object_unref(d->spill);
+	d->spill = spill;
+}
+
+/**
+ * y_ring_vector_get_spill :
+ * @d: #YRingVector
+ *
+ * Get the spill that receives elements thrown away from @d.
+ *
+ * Returns: (transfer none) (nullable): The spill, or %NULL.
+ **/
+YSpill *y_ring_vector_get_spill(YRingVector *d)
+{
+	g_assert(Y_IS_RING_VECTOR(d));
+	return d->spill;
+}
+
+/* rows of a ring, and of its spill, with timestamps in [start, end] */
+static unsigned int ring_get_range(YSpill *spill, YRingVector *timestamps,
+				   const double *val, unsigned int nrows,
+				   unsigned int nc, double start, double end,
+				   double **times, double **values)
+{
+	double *st = NULL, *sv = NULL;
+	unsigned int ns = 0;
+	if (spill) {
+		GError *err = NULL;
+		ns = y_spill_read_range(spill, start, end, &st, &sv, &err);
+		if (err != NULL) {
+			g_warning("%s", err->message);
+			g_error_free(err);
+		}
+	}
+
+	const double *t = timestamps->val;
+	unsigned int n = MIN(nrows, timestamps->n);
+	unsigned int lo = 0, hi = n;
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		if (t[mid] < start)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	unsigned int first = lo;
+	hi = n;
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		if (t[mid] <= end)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	unsigned int nm = lo - first;
+
+	*times = g_new(double, MAX(ns + nm, 1));
+	*values = g_new(double, MAX(ns + nm, 1) * nc);
+	if (ns > 0) {
+		memcpy(*times, st, ns * sizeof(double));
+		memcpy(*values, sv, ns * nc * sizeof(double));
+	}
+	memcpy(*times + ns, t + first, nm * sizeof(double));
+	memcpy(*values + ns * nc, val + first * nc, nm * nc * sizeof(double));
+	g_free(st);
+	g_free(sv);
+	return ns + nm;
+}
+
+/**
+ * y_ring_vector_get_range :
+ * @d: #YRingVector
+ * @start: earliest timestamp
+ * @end: latest timestamp
+ * @times: (out) (array length=return) (transfer full): timestamps
+ * @values: (out) (array length=return) (transfer full): values
+ *
+ * Get the elements with timestamps between @start and @end, inclusive,
+ * reading those that have been thrown away from the spill, if there is one.
+ * @d must track timestamps. If part of the spill can't be read, a warning
+ * is given and the rest is returned.
+ *
+ * Returns: the number of elements
+ **/
+unsigned int y_ring_vector_get_range(YRingVector *d, double start, double end,
+				     double **times, double **values)
+{
+	g_assert(Y_IS_RING_VECTOR(d));
+	g_return_val_if_fail(d->timestamps != NULL, 0);
+	return ring_get_range(d->spill, d->timestamps, d->val, d->n, 1, start,
+			      end, times, values);
+}
+
+/********************************************************************/
+
+/**
+ * YRingWindow:
+ *
+ * A YVector showing the elements of a #YRingVector appended during the last
+ * @duration seconds, found from its timestamps.
+ **/
+
+struct _YRingWindow {
+	YVector base;
+	YRingVector *ring;
+	YRingVector *times;
+	gulong handler;
+	double duration;
+	unsigned int start, end;
+	YRingWindow *timestamps;
+};
+
+G_DEFINE_TYPE(YRingWindow, y_ring_window, Y_TYPE_VECTOR);
+
+static YData *ring_window_new_full(YRingVector *ring, YRingVector *times,
+				   double duration);
+
+static void y_ring_window_finalize(GObject * obj)
+{
+	YRingWindow *w = (YRingWindow *) obj;
+	g_signal_handler_disconnect(w->ring, w->handler);
+	g_object_unref(w->ring);
+	g_object_unref(w->times);
+	if (w->timestamps)
+		g_object_unref(w->timestamps);
+
+	GObjectClass *obj_class = G_OBJECT_CLASS(y_ring_window_parent_class);
+
+	(*obj_class->finalize) (obj);
+}
+
+static YData *y_ring_window_dup(YData * src)
+{
+	YRingWindow const *w = (YRingWindow const *)src;
+	return ring_window_new_full(w->ring, w->times, w->duration);
+}
+
+/* find the window by binary search on the timestamps */
+static void ring_window_update(YRingWindow * w)
+{
+	/* the value ring's length changes before its timestamp is appended */
+	unsigned int n = MIN(w->ring->n, w->times->n);
+	const double *t = w->times->val;
+	w->end = n;
+	if (n == 0) {
+		w->start = 0;
+		return;
+	}
+	double tmin = t[n - 1] - w->duration;
+	unsigned int lo = 0, hi = n;
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		if (t[mid] < tmin)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	w->start = lo;
+}
+
+static unsigned int y_ring_window_load_len(YVector * vec)
+{
+	YRingWindow *w = (YRingWindow *) vec;
+	ring_window_update(w);
+	return w->end - w->start;
+}
+
+static double *y_ring_window_load_values(YVector * vec)
+{
+	YRingWindow *w = (YRingWindow *) vec;
+	ring_window_update(w);
+	return w->ring->val + w->start;
+}
+
+static double y_ring_window_get_value(YVector * vec, unsigned i)
+{
+	YRingWindow *w = (YRingWindow *) vec;
+	ring_window_update(w);
+	g_return_val_if_fail(w->start + i < w->end, NAN);
+	return w->ring->val[w->start + i];
+}
+
+static double *
+y_ring_window_replace_cache(YVector *vec, unsigned len)
+{
+	g_warning("Trying to replace cache in YRingWindow.");
+	return y_ring_window_load_values(vec);
+}
+
+static void y_ring_window_class_init(YRingWindowClass * val_klass)
+{
+	YDataClass *ydata_klass = (YDataClass *) val_klass;
+	YVectorClass *vector_klass = (YVectorClass *) val_klass;
+	GObjectClass *gobject_klass = (GObjectClass *) val_klass;
+
+	gobject_klass->finalize = y_ring_window_finalize;
+	ydata_klass->dup = y_ring_window_dup;
+	vector_klass->load_len = y_ring_window_load_len;
+	vector_klass->load_values = y_ring_window_load_values;
+	vector_klass->get_value = y_ring_window_get_value;
+	vector_klass->replace_cache = y_ring_window_replace_cache;
+}
+
+static void y_ring_window_init(YRingWindow * val)
+{
+}
+
+static void on_window_ring_changed(YData * data, gpointer user_data)
+{
+	y_data_emit_changed(Y_DATA(user_data));
+}
+
+static YData *ring_window_new_full(YRingVector *ring, YRingVector *times,
+				   double duration)
+{
+	YRingWindow *res = g_object_new(Y_TYPE_RING_WINDOW, NULL);
+	res->ring = g_object_ref(ring);
+	res->times = g_object_ref(times);
+	res->duration = duration;
+	res->handler = g_signal_connect(ring, "changed",
+					G_CALLBACK(on_window_ring_changed), res);
+	return Y_DATA(res);
+}
+
+/**
+ * y_ring_window_new:
+ * @ring: a #YRingVector that tracks timestamps
+ * @duration: length of the window in seconds
+ *
+ * Create a vector showing the elements of @ring whose timestamps are at most
+ * @duration seconds older than the newest element's. The window's bounds are
+ * found by binary search on the timestamps whenever @ring changes, and its
+ * values are the elements in @ring's own storage, so nothing is copied.
+ *
+ * Returns: a #YData, or %NULL if @ring does not track timestamps
+ **/
+YData *y_ring_window_new(YRingVector *ring, double duration)
+{
+	g_return_val_if_fail(Y_IS_RING_VECTOR(ring), NULL);
+	g_return_val_if_fail(ring->timestamps != NULL, NULL);
+	return ring_window_new_full(ring, ring->timestamps, duration);
+}
+
+/**
+ * y_ring_window_set_duration :
+ * @w: #YRingWindow
+ * @duration: length of the window in seconds
+ *
+ * Set the length of the window.
+ **/
+void y_ring_window_set_duration(YRingWindow *w, double duration)
+{
+	g_assert(Y_IS_RING_WINDOW(w));
+	w->duration = duration;
+	y_data_emit_changed(Y_DATA(w));
+	if (w->timestamps)
+		y_ring_window_set_duration(w->timestamps, duration);
+}
+
+/**
+ * y_ring_window_get_timestamps :
+ * @w: #YRingWindow
+ *
+ * Get a window on the timestamps of the elements in @w, for use as the x
+ * axis of a plot.
+ *
+ * Returns: (transfer none): The timestamps.
+ **/
+YRingWindow *y_ring_window_get_timestamps(YRingWindow *w)
+{
+	g_assert(Y_IS_RING_WINDOW(w));
+	if (w->ring == w->times)
+		return w;
+	if (w->timestamps == NULL) {
+		w->timestamps = Y_RING_WINDOW(g_object_ref_sink(ring_window_new_full(w->times, w->times, w->duration)));
+	}
+	return w->timestamps;
+}
+
 /********************************************************************/
 
 /**
@@ -304,6 +730,7 @@ struct _YRingMatrix {
 	YVector *source;
 	gulong handler;
 	YRingVector *timestamps;
+	YSpill *spill;
 };
 
 G_DEFINE_TYPE(YRingMatrix, y_ring_matrix, Y_TYPE_MATRIX);
@@ -318,6 +745,8 @@ static void ring_matrix_finalize(GObject * obj)
 		g_object_unref(vec->source);
 		g_signal_handler_disconnect(vec->source, vec->handler);
 	}
+	if (vec->spill)
+		g_object_unref(vec->spill);
 
 	GObjectClass *obj_class = G_OBJECT_CLASS(y_ring_matrix_parent_class);
 
@@ -434,9 +863,15 @@ void y_ring_matrix_append(YRingMatrix * d, const double *values, unsigned len)
 		for(k=0;k<len;k++) {
 			frames[l*d->nc+k] = values[k];
 		}
-		y_ring_matrix_set_rows(d, l + 1);
+		/* the timestamps grow below, so don't use set_rows() */
+		d->nr = l + 1;
 	}
 	else if (l == d->rmax) {
+		if (d->spill) {
+			y_spill_push(d->spill,
+				     d->timestamps ? d->timestamps->val : NULL,
+				     frames, 1);
+		}
 		memmove(frames, &frames[d->nc], (l - 1) * d->nc*sizeof(double));
 		for(k=0;k<len;k++) {
 			frames[(l-1)*d->nc+k] = values[k];
@@ -548,3 +983,60 @@ YRingVector *y_ring_matrix_get_timestamps(YRingMatrix *d)
 	g_assert(Y_IS_RING_MATRIX(d));
 	return d->timestamps;
 }
+
+/**
+ * y_ring_matrix_set_spill :
+ * @d: #YRingMatrix
+ * @spill: (nullable): a #YSpill with as many columns as @d, or %NULL
+ *
+ * Write the rows that are thrown away from @d, with their timestamps, to an
+ * HDF5 file.
+ **/
+void y_ring_matrix_set_spill(YRingMatrix *d, YSpill *spill)
+{
+	g_assert(Y_IS_RING_MATRIX(d));
+	g_return_if_fail(spill == NULL || y_spill_get_columns(spill) == d->nc);
+	if (spill)
+		g_object_ref(spill);
+	if (d->spill)
+		g_object_unref(d->spill);
+	d->spill = spill;
+}
+
+/**
+ * y_ring_matrix_get_spill :
+ * @d: #YRingMatrix
+ *
+ * Get the spill that receives rows thrown away from @d.
+ *
+ * Returns: (transfer none) (nullable): The spill, or %NULL.
+ **/
+YSpill *y_ring_matrix_get_spill(YRingMatrix *d)
+{
+	g_assert(Y_IS_RING_MATRIX(d));
+	return d->spill;
+}
+
+/**
+ * y_ring_matrix_get_range :
+ * @d: #YRingMatrix
+ * @start: earliest timestamp
+ * @end: latest timestamp
+ * @times: (out) (array length=return) (transfer full): timestamps
+ * @values: (out) (transfer full): values, one row per timestamp
+ *
+ * Get the rows with timestamps between @start and @end, inclusive, reading
+ * those that have been thrown away from the spill, if there is one. @d must
+ * track timestamps. If part of the spill can't be read, a warning is given
+ * and the rest is returned.
+ *
+ * Returns: the number of rows
+ **/
+unsigned int y_ring_matrix_get_range(YRingMatrix *d, double start, double end,
+				     double **times, double **values)
+{
+	g_assert(Y_IS_RING_MATRIX(d));
+	g_return_val_if_fail(d->timestamps != NULL, 0);
+	return ring_get_range(d->spill, d->timestamps, d->val, d->nr, d->nc,
+			      start, end, times, values);
+}
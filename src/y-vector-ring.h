@@ -24,6 +24,8 @@
 
 #include <glib-object.h>
 #include <y-data-class.h>
+#include <y-history.h>
+#include <y-spill.h>
 
 G_BEGIN_DECLS
 
@@ -39,6 +41,20 @@ void y_ring_vector_append_array(YRingVector *d, double *arr, int len);
 void y_ring_vector_set_source(YRingVector *d, YScalar *source);
 
 YRingVector *y_ring_vector_get_timestamps(YRingVector *d);
+guint64 y_ring_vector_get_n_appended(YRingVector *d);
+void y_ring_vector_set_history(YRingVector *d, YHistory *history);
+YHistory *y_ring_vector_get_history(YRingVector *d);
+void y_ring_vector_set_spill(YRingVector *d, YSpill *spill);
+YSpill *y_ring_vector_get_spill(YRingVector *d);
+unsigned int y_ring_vector_get_range(YRingVector *d, double start, double end, double **times, double **values);
+
+G_DECLARE_FINAL_TYPE(YRingWindow,y_ring_window,Y,RING_WINDOW,YVector)
+
+#define Y_TYPE_RING_WINDOW  (y_ring_window_get_type ())
+
+YData *y_ring_window_new (YRingVector *ring, double duration);
+void y_ring_window_set_duration(YRingWindow *w, double duration);
+YRingWindow *y_ring_window_get_timestamps(YRingWindow *w);
 
 G_DECLARE_FINAL_TYPE(YRingMatrix,y_ring_matrix,Y,RING_MATRIX,YMatrix)
 
@@ -51,6 +67,9 @@ void y_ring_matrix_append(YRingMatrix *d, const double *values, unsigned len);
 void y_ring_matrix_set_source(YRingMatrix *d, YVector *source);
 
 YRingVector *y_ring_matrix_get_timestamps(YRingMatrix *d);
+void y_ring_matrix_set_spill(YRingMatrix *d, YSpill *spill);
+YSpill *y_ring_matrix_get_spill(YRingMatrix *d);
+unsigned int y_ring_matrix_get_range(YRingMatrix *d, double start, double end, double **times, double **values);
 
 G_END_DECLS
 
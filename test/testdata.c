@@ -1,4 +1,5 @@
 #include <math.h>
+#include <glib/gstdio.h>
 #include <y-data.h>
 
 static void
@@ -105,6 +106,86 @@ test_simple_vector_copy(void)
   g_assert_cmpfloat(mx, ==, 99.0);
 }
 
+static void
+test_vector_minmax_range(void)
+{
+  const unsigned int n = 10000;
+  g_autoptr(YValVector) vv = Y_VAL_VECTOR(y_val_vector_new_alloc(n));
+  double *vals = y_val_vector_get_array(vv);
+  for (unsigned int i=0;i<n;i++) {
+    vals[i]=g_test_rand_double_range(-1.0,1.0);
+  }
+  vals[1234]=NAN;
+  y_data_emit_changed(Y_DATA(vv));
+  for (int pass=0;pass<3;pass++) {
+    for (int k=0;k<200;k++) {
+      unsigned int a = g_test_rand_int_range(0,n);
+      unsigned int b = g_test_rand_int_range(a,n+10);
+      double mn = DBL_MAX, mx = -DBL_MAX, mn2, mx2;
+      for (unsigned int i=a;i<MIN(b,n);i++) {
+        if (isfinite(vals[i])) {
+          mn = MIN(mn,vals[i]);
+          mx = MAX(mx,vals[i]);
+        }
+      }
+      y_vector_get_minmax_range(Y_VECTOR(vv),a,b,&mn2,&mx2);
+      g_assert_cmpfloat(mn2, ==, mn);
+      g_assert_cmpfloat(mx2, ==, mx);
+    }
+    /* change part of the vector, then all of it */
+    if (pass == 0) {
+      for (unsigned int i=5000;i<5100;i++) {
+        vals[i]=g_test_rand_double_range(-2.0,2.0);
+      }
+      y_vector_emit_changed_range(Y_VECTOR(vv),5000,5100);
+    } else {
+      for (unsigned int i=0;i<n;i++) {
+        vals[i]*=3.0;
+      }
+      y_data_emit_changed(Y_DATA(vv));
+    }
+  }
+}
+
+static void
+test_vector_find_index(void)
+{
+  g_autoptr(YValVector) vv = Y_VAL_VECTOR(y_val_vector_new_alloc(1000));
+  double *vals = y_val_vector_get_array(vv);
+  for (int i=0;i<1000;i++) {
+    vals[i]=0.5*i;
+  }
+  y_data_emit_changed(Y_DATA(vv));
+  YVector *v = Y_VECTOR(vv);
+  g_assert_cmpint(y_vector_find_index(v,100.2,FIND_INDEX_NEAREST),==,200);
+  g_assert_cmpint(y_vector_find_index(v,100.2,FIND_INDEX_FLOOR),==,200);
+  g_assert_cmpint(y_vector_find_index(v,100.2,FIND_INDEX_CEIL),==,201);
+  g_assert_cmpint(y_vector_find_index(v,100.0,FIND_INDEX_CEIL),==,200);
+  g_assert_cmpint(y_vector_find_index(v,-1.0,FIND_INDEX_FLOOR),==,-1);
+  g_assert_cmpint(y_vector_find_index(v,-1.0,FIND_INDEX_NEAREST),==,0);
+  g_assert_cmpint(y_vector_find_index(v,1000.0,FIND_INDEX_CEIL),==,-1);
+
+  /* decreasing, then unsorted */
+  for (int i=0;i<1000;i++) {
+    vals[i]=-0.5*i;
+  }
+  y_data_emit_changed(Y_DATA(vv));
+  g_assert_cmpint(y_vector_find_index(v,-100.2,FIND_INDEX_FLOOR),==,201);
+  g_assert_cmpint(y_vector_find_index(v,-100.2,FIND_INDEX_CEIL),==,200);
+  vals[10] = 7.0;
+  y_data_emit_changed(Y_DATA(vv));
+  g_assert_false(y_vector_is_varying_uniformly(v));
+  g_assert_cmpint(y_vector_find_index(v,6.0,FIND_INDEX_NEAREST),==,10);
+  g_assert_cmpint(y_vector_find_index(v,-100.2,FIND_INDEX_FLOOR),==,201);
+
+  /* linear ranges are not searched */
+  YData *r = y_linear_range_vector_new(-5.0,0.001,10000000);
+  g_assert_cmpint(y_vector_find_index(Y_VECTOR(r),1234.5678,FIND_INDEX_FLOOR),==,1239567);
+  g_assert_cmpint(y_vector_find_index(Y_VECTOR(r),1234.5678,FIND_INDEX_CEIL),==,1239568);
+  g_assert_cmpint(y_vector_find_index(Y_VECTOR(r),1e9,FIND_INDEX_NEAREST),==,9999999);
+  g_object_unref(r);
+}
+
 static void
 test_range_vectors(void)
 {
@@ -128,6 +209,75 @@ test_range_vectors(void)
   g_assert_cmpfloat(0.0, ==, y_vector_get_value(Y_VECTOR(f),0));
   g_assert_true(y_vector_is_varying_uniformly(Y_VECTOR(f)));
   g_object_unref(f);
+
+  /* answered from the parameters */
+  YData *d = y_linear_range_vector_new(100.0,-0.5,1000000);
+  y_vector_get_minmax(Y_VECTOR(d),&mn,&mx);
+  g_assert_cmpfloat(mn, ==, 100.0-0.5*999999);
+  g_assert_cmpfloat(mx, ==, 100.0);
+  y_vector_get_minmax_range(Y_VECTOR(d),10,20,&mn,&mx);
+  g_assert_cmpfloat(mn, ==, 100.0-0.5*19);
+  g_assert_cmpfloat(mx, ==, 95.0);
+  g_assert_true(y_vector_is_varying_uniformly(Y_VECTOR(d)));
+  double part[3];
+  y_vector_get_values_range(Y_VECTOR(d),4,3,part);
+  g_assert_cmpfloat(part[2], ==, 97.0);
+  YOperation *op = g_object_new(Y_TYPE_SUBSET_OPERATION,"start1",500000,"length1",20,NULL);
+  YData *sub = y_derived_vector_new(d,op);
+  g_assert_cmpuint(20, ==, y_vector_get_len(Y_VECTOR(sub)));
+  g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(sub),1), ==, 100.0-0.5*500001);
+  g_object_unref(sub);
+  g_object_unref(d);
+
+  /* nothing to compare */
+  YData *e = y_linear_range_vector_new(1.0,1.0,0);
+  y_vector_get_minmax(Y_VECTOR(e),&mn,&mx);
+  g_assert_cmpfloat(mn, ==, DBL_MAX);
+  g_assert_cmpfloat(mx, ==, -DBL_MAX);
+  g_object_unref(e);
+}
+
+static void
+test_meshgrid(void)
+{
+  YLinearRangeVector *x = Y_LINEAR_RANGE_VECTOR(y_linear_range_vector_new(-1.0,0.5,5));
+  YLinearRangeVector *y = Y_LINEAR_RANGE_VECTOR(y_linear_range_vector_new(10.0,-1.0,3));
+  YData *xg, *yg;
+  y_linear_range_meshgrid(x,y,&xg,&yg);
+  YMatrixSize size = y_matrix_get_size(Y_MATRIX(xg));
+  g_assert_cmpuint(size.rows,==,3);
+  g_assert_cmpuint(size.columns,==,5);
+  y_matrix_get_size(Y_MATRIX(yg));
+  g_assert_cmpfloat(y_matrix_get_value(Y_MATRIX(xg),2,3), ==, 0.5);
+  g_assert_cmpfloat(y_matrix_get_value(Y_MATRIX(yg),2,3), ==, 8.0);
+  double mn, mx;
+  y_matrix_get_minmax(Y_MATRIX(yg),&mn,&mx);
+  g_assert_cmpfloat(mn, ==, 8.0);
+  g_assert_cmpfloat(mx, ==, 10.0);
+  double part[4];
+  y_matrix_get_values_range(Y_MATRIX(xg),3,4,part);
+  g_assert_cmpfloat(part[0], ==, 0.5);
+  g_assert_cmpfloat(part[2], ==, -1.0);
+  const double *v = y_matrix_get_values(Y_MATRIX(yg));
+  g_assert_cmpfloat(v[14], ==, 8.0);
+
+  /* the grid follows its ranges */
+  y_linear_range_vector_set_length(x,7);
+  size = y_matrix_get_size(Y_MATRIX(xg));
+  g_assert_cmpuint(size.columns,==,7);
+  y_matrix_get_minmax(Y_MATRIX(xg),&mn,&mx);
+  g_assert_cmpfloat(mx, ==, 2.0);
+
+  /* an empty grid has no values */
+  y_linear_range_vector_set_length(x,0);
+  size = y_matrix_get_size(Y_MATRIX(xg));
+  g_assert_cmpuint(size.columns,==,0);
+  g_assert_null(y_matrix_get_values(Y_MATRIX(xg)));
+  y_matrix_get_minmax(Y_MATRIX(xg),&mn,&mx);
+  g_assert_cmpfloat(mn, ==, DBL_MAX);
+  g_assert_cmpfloat(mx, ==, -DBL_MAX);
+  g_object_unref(xg);
+  g_object_unref(yg);
 }
 
 static void
@@ -149,6 +299,232 @@ test_ring_vector(void)
   g_object_unref(r);
 }
 
+static void
+test_ring_window(void)
+{
+  YRingVector *r = Y_RING_VECTOR(y_ring_vector_new(40, 0, TRUE));
+  YRingVector *ts = y_ring_vector_get_timestamps(r);
+  int i;
+  for(i=0;i<30;i++) {
+    y_ring_vector_append(r,(double)i);
+    g_usleep(1000);
+  }
+  const double *t = y_vector_get_values(Y_VECTOR(ts));
+  YRingWindow *w = Y_RING_WINDOW(y_ring_window_new(r,t[29]-t[20]));
+  YRingWindow *wt = y_ring_window_get_timestamps(w);
+  g_assert_cmpuint(10, ==, y_vector_get_len(Y_VECTOR(w)));
+  g_assert_cmpuint(10, ==, y_vector_get_len(Y_VECTOR(wt)));
+  /* the window shares the ring's storage */
+  g_assert_true(y_vector_get_values(Y_VECTOR(w)) == y_vector_get_values(Y_VECTOR(r))+20);
+  g_assert_cmpfloat(20.0, ==, y_vector_get_value(Y_VECTOR(w),0));
+  g_assert_cmpfloat(t[20], ==, y_vector_get_value(Y_VECTOR(wt),0));
+
+  /* the window follows the ring after it fills up */
+  for(i=30;i<50;i++) {
+    y_ring_vector_append(r,(double)i);
+    g_usleep(1000);
+  }
+  t = y_vector_get_values(Y_VECTOR(ts));
+  unsigned int n = y_vector_get_len(Y_VECTOR(w));
+  g_assert_cmpuint(n, ==, y_vector_get_len(Y_VECTOR(wt)));
+  g_assert_cmpfloat(49.0, ==, y_vector_get_value(Y_VECTOR(w),n-1));
+  unsigned int first = 40-n;
+  g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(w),0), ==, y_vector_get_value(Y_VECTOR(r),first));
+  g_assert_cmpfloat(t[39]-t[first], <=, t[29]-t[20]);
+  g_assert_cmpfloat(t[39]-t[first-1], >, t[29]-t[20]);
+
+  y_ring_window_set_duration(w,INFINITY);
+  g_assert_cmpuint(40, ==, y_vector_get_len(Y_VECTOR(w)));
+  g_assert_cmpuint(40, ==, y_vector_get_len(Y_VECTOR(wt)));
+  g_object_unref(w);
+  g_object_unref(r);
+}
+
+static void
+test_history(void)
+{
+  /* a slowly varying reading, sampled once a second with 0.01 resolution */
+  const unsigned int n = 100000;
+  YHistory *h = y_history_new(0.0);
+  for (unsigned int i=0;i<n;i++) {
+    y_history_append(h,1.7e9+i,round(100*(20.0+0.5*sin(i/1000.0)))/100);
+  }
+  g_assert_cmpuint(y_history_get_len(h), ==, n);
+  g_assert_cmpuint(y_history_get_size(h), <, 16*n/10);
+  double *t, *v;
+  unsigned int m = y_history_get_range(h,1.7e9+5000.5,1.7e9+5999,&t,&v);
+  g_assert_cmpuint(m, ==, 999);
+  for (unsigned int i=0;i<m;i++) {
+    g_assert_cmpfloat(t[i], ==, 1.7e9+5001+i);
+    g_assert_cmpfloat(v[i], ==, round(100*(20.0+0.5*sin((5001+i)/1000.0)))/100);
+  }
+  g_free(t);
+  g_free(v);
+  g_object_unref(h);
+
+  /* samples thrown away by a ring are kept */
+  YRingVector *r = Y_RING_VECTOR(y_ring_vector_new(100, 0, TRUE));
+  h = y_history_new(0.0);
+  y_ring_vector_set_history(r,h);
+  for (unsigned int i=0;i<1000;i++) {
+    y_ring_vector_append(r,i*0.5);
+  }
+  double arr[150];
+  for (unsigned int i=0;i<150;i++) {
+    arr[i]=(1000+i)*0.5;
+  }
+  y_ring_vector_append_array(r,arr,150);
+  g_assert_cmpuint(y_history_get_len(h), ==, 1050);
+  m = y_history_get_range(h,-INFINITY,INFINITY,&t,&v);
+  g_assert_cmpuint(m, ==, 1050);
+  for (unsigned int i=0;i<m;i++) {
+    g_assert_cmpfloat(v[i], ==, i*0.5);
+    if (i>0)
+      g_assert_cmpfloat(t[i], >=, t[i-1]);
+  }
+  g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(r),0), ==, 1050*0.5);
+  g_free(t);
+  g_free(v);
+  g_object_unref(r);
+  g_object_unref(h);
+}
+
+static void
+test_tiered_ring(void)
+{
+  YTieredRing *r = y_tiered_ring_new(100,4,3);
+  const unsigned int n = 10000;
+  double *v = g_new(double, n);
+  for (unsigned int i=0;i<n;i++) {
+    v[i] = sin(i*0.01)+(i%7)*0.1;
+    y_tiered_ring_append(r,i*0.001,v[i]);
+  }
+  g_assert_cmpuint(y_vector_get_len(Y_VECTOR(y_tiered_ring_get_min(r,0))), ==, 100);
+  g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(y_tiered_ring_get_mean(r,0)),99), ==, v[n-1]);
+
+  /* tier 1 holds buckets 2400..2499 of 4 samples */
+  for (unsigned int k=0;k<100;k++) {
+    unsigned int s0 = 4*(2400+k);
+    double mn = v[s0], mx = v[s0], sum = v[s0];
+    for (unsigned int i=s0+1;i<s0+4;i++) {
+      mn = MIN(mn,v[i]);
+      mx = MAX(mx,v[i]);
+      sum += v[i];
+    }
+    g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(y_tiered_ring_get_times(r,1)),k), ==, s0*0.001);
+    g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(y_tiered_ring_get_min(r,1)),k), ==, mn);
+    g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(y_tiered_ring_get_max(r,1)),k), ==, mx);
+    g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(y_tiered_ring_get_mean(r,1)),k)-sum/4), <, 1e-12);
+  }
+  /* tier 2 holds buckets 525..624 of 16 samples */
+  unsigned int s0 = 16*624;
+  double mn = v[s0], mx = v[s0], sum = 0;
+  for (unsigned int i=s0;i<s0+16;i++) {
+    mn = MIN(mn,v[i]);
+    mx = MAX(mx,v[i]);
+    sum += v[i];
+  }
+  g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(y_tiered_ring_get_times(r,2)),99), ==, s0*0.001);
+  g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(y_tiered_ring_get_min(r,2)),99), ==, mn);
+  g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(y_tiered_ring_get_max(r,2)),99), ==, mx);
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(y_tiered_ring_get_mean(r,2)),99)-sum/16), <, 1e-12);
+
+  unsigned int first, len;
+  g_assert_cmpuint(y_tiered_ring_query(r,8.9995,9.9995,50,&first,&len), ==, 2);
+  g_assert_cmpuint(first, ==, 563-525);
+  g_assert_cmpuint(len, ==, 62);
+  g_assert_cmpuint(y_tiered_ring_query(r,9.9505,9.9995,10,&first,&len), ==, 1);
+  g_assert_cmpuint(first, ==, 88);
+  g_assert_cmpuint(len, ==, 12);
+  g_assert_cmpuint(y_tiered_ring_query(r,9.9505,9.9995,40,&first,&len), ==, 0);
+  g_assert_cmpuint(len, ==, 49);
+  g_assert_cmpuint(y_tiered_ring_query(r,0.0,9.9995,10,NULL,NULL), ==, 2);
+
+  g_free(v);
+  g_object_unref(r);
+}
+
+static void
+test_ring_spill(void)
+{
+  GError *err = NULL;
+  gchar *dir = g_dir_make_tmp("ydata-XXXXXX", &err);
+  g_assert_no_error(err);
+  gchar *filename = g_build_filename(dir, "spill.h5", NULL);
+  YFile *f = y_file_open_for_writing(filename, TRUE, &err);
+  g_assert_no_error(err);
+
+  /* elements thrown away by a ring are written to the file */
+  YRingVector *r = Y_RING_VECTOR(y_ring_vector_new(100, 0, TRUE));
+  YSpill *s = y_spill_new(f, "ring", 1, TRUE, &err);
+  g_assert_no_error(err);
+  y_ring_vector_set_spill(r,s);
+  const unsigned int n = 10000;
+  for (unsigned int i=0;i<n;i++) {
+    y_ring_vector_append(r,i*0.5);
+  }
+  double arr[250];
+  for (unsigned int i=0;i<250;i++) {
+    arr[i]=(n+i)*0.5;
+  }
+  y_ring_vector_append_array(r,arr,250);
+  g_assert_cmpuint(y_spill_get_n_rows(s), ==, n+150);
+
+  double *t, *v;
+  unsigned int m = y_ring_vector_get_range(r,-INFINITY,INFINITY,&t,&v);
+  g_assert_cmpuint(m, ==, n+250);
+  for (unsigned int i=0;i<m;i++) {
+    g_assert_cmpfloat(v[i], ==, i*0.5);
+    if (i>0)
+      g_assert_cmpfloat(t[i], >=, t[i-1]);
+  }
+  /* an older range comes from the file only */
+  double t0 = t[5000], t1 = t[6000];
+  g_free(t);
+  g_free(v);
+  g_assert_true(y_spill_flush(s,&err));
+  g_assert_no_error(err);
+  m = y_ring_vector_get_range(r,t0,t1,&t,&v);
+  g_assert_cmpuint(m, >=, 1001);
+  for (unsigned int i=0;i<m;i++) {
+    g_assert_cmpfloat(t[i], >=, t0);
+    g_assert_cmpfloat(t[i], <=, t1);
+    if (i>0)
+      g_assert_cmpfloat(v[i], ==, v[i-1]+0.5);
+  }
+  g_free(t);
+  g_free(v);
+  g_object_unref(r);
+  g_object_unref(s);
+
+  /* rows of a matrix */
+  YRingMatrix *rm = Y_RING_MATRIX(y_ring_matrix_new(3, 50, 0, TRUE));
+  s = y_spill_new(f, "matrix", 3, TRUE, &err);
+  g_assert_no_error(err);
+  y_ring_matrix_set_spill(rm,s);
+  for (unsigned int i=0;i<200;i++) {
+    double row[3] = {i, 2.0*i, 3.0*i};
+    y_ring_matrix_append(rm,row,3);
+  }
+  g_assert_cmpuint(y_vector_get_len(Y_VECTOR(y_ring_matrix_get_timestamps(rm))), ==, 50);
+  m = y_ring_matrix_get_range(rm,-INFINITY,INFINITY,&t,&v);
+  g_assert_cmpuint(m, ==, 200);
+  for (unsigned int i=0;i<m;i++) {
+    for (unsigned int k=0;k<3;k++)
+      g_assert_cmpfloat(v[3*i+k], ==, (k+1.0)*i);
+  }
+  g_free(t);
+  g_free(v);
+  g_object_unref(rm);
+  g_object_unref(s);
+
+  g_object_unref(f);
+  g_remove(filename);
+  g_rmdir(dir);
+  g_free(filename);
+  g_free(dir);
+}
+
 static void
 test_ring_matrix(void)
 {
@@ -260,6 +636,773 @@ test_derived_vector_FFT_phase(void)
   g_object_unref(v);
 }
 
+static void
+test_fft_single(void)
+{
+  YOperation *op = g_object_new(Y_TYPE_FFT_OPERATION,"type",FFT_POWER,NULL);
+  YData *input = y_val_vector_new_alloc(1000);
+  double *d = y_val_vector_get_array(Y_VAL_VECTOR(input));
+  for (int i=0;i<1000;i++) {
+    d[i]=cos(2*G_PI*50*i/1000.0)+g_test_rand_double_range(-0.1,0.1);
+  }
+  YDerivedVector *v = Y_DERIVED_VECTOR(y_derived_vector_new(Y_DATA(input),op));
+  double p[501];
+  for (int k=0;k<501;k++) {
+    p[k]=y_vector_get_value(Y_VECTOR(v),k);
+  }
+  g_object_set(op,"precision",FFT_PRECISION_SINGLE,NULL);
+  y_data_emit_changed(input);
+  g_assert_cmpuint(501,==,y_vector_get_len(Y_VECTOR(v)));
+  for (int k=0;k<501;k++) {
+    g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(v),k)-p[k]), <, 1e-3*p[50]);
+  }
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(v),50)-p[50]), <, 1e-4*p[50]);
+
+  /* and back again */
+  g_object_set(op,"precision",FFT_PRECISION_DOUBLE,NULL);
+  y_data_emit_changed(input);
+  g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(v),50), ==, p[50]);
+  g_object_unref(v);
+}
+
+static void
+test_fft_complex(void)
+{
+  YOperation *op = y_fft_operation_new(FFT_COMPLEX);
+  YOperation *inv = g_object_new(Y_TYPE_FFT_OPERATION,"inverse",TRUE,NULL);
+  YData *input = y_val_vector_new_alloc(64);
+  double *d = y_val_vector_get_array(Y_VAL_VECTOR(input));
+  for (int i=0;i<64;i++) {
+    d[i]=sin(2*G_PI*4*i/64.0)+g_test_rand_double_range(-1.0,1.0);
+  }
+  YData *s = y_derived_vector_new(input,op);
+  g_assert_cmpuint(2*(64/2+1),==,y_vector_get_len(Y_VECTOR(s)));
+  YDerivedVector *v = Y_DERIVED_VECTOR(y_derived_vector_new(s,inv));
+  g_assert_cmpuint(64,==,y_vector_get_len(Y_VECTOR(v)));
+  for (int i=0;i<64;i++) {
+    g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(v),i)-d[i]), <, 1e-12);
+  }
+
+  /* magnitude and phase from one transform */
+  for (int i=0;i<64;i++) {
+    d[i]=sin(2*G_PI*4*i/64.0);
+  }
+  g_object_set(op,"type",FFT_MAG_PHASE,NULL);
+  y_data_emit_changed(input);
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(s),4)-32.0), <, 1e-9);
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(s),33+4)+G_PI/2), <, 1e-9);
+
+  /* rows of a matrix */
+  YData *m = y_val_matrix_new_alloc(3,16);
+  double *dm = y_val_matrix_get_array(Y_VAL_MATRIX(m));
+  for (int i=0;i<3*16;i++) {
+    dm[i]=g_test_rand_double_range(-1.0,1.0);
+  }
+  g_object_set(op,"type",FFT_COMPLEX,"axis",FFT_ROWS,NULL);
+  g_object_set(inv,"axis",FFT_ROWS,NULL);
+  YData *sm = y_derived_matrix_new(m,op);
+  YDerivedMatrix *vm = Y_DERIVED_MATRIX(y_derived_matrix_new(sm,inv));
+  g_assert_cmpuint(3,==,y_matrix_get_rows(Y_MATRIX(vm)));
+  g_assert_cmpuint(16,==,y_matrix_get_columns(Y_MATRIX(vm)));
+  for (int i=0;i<3;i++) {
+    for (int j=0;j<16;j++) {
+      g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(vm),i,j)-dm[i*16+j]), <, 1e-12);
+    }
+  }
+  g_object_unref(v);
+  g_object_unref(vm);
+}
+
+static void
+test_fft_padding(void)
+{
+  g_assert_cmpuint(98,==,y_fft_padded_length(FFT_PAD_SMOOTH,97));
+  g_assert_cmpuint(125,==,y_fft_padded_length(FFT_PAD_SMOOTH,121));
+  g_assert_cmpuint(128,==,y_fft_padded_length(FFT_PAD_POW2,97));
+  g_assert_cmpuint(97,==,y_fft_padded_length(FFT_PAD_NONE,97));
+
+  YOperation *op = g_object_new(Y_TYPE_FFT_OPERATION,"padding",FFT_PAD_POW2,NULL);
+  YData *input = y_val_vector_new_alloc(97);
+  double *d = y_val_vector_get_array(Y_VAL_VECTOR(input));
+  for (int i=0;i<97;i++) {
+    d[i]=1.0;
+  }
+  YDerivedVector *v = Y_DERIVED_VECTOR(y_derived_vector_new(Y_DATA(input),op));
+  g_assert_cmpuint(128/2+1,==,y_vector_get_len(Y_VECTOR(v)));
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(v),0)-97.0), <, 1e-9);
+
+  YData *t = y_linear_range_vector_new(0.0,0.01,97);
+  YFourierLinearRangeVector *f = Y_FOURIER_LINEAR_RANGE_VECTOR(y_fourier_linear_range_vector_new(Y_LINEAR_RANGE_VECTOR(t)));
+  g_assert_cmpuint(97/2+1,==,y_vector_get_len(Y_VECTOR(f)));
+  y_fourier_linear_range_vector_set_padding(f,FFT_PAD_POW2);
+  g_assert_cmpuint(128/2+1,==,y_vector_get_len(Y_VECTOR(f)));
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(f),1)-1.0/(128*0.01)), <, 1e-9);
+
+  g_object_set(op,"padding",FFT_PAD_SMOOTH,NULL);
+  y_data_emit_changed(input);
+  g_assert_cmpuint(98/2+1,==,y_vector_get_len(Y_VECTOR(v)));
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(v),0)-97.0), <, 1e-9);
+  g_object_unref(v);
+  g_object_unref(f);
+}
+
+static void
+test_fft_wisdom(void)
+{
+  YOperation *op = g_object_new(Y_TYPE_FFT_OPERATION,"type",FFT_MAG,"rigor",FFT_PATIENT,NULL);
+  YData *input = y_val_vector_new_alloc(64);
+  double *d = y_val_vector_get_array(Y_VAL_VECTOR(input));
+  for (int i=0;i<64;i++) {
+    d[i]=cos(2*G_PI*4*i/64.0);
+  }
+  YDerivedVector *v = Y_DERIVED_VECTOR(y_derived_vector_new(Y_DATA(input),op));
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(v),4)-32.0), <, 1e-9);
+
+  GError *err = NULL;
+  gchar *dir = g_dir_make_tmp("ydata-XXXXXX", &err);
+  g_assert_no_error(err);
+  gchar *filename = g_build_filename(dir, "wisdom", NULL);
+  g_assert_true(y_fft_export_wisdom(filename, &err));
+  g_assert_no_error(err);
+  y_fft_plan_cache_clear();
+  g_assert_true(y_fft_import_wisdom(filename, &err));
+  g_assert_no_error(err);
+  g_remove(filename);
+  g_rmdir(dir);
+  g_free(filename);
+  g_free(dir);
+
+  /* plans are recreated from the wisdom */
+  d[0]=2.0;
+  y_data_emit_changed(input);
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(v),0)-1.0), <, 1e-9);
+  g_object_unref(v);
+}
+
+static void
+on_derived_changed(YData *data, gpointer user_data)
+{
+  int *count = (int *) user_data;
+  (*count)++;
+}
+
+static void
+fill_cos(YData *input, double f)
+{
+  unsigned int len = y_vector_get_len(Y_VECTOR(input));
+  double *d = y_val_vector_get_array(Y_VAL_VECTOR(input));
+  for (unsigned int i=0;i<len;i++) {
+    d[i]=cos(2*G_PI*f*i/len);
+  }
+}
+
+static void
+test_fft_plan_cache(void)
+{
+  double *in = fftw_alloc_real(1024);
+  fftw_complex *out = fftw_alloc_complex(513);
+  fftw_plan p = y_fft_plan_r2c_1d(64,in,out,FFT_ESTIMATE);
+  g_assert_nonnull(p);
+  g_assert_true(p == y_fft_plan_r2c_1d(64,in,out,FFT_ESTIMATE));
+  y_fft_plan_release(p);
+
+  /* a plan in use survives many other lengths */
+  for (int n=100;n<200;n++) {
+    y_fft_plan_release(y_fft_plan_r2c_1d(n,in,out,FFT_ESTIMATE));
+  }
+  g_assert_true(p == y_fft_plan_r2c_1d(64,in,out,FFT_ESTIMATE));
+  y_fft_plan_release(p);
+  y_fft_plan_release(p);
+
+  /* plans in use don't push out unused ones */
+  fftw_plan live[40];
+  for (int n=0;n<40;n++) {
+    live[n] = y_fft_plan_r2c_1d(300+n,in,out,FFT_ESTIMATE);
+  }
+  g_assert_true(p == y_fft_plan_r2c_1d(64,in,out,FFT_ESTIMATE));
+  y_fft_plan_release(p);
+  for (int n=0;n<40;n++) {
+    y_fft_plan_release(live[n]);
+  }
+
+  /* and an unused one is destroyed to make room */
+  for (int n=100;n<200;n++) {
+    y_fft_plan_release(y_fft_plan_r2c_1d(n,in,out,FFT_ESTIMATE));
+  }
+  p = y_fft_plan_r2c_1d(64,in,out,FFT_ESTIMATE);
+  g_assert_nonnull(p);
+  for (int i=0;i<64;i++) {
+    in[i] = i%5;
+  }
+  fftw_execute_dft_r2c(p,in,out);
+  g_assert_cmpfloat(out[0][0], ==, 126.0);
+  y_fft_plan_release(p);
+  fftw_free(in);
+  fftw_free(out);
+}
+
+static void
+test_fft_threaded(void)
+{
+  const int nvec = 16;
+  const unsigned int len = 4096;
+  YOperation *op = y_fft_operation_new(FFT_MAG);
+  YData *inputs[16];
+  YData *outputs[16];
+  int count = 0;
+  for (int k=0;k<nvec;k++) {
+    inputs[k] = y_val_vector_new_alloc(len);
+    fill_cos(inputs[k],k+1);
+    outputs[k] = y_derived_vector_new(inputs[k],op);
+    g_object_set(outputs[k],"autorun",TRUE,NULL);
+    g_signal_connect(outputs[k],"changed",G_CALLBACK(on_derived_changed),&count);
+  }
+  /* all transforms run in worker threads at the same time */
+  for (int k=0;k<nvec;k++) {
+    y_data_emit_changed(inputs[k]);
+  }
+  /* values are missing until the first result arrives */
+  const double *pending = y_vector_get_values(Y_VECTOR(outputs[0]));
+  g_assert_nonnull(pending);
+  g_assert_true(isnan(pending[1]));
+  double prange[2] = {0.0, 0.0};
+  y_vector_get_values_range(Y_VECTOR(outputs[0]),0,2,prange);
+  g_assert_true(isnan(prange[0]) && isnan(prange[1]));
+  while (count < nvec) {
+    g_main_context_iteration(NULL,TRUE);
+  }
+  for (int k=0;k<nvec;k++) {
+    YVector *v = Y_VECTOR(outputs[k]);
+    g_assert_cmpuint(len/2+1,==,y_vector_get_len(v));
+    g_assert_cmpfloat(fabs(y_vector_get_value(v,k+1)-len/2), <, 1e-6);
+    g_assert_cmpfloat(fabs(y_vector_get_value(v,k+2)), <, 1e-6);
+  }
+
+  /* a change while the transform is running is picked up afterwards */
+  count = 0;
+  fill_cos(inputs[0],7);
+  y_data_emit_changed(inputs[0]);
+  fill_cos(inputs[0],9);
+  y_data_emit_changed(inputs[0]);
+  while (count < 2) {
+    g_main_context_iteration(NULL,TRUE);
+  }
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(outputs[0]),9)-len/2), <, 1e-6);
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(outputs[0]),7)), <, 1e-6);
+
+  for (int k=0;k<nvec;k++) {
+    g_object_unref(outputs[k]);
+    g_object_unref(inputs[k]);
+  }
+  g_object_unref(op);
+}
+
+/* DFT of the last n values of x at a (possibly fractional) bin */
+static void
+dft_bin(const double *x, int n, double bin, double *re, double *im)
+{
+  *re = 0.0;
+  *im = 0.0;
+  for (int m=0;m<n;m++) {
+    *re += x[m]*cos(2*G_PI*bin*m/n);
+    *im -= x[m]*sin(2*G_PI*bin*m/n);
+  }
+}
+
+static void
+test_sliding_dft(void)
+{
+  double bins[] = {4.0, 10.0, 6.5};
+  YOperation *op = y_sliding_dft_operation_new(64,bins,3);
+  g_object_set(op,"type",FFT_COMPLEX,NULL);
+  YRingVector *r = Y_RING_VECTOR(y_ring_vector_new(256, 0, FALSE));
+  YDerivedVector *v = Y_DERIVED_VECTOR(y_derived_vector_new(Y_DATA(r),op));
+  g_assert_cmpuint(6,==,y_vector_get_len(Y_VECTOR(v)));
+
+  double x[1000];
+  unsigned int total = 0;
+  while(total<1000) {
+    unsigned int len = MIN(1+g_test_rand_int_range(0,40),1000-total);
+    for(unsigned int i=0;i<len;i++) {
+      x[total+i]=cos(2*G_PI*4*(total+i)/64.0)+g_test_rand_double_range(-1.0,1.0);
+    }
+    y_ring_vector_append_array(r,x+total,len);
+    total += len;
+    if (total < 64)
+      continue;
+    for(int k=0;k<3;k++) {
+      double re, im;
+      dft_bin(x+total-64,64,bins[k],&re,&im);
+      g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(v),2*k)-re), <, 1e-9);
+      g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(v),2*k+1)-im), <, 1e-9);
+    }
+  }
+  g_object_unref(v);
+}
+
+static void
+test_lock_in(void)
+{
+  YOperation *op = y_lock_in_operation_new(0.05,1.0);
+  g_object_set(op,"time-constant",50.0,"order",4,"decimation",10,"rows",100,NULL);
+  YRingVector *r = Y_RING_VECTOR(y_ring_vector_new(1024, 0, FALSE));
+  YDerivedMatrix *m = Y_DERIVED_MATRIX(y_derived_matrix_new(Y_DATA(r),op));
+  g_assert_cmpuint(100,==,y_matrix_get_rows(Y_MATRIX(m)));
+  g_assert_cmpuint(4,==,y_matrix_get_columns(Y_MATRIX(m)));
+
+  double x[3000];
+  for (int i=0;i<3000;i++) {
+    x[i]=0.7*cos(2*G_PI*0.05*i+0.3);
+  }
+  unsigned int total = 0;
+  while(total<3000) {
+    unsigned int len = MIN(1+g_test_rand_int_range(0,300),3000-total);
+    y_ring_vector_append_array(r,x+total,len);
+    total += len;
+    y_matrix_get_values(Y_MATRIX(m));
+  }
+  g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(m),99,LOCK_IN_X)-0.7*cos(0.3)), <, 1e-4);
+  g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(m),99,LOCK_IN_Y)-0.7*sin(0.3)), <, 1e-4);
+  g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(m),99,LOCK_IN_R)-0.7), <, 1e-4);
+  g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(m),99,LOCK_IN_THETA)-0.3), <, 1e-4);
+
+  /* the same as demodulating everything at once */
+  YOperation *op2 = y_lock_in_operation_new(0.05,1.0);
+  g_object_set(op2,"time-constant",50.0,"order",4,"decimation",10,"rows",100,NULL);
+  YData *input = y_val_vector_new(x,3000,NULL);
+  YDerivedMatrix *m2 = Y_DERIVED_MATRIX(y_derived_matrix_new(input,op2));
+  const double *v1 = y_matrix_get_values(Y_MATRIX(m));
+  const double *v2 = y_matrix_get_values(Y_MATRIX(m2));
+  for (int i=0;i<400;i++) {
+    g_assert_cmpfloat(fabs(v1[i]-v2[i]), <, 1e-9);
+  }
+  g_object_unref(m);
+  g_object_unref(m2);
+}
+
+static void
+test_filter(void)
+{
+  double h[100];
+  for (int k=0;k<100;k++) {
+    h[k]=g_test_rand_double_range(-1.0,1.0);
+  }
+  /* one low-pass biquad, b0 b1 b2 a0 a1 a2 */
+  double sos[6] = {0.1, 0.2, 0.1, 1.0, -0.9, 0.3};
+  YOperation *op = y_filter_operation_new_fir(h,100);
+  y_filter_operation_set_sections(Y_FILTER_OPERATION(op),sos,1);
+  YRingVector *r = Y_RING_VECTOR(y_ring_vector_new(512, 0, FALSE));
+  YDerivedVector *v = Y_DERIVED_VECTOR(y_derived_vector_new(Y_DATA(r),op));
+
+  double x[3000], y[3000];
+  double s1 = 0.0, s2 = 0.0;
+  for (int i=0;i<3000;i++) {
+    x[i]=g_test_rand_double_range(-1.0,1.0);
+    double f = 0.0;
+    for (int k=0;k<100 && k<=i;k++) {
+      f += h[k]*x[i-k];
+    }
+    y[i] = 0.1*f + s1;
+    s1 = 0.2*f + 0.9*y[i] + s2;
+    s2 = 0.1*f - 0.3*y[i];
+  }
+  unsigned int total = 0;
+  while(total<3000) {
+    unsigned int len = MIN(1+g_test_rand_int_range(0,400),3000-total);
+    y_ring_vector_append_array(r,x+total,len);
+    total += len;
+    unsigned int n = y_vector_get_len(Y_VECTOR(v));
+    g_assert_cmpuint(n,==,MIN(total,512));
+    const double *out = y_vector_get_values(Y_VECTOR(v));
+    for (unsigned int i=0;i<n;i++) {
+      g_assert_cmpfloat(fabs(out[i]-y[total-n+i]), <, 1e-9);
+    }
+  }
+
+  /* direct and FFT convolution agree */
+  YData *input = y_val_vector_new(x,3000,NULL);
+  YOperation *op2 = y_filter_operation_new_fir(h,100);
+  g_object_set(op2,"method",FILTER_DIRECT,NULL);
+  YDerivedVector *v2 = Y_DERIVED_VECTOR(y_derived_vector_new(input,op2));
+  const double *d2 = y_vector_get_values(Y_VECTOR(v2));
+  double d[3000];
+  memcpy(d,d2,sizeof(d));
+  g_object_set(op2,"method",FILTER_FFT,NULL);
+  d2 = y_vector_get_values(Y_VECTOR(v2));
+  for (int i=0;i<3000;i++) {
+    g_assert_cmpfloat(fabs(d2[i]-d[i]), <, 1e-9);
+  }
+  g_object_unref(v);
+  g_object_unref(v2);
+}
+
+static void
+test_correlate(void)
+{
+  YData *ref = y_val_vector_new_alloc(256);
+  YData *input = y_val_vector_new_alloc(200);
+  double *r = y_val_vector_get_array(Y_VAL_VECTOR(ref));
+  double *x = y_val_vector_get_array(Y_VAL_VECTOR(input));
+  for (int i=0;i<256;i++) {
+    r[i]=exp(-pow((i-100)/8.0,2));
+  }
+  for (int i=0;i<200;i++) {
+    x[i]=exp(-pow((i-107.3)/8.0,2))+0.01*g_test_rand_double_range(-1.0,1.0);
+  }
+  y_data_emit_changed(ref);
+  y_data_emit_changed(input);
+  YOperation *op = y_correlate_operation_new(Y_VECTOR(ref));
+  YDerivedVector *v = Y_DERIVED_VECTOR(y_derived_vector_new(input,op));
+  g_assert_cmpuint(y_vector_get_len(Y_VECTOR(v)),==,200+256-1);
+  const double *c = y_vector_get_values(Y_VECTOR(v));
+  for (int k=-255;k<200;k++) {
+    double sum = 0.0;
+    for (int i=MAX(0,-k);i<256 && i+k<200;i++) {
+      sum += x[i+k]*r[i];
+    }
+    g_assert_cmpfloat(fabs(c[k+255]-sum), <, 1e-9);
+  }
+
+  YOperation *op2 = y_correlate_operation_new(Y_VECTOR(ref));
+  g_object_set(op2,"output",CORRELATE_OUTPUT_PEAK_LAG,"mode",CORRELATE_NORMALIZED,NULL);
+  YData *lag = y_derived_scalar_new(input,op2);
+  g_assert_cmpfloat(fabs(y_scalar_get_value(Y_SCALAR(lag))-7.3), <, 0.1);
+
+  /* changing the reference updates the cached transform */
+  for (int i=0;i<256;i++) {
+    r[i]=exp(-pow((i-110)/8.0,2));
+  }
+  y_data_emit_changed(ref);
+  g_assert_cmpfloat(fabs(y_scalar_get_value(Y_SCALAR(lag))+2.7), <, 0.1);
+
+  /* autocorrelation peaks at zero lag */
+  g_object_set(op2,"reference",NULL,NULL);
+  g_assert_cmpfloat(fabs(y_scalar_get_value(Y_SCALAR(lag))), <, 1e-6);
+  g_object_unref(v);
+  g_object_unref(lag);
+}
+
+static void
+test_rolling_stats(void)
+{
+  YRingVector *r = Y_RING_VECTOR(y_ring_vector_new(300, 0, FALSE));
+  YOperation *ops[5];
+  YDerivedVector *v[5];
+  for (int k=0;k<5;k++) {
+    ops[k] = y_rolling_stats_operation_new(ROLLING_MEAN+k,50);
+    v[k] = Y_DERIVED_VECTOR(y_derived_vector_new(Y_DATA(r),ops[k]));
+  }
+  double x[2000];
+  for (int i=0;i<2000;i++) {
+    x[i]=100.0+g_test_rand_double_range(-1.0,1.0);
+  }
+  unsigned int total = 0;
+  while(total<2000) {
+    unsigned int len = MIN(1+g_test_rand_int_range(0,120),2000-total);
+    y_ring_vector_append_array(r,x+total,len);
+    total += len;
+    unsigned int n = y_vector_get_len(Y_VECTOR(r));
+    const double *out[5];
+    for (int k=0;k<5;k++) {
+      g_assert_cmpuint(y_vector_get_len(Y_VECTOR(v[k])),==,n);
+      out[k] = y_vector_get_values(Y_VECTOR(v[k]));
+    }
+    for (unsigned int i=0;i<n;i++) {
+      unsigned int end = total-n+i;
+      unsigned int start = end>=49 ? end-49 : 0;
+      double mean = 0.0, m2 = 0.0, min = INFINITY, max = -INFINITY;
+      for (unsigned int j=start;j<=end;j++) {
+        mean += x[j];
+        min = MIN(min,x[j]);
+        max = MAX(max,x[j]);
+      }
+      mean /= end-start+1;
+      for (unsigned int j=start;j<=end;j++) {
+        m2 += (x[j]-mean)*(x[j]-mean);
+      }
+      double var = end>start ? m2/(end-start) : 0.0;
+      g_assert_cmpfloat(fabs(out[ROLLING_MEAN][i]-mean), <, 1e-9);
+      g_assert_cmpfloat(fabs(out[ROLLING_VARIANCE][i]-var), <, 1e-9);
+      g_assert_cmpfloat(fabs(out[ROLLING_STDDEV][i]-sqrt(var)), <, 1e-9);
+      g_assert_cmpfloat(out[ROLLING_MIN][i], ==, min);
+      g_assert_cmpfloat(out[ROLLING_MAX][i], ==, max);
+    }
+  }
+  for (int k=0;k<5;k++) {
+    g_object_unref(v[k]);
+  }
+
+  /* NaN is skipped, and leaves the window like any other sample */
+  YRingVector *rn = Y_RING_VECTOR(y_ring_vector_new(10, 0, FALSE));
+  YData *vmin = y_derived_vector_new(Y_DATA(rn),y_rolling_stats_operation_new(ROLLING_MIN,3));
+  YData *vmax = y_derived_vector_new(Y_DATA(rn),y_rolling_stats_operation_new(ROLLING_MAX,3));
+  const double xn[7] = {1.0, NAN, 5.0, 2.0, 0.0, 4.0, NAN};
+  const double emin[7] = {1.0, 1.0, 1.0, 2.0, 0.0, 0.0, 0.0};
+  const double emax[7] = {1.0, 1.0, 5.0, 5.0, 5.0, 4.0, 4.0};
+  y_ring_vector_append_array(rn,xn,7);
+  for (int i=0;i<7;i++) {
+    g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(vmin),i), ==, emin[i]);
+    g_assert_cmpfloat(y_vector_get_value(Y_VECTOR(vmax),i), ==, emax[i]);
+  }
+  g_object_unref(vmin);
+  g_object_unref(vmax);
+}
+
+static void
+test_decimate(void)
+{
+  const unsigned int n = 100000;
+  YData *input = y_val_vector_new_alloc(n);
+  double *x = y_val_vector_get_array(Y_VAL_VECTOR(input));
+  for (unsigned int i=0;i<n;i++) {
+    x[i]=sin(i/1000.0)+0.1*g_test_rand_double_range(-1.0,1.0);
+  }
+  x[54321] = 10.0;
+  y_data_emit_changed(input);
+
+  YOperation *op = y_decimate_operation_new(DECIMATE_ENVELOPE,100);
+  YDerivedMatrix *m = Y_DERIVED_MATRIX(y_derived_matrix_new(input,op));
+  for (int pass=0;pass<2;pass++) {
+    /* whole vector, then a zoomed range */
+    unsigned int a = pass ? 20001 : 0;
+    unsigned int b = pass ? 63000 : n;
+    YMatrixSize size = y_matrix_get_size(Y_MATRIX(m));
+    g_assert_cmpuint(size.rows,==,200);
+    g_assert_cmpuint(size.columns,==,2);
+    const double *out = y_matrix_get_values(Y_MATRIX(m));
+    for (unsigned int p=0;p<100;p++) {
+      unsigned int lo = a + (guint64) (b-a)*p/100;
+      unsigned int hi = a + (guint64) (b-a)*(p+1)/100;
+      double mn = INFINITY, mx = -INFINITY;
+      for (unsigned int i=lo;i<hi;i++) {
+        mn = MIN(mn,x[i]);
+        mx = MAX(mx,x[i]);
+      }
+      double u = out[4*p+1], v = out[4*p+3];
+      g_assert_cmpfloat(MIN(u,v), ==, mn);
+      g_assert_cmpfloat(MAX(u,v), ==, mx);
+      g_assert_cmpfloat(out[4*p], <=, out[4*p+2]);
+      g_assert_cmpfloat(out[4*p], >=, lo);
+      g_assert_cmpfloat(out[4*p+2], <, hi);
+    }
+    y_decimate_operation_set_range(Y_DECIMATE_OPERATION(op),20001,63000);
+  }
+
+  /* few enough points to output them all */
+  y_decimate_operation_set_range(Y_DECIMATE_OPERATION(op),500,650);
+  YMatrixSize size = y_matrix_get_size(Y_MATRIX(m));
+  g_assert_cmpuint(size.rows,==,150);
+  g_assert_cmpfloat(y_matrix_get_value(Y_MATRIX(m),0,0), ==, 500);
+  g_assert_cmpfloat(y_matrix_get_value(Y_MATRIX(m),0,1), ==, x[500]);
+
+  /* LTTB keeps the ends and the spike */
+  YOperation *op2 = y_decimate_operation_new(DECIMATE_LTTB,100);
+  YDerivedMatrix *m2 = Y_DERIVED_MATRIX(y_derived_matrix_new(input,op2));
+  size = y_matrix_get_size(Y_MATRIX(m2));
+  g_assert_cmpuint(size.rows,==,100);
+  g_assert_cmpfloat(y_matrix_get_value(Y_MATRIX(m2),0,0), ==, 0);
+  g_assert_cmpfloat(y_matrix_get_value(Y_MATRIX(m2),99,0), ==, n-1);
+  gboolean found = FALSE;
+  for (unsigned int i=0;i<100;i++) {
+    found = found || y_matrix_get_value(Y_MATRIX(m2),i,0) == 54321;
+  }
+  g_assert_true(found);
+  g_object_unref(m);
+  g_object_unref(m2);
+}
+
+static void
+test_interpolate(void)
+{
+  const unsigned int n = 200;
+  YData *xs = y_val_vector_new_alloc(n);
+  YData *ys = y_val_vector_new_alloc(n);
+  YData *xr = y_val_vector_new_alloc(n);
+  YData *yr = y_val_vector_new_alloc(n);
+  double *x = y_val_vector_get_array(Y_VAL_VECTOR(xs));
+  double *y = y_val_vector_get_array(Y_VAL_VECTOR(ys));
+  for (unsigned int i=0;i<n;i++) {
+    x[i]=0.05*i+0.01*sin(i);
+    y[i]=sin(x[i]);
+    y_val_vector_get_array(Y_VAL_VECTOR(xr))[n-1-i]=x[i];
+    y_val_vector_get_array(Y_VAL_VECTOR(yr))[n-1-i]=y[i];
+  }
+  y_data_emit_changed(xs);
+  y_data_emit_changed(ys);
+
+  /* uniform targets, increasing and decreasing x */
+  YData *grid = y_linear_range_vector_new(0.1,0.01,891);
+  YOperation *lin = y_interpolate_operation_new(Y_VECTOR(xs),Y_VECTOR(grid),INTERPOLATE_LINEAR);
+  YOperation *cub = y_interpolate_operation_new(Y_VECTOR(xs),Y_VECTOR(grid),INTERPOLATE_CUBIC);
+  YOperation *cubr = y_interpolate_operation_new(Y_VECTOR(xr),Y_VECTOR(grid),INTERPOLATE_CUBIC);
+  YData *vl = y_derived_vector_new(ys,lin);
+  YData *vc = y_derived_vector_new(ys,cub);
+  YData *vr = y_derived_vector_new(yr,cubr);
+  g_assert_cmpuint(y_vector_get_len(Y_VECTOR(vl)),==,891);
+  for (unsigned int i=0;i<891;i++) {
+    double t = 0.1+0.01*i;
+    g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(vl),i)-sin(t)), <, 1e-3);
+    g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(vc),i)-sin(t)), <, 1e-5);
+    g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(vr),i)-y_vector_get_value(Y_VECTOR(vc),i)), <, 1e-12);
+  }
+
+  /* unordered targets, including some outside x */
+  const unsigned int m = 101;
+  YData *shuffled = y_val_vector_new_alloc(m);
+  double *t = y_val_vector_get_array(Y_VAL_VECTOR(shuffled));
+  for (unsigned int k=0;k<m;k++) {
+    t[k]=fmod(k*0.37,11.0)-0.5;
+  }
+  y_data_emit_changed(shuffled);
+  YOperation *near = y_interpolate_operation_new(Y_VECTOR(xs),Y_VECTOR(shuffled),INTERPOLATE_NEAREST);
+  YData *vn = y_derived_vector_new(ys,near);
+  g_object_set(lin,"target",shuffled,NULL);
+  for (unsigned int k=0;k<m;k++) {
+    double a = y_vector_get_value(Y_VECTOR(vl),k);
+    double b = y_vector_get_value(Y_VECTOR(vn),k);
+    if (t[k] < x[0] || t[k] > x[n-1]) {
+      g_assert_true(isnan(a));
+      g_assert_true(isnan(b));
+      continue;
+    }
+    unsigned int j = 0;
+    while (j+2<n && x[j+1]<=t[k]) j++;
+    double f = (t[k]-x[j])/(x[j+1]-x[j]);
+    g_assert_cmpfloat(fabs(a-(y[j]+f*(y[j+1]-y[j]))), <, 1e-12);
+    g_assert_cmpfloat(b, ==, f<=0.5 ? y[j] : y[j+1]);
+  }
+
+  /* spline is recomputed when the input changes */
+  for (unsigned int i=0;i<n;i++) {
+    y[i]*=2.0;
+  }
+  y_data_emit_changed(ys);
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(vc),400)-2.0*sin(4.1)), <, 2e-5);
+
+  g_object_unref(vl);
+  g_object_unref(vc);
+  g_object_unref(vr);
+  g_object_unref(vn);
+}
+
+static void
+test_align(void)
+{
+  YRingVector *a = Y_RING_VECTOR(y_ring_vector_new(100, 0, TRUE));
+  YRingVector *b = Y_RING_VECTOR(y_ring_vector_new(100, 0, TRUE));
+  YOperation *hold = y_align_operation_new(ALIGN_HOLD,50);
+  g_object_set(hold,"clock",ALIGN_CLOCK_MERGED,NULL);
+  y_align_operation_add_channel(Y_ALIGN_OPERATION(hold),b);
+  YOperation *lin = y_align_operation_new(ALIGN_LINEAR,50);
+  y_align_operation_add_channel(Y_ALIGN_OPERATION(lin),b);
+  YData *mh = y_derived_matrix_new(Y_DATA(a),hold);
+  YData *ml = y_derived_matrix_new(Y_DATA(a),lin);
+
+  for (int i=0;i<30;i++) {
+    y_ring_vector_append(a,i);
+    g_usleep(500);
+    if (i%3==0) {
+      y_ring_vector_append(b,100+i);
+      g_usleep(500);
+    }
+    if (i%5==4) {
+      /* run part way through to exercise the incremental update */
+      y_matrix_get_values(Y_MATRIX(mh));
+      y_matrix_get_values(Y_MATRIX(ml));
+    }
+  }
+  const double *ta = y_vector_get_values(Y_VECTOR(y_ring_vector_get_timestamps(a)));
+  const double *tb = y_vector_get_values(Y_VECTOR(y_ring_vector_get_timestamps(b)));
+
+  /* merged clock: one row per sample of either channel */
+  YMatrixSize size = y_matrix_get_size(Y_MATRIX(mh));
+  g_assert_cmpuint(size.rows,==,50);
+  g_assert_cmpuint(size.columns,==,3);
+  for (unsigned int r=0;r<50;r++) {
+    double t = y_matrix_get_value(Y_MATRIX(mh),r,0);
+    if (r<10) {
+      g_assert_true(isnan(t));
+      continue;
+    }
+    if (r>10)
+      g_assert_cmpfloat(t, >, y_matrix_get_value(Y_MATRIX(mh),r-1,0));
+    int i = -1, j = -1;
+    while (i+1<30 && ta[i+1]<=t) i++;
+    while (j+1<10 && tb[j+1]<=t) j++;
+    g_assert_true(t==ta[MAX(i,0)] || t==tb[MAX(j,0)]);
+    g_assert_cmpfloat(y_matrix_get_value(Y_MATRIX(mh),r,1), ==, i);
+    if (j<0)
+      g_assert_true(isnan(y_matrix_get_value(Y_MATRIX(mh),r,2)));
+    else
+      g_assert_cmpfloat(y_matrix_get_value(Y_MATRIX(mh),r,2), ==, 100+3*j);
+  }
+
+  /* input clock with interpolation: ticks after b's last sample wait */
+  for (unsigned int r=0;r<50;r++) {
+    double t = y_matrix_get_value(Y_MATRIX(ml),r,0);
+    if (r<22) {
+      g_assert_true(isnan(t));
+      continue;
+    }
+    int i = r-22;
+    g_assert_cmpfloat(t, ==, ta[i]);
+    g_assert_cmpfloat(y_matrix_get_value(Y_MATRIX(ml),r,1), ==, i);
+    double v = y_matrix_get_value(Y_MATRIX(ml),r,2);
+    if (i==0) {
+      g_assert_true(isnan(v));
+      continue;
+    }
+    int j = (i-1)/3;
+    double f = (t-tb[j])/(tb[j+1]-tb[j]);
+    g_assert_cmpfloat(fabs(v-(100+3*j+3*f)), <, 1e-9);
+  }
+
+  g_object_unref(mh);
+  g_object_unref(ml);
+}
+
+static void
+test_psd(void)
+{
+  YOperation *op = g_object_new(Y_TYPE_PSD_OPERATION,"segment-length",64,"overlap",32,
+                                "scaling",PSD_SPECTRUM,NULL);
+  YData *input = y_val_vector_new_alloc(1024);
+  double *d = y_val_vector_get_array(Y_VAL_VECTOR(input));
+  for (int i=0;i<1024;i++) {
+    d[i]=2.0*cos(2*G_PI*8*i/64.0);
+  }
+  YDerivedVector *v = Y_DERIVED_VECTOR(y_derived_vector_new(Y_DATA(input),op));
+  g_assert_cmpuint(33,==,y_vector_get_len(Y_VECTOR(v)));
+  /* amplitude 2 sinusoid has power 2 */
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(v),8)-2.0), <, 1e-9);
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(v),12)), <, 1e-9);
+  g_object_set(op,"db",TRUE,NULL);
+  g_assert_cmpfloat(fabs(y_vector_get_value(Y_VECTOR(v),8)-10*log10(2.0)), <, 1e-9);
+
+  /* Parseval: with a rectangular window and no overlap, the integral of
+   * the density is the mean square of the input */
+  double ms = 0.0;
+  for (int i=0;i<1024;i++) {
+    d[i]=g_test_rand_double_range(-1.0,1.0);
+    ms += d[i]*d[i]/1024;
+  }
+  g_object_set(op,"db",FALSE,"scaling",PSD_DENSITY,"overlap",0,
+               "window",FFT_WINDOW_RECTANGULAR,"sample-rate",10.0,NULL);
+  y_data_emit_changed(input);
+  double sum = 0.0;
+  for (int k=0;k<33;k++) {
+    sum += y_vector_get_value(Y_VECTOR(v),k)*10.0/64;
+  }
+  g_assert_cmpfloat(fabs(sum-ms), <, 1e-9);
+
+  /* segments must advance */
+  g_test_expect_message(NULL,G_LOG_LEVEL_WARNING,"*overlap*");
+  g_object_set(op,"overlap",64,NULL);
+  g_assert_true(isnan(y_vector_get_value(Y_VECTOR(v),8)));
+  g_test_assert_expected_messages();
+  g_object_unref(v);
+}
+
 static void
 test_derived_vector_slice(void)
 {
@@ -290,6 +1433,10 @@ test_derived_vector_subset(void)
   YDerivedVector *v = Y_DERIVED_VECTOR(y_derived_vector_new(Y_DATA(m),op));
   g_assert_cmpuint(20,==,y_vector_get_len(Y_VECTOR(v)));
   g_assert_cmpfloat(5.0, ==, y_vector_get_value(Y_VECTOR(v),0));
+  /* a subset starting past the end is empty */
+  g_object_set(op,"start1",150,NULL);
+  y_vector_get_values(Y_VECTOR(v));
+  g_assert_cmpuint(0,==,y_vector_get_len(Y_VECTOR(v)));
   g_object_unref(v);
 }
 
@@ -316,6 +1463,119 @@ test_derived_matrix_simple(void)
   g_object_unref(v);
 }
 
+static void
+test_derived_matrix_FFT(void)
+{
+  YOperation *op = g_object_new(Y_TYPE_FFT_OPERATION,"type",FFT_POWER,NULL);
+  YData *input = y_val_matrix_new_alloc(8,16);
+  double *d = y_val_matrix_get_array(Y_VAL_MATRIX(input));
+  for (int i=0;i<8;i++) {
+    for(int j=0;j<16;j++) {
+      d[i*16+j]=cos(2*G_PI*2*j/16.0)+cos(2*G_PI*i/8.0);
+    }
+  }
+  YDerivedMatrix *v = Y_DERIVED_MATRIX(y_derived_matrix_new(Y_DATA(input),op));
+  g_assert_cmpuint(8,==,y_matrix_get_rows(Y_MATRIX(v)));
+  g_assert_cmpuint(16/2+1,==,y_matrix_get_columns(Y_MATRIX(v)));
+  g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(v),0,2)-64.0*64.0), <, 1e-6);
+  g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(v),1,0)-64.0*64.0), <, 1e-6);
+  g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(v),1,2)), <, 1e-6);
+
+  /* zero frequency moves to the middle row */
+  g_object_set(op,"shift",TRUE,NULL);
+  g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(v),4,2)-64.0*64.0), <, 1e-6);
+  g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(v),5,0)-64.0*64.0), <, 1e-6);
+  g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(v),0,2)), <, 1e-6);
+  g_object_unref(v);
+}
+
+static void
+test_derived_matrix_FFT_rows(void)
+{
+  YOperation *op = g_object_new(Y_TYPE_FFT_OPERATION,"axis",FFT_ROWS,NULL);
+  YData *input = y_val_matrix_new_alloc(4,32);
+  double *d = y_val_matrix_get_array(Y_VAL_MATRIX(input));
+  for (int i=0;i<4;i++) {
+    for(int j=0;j<32;j++) {
+      d[i*32+j]=cos(2*G_PI*(i+1)*j/32.0);
+    }
+  }
+  YDerivedMatrix *v = Y_DERIVED_MATRIX(y_derived_matrix_new(Y_DATA(input),op));
+  g_assert_cmpuint(4,==,y_matrix_get_rows(Y_MATRIX(v)));
+  g_assert_cmpuint(32/2+1,==,y_matrix_get_columns(Y_MATRIX(v)));
+  for (int i=0;i<4;i++) {
+    g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(v),i,i+1)-16.0), <, 1e-9);
+    g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(v),i,i+2)), <, 1e-9);
+  }
+
+  /* the transposed input, transformed along the columns */
+  YData *input2 = y_val_matrix_new_alloc(32,4);
+  double *d2 = y_val_matrix_get_array(Y_VAL_MATRIX(input2));
+  for (int i=0;i<32;i++) {
+    for(int j=0;j<4;j++) {
+      d2[i*4+j]=d[j*32+i];
+    }
+  }
+  g_object_set(op,"axis",FFT_COLUMNS,NULL);
+  g_object_set(v,"input",input2,NULL);
+  g_assert_cmpuint(32/2+1,==,y_matrix_get_rows(Y_MATRIX(v)));
+  g_assert_cmpuint(4,==,y_matrix_get_columns(Y_MATRIX(v)));
+  for (int j=0;j<4;j++) {
+    g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(v),j+1,j)-16.0), <, 1e-9);
+    g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(v),j+2,j)), <, 1e-9);
+  }
+  g_object_unref(v);
+}
+
+static void
+test_spectrogram(void)
+{
+  YOperation *op = g_object_new(Y_TYPE_SPECTROGRAM_OPERATION,"window-length",64,"hop",32,
+                                "rows",8,"type",FFT_MAG,"window",FFT_WINDOW_RECTANGULAR,NULL);
+  YRingVector *r = Y_RING_VECTOR(y_ring_vector_new(512, 0, FALSE));
+  YDerivedMatrix *m = Y_DERIVED_MATRIX(y_derived_matrix_new(Y_DATA(r),op));
+  g_assert_cmpuint(8,==,y_matrix_get_rows(Y_MATRIX(m)));
+  g_assert_cmpuint(33,==,y_matrix_get_columns(Y_MATRIX(m)));
+
+  double chunk[50];
+  int i;
+  for(i=0;i<32;i++) {
+    chunk[i]=cos(2*G_PI*4*i/64.0);
+  }
+  y_ring_vector_append_array(r,chunk,32);
+  g_assert_cmpfloat(y_matrix_get_value(Y_MATRIX(m),7,4), ==, 0.0);
+  y_ring_vector_append_array(r,chunk,32);
+  g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(m),7,4)-32.0), <, 1e-9);
+  g_assert_cmpfloat(y_matrix_get_value(Y_MATRIX(m),6,4), ==, 0.0);
+  y_ring_vector_append_array(r,chunk,32);
+  g_assert_cmpfloat(fabs(y_matrix_get_value(Y_MATRIX(m),6,4)-32.0), <, 1e-9);
+  g_assert_cmpfloat(y_matrix_get_value(Y_MATRIX(m),5,4), ==, 0.0);
+
+  /* feed more than the ring holds, in chunks that don't line up with the
+   * hop; the result matches a spectrogram computed from scratch */
+  unsigned int total = 96;
+  while(total<1024) {
+    unsigned int len = MIN(50,1024-total);
+    for(i=0;i<len;i++) {
+      chunk[i]=g_test_rand_double_range(-1.0,1.0);
+    }
+    y_ring_vector_append_array(r,chunk,len);
+    total += len;
+    y_matrix_get_values(Y_MATRIX(m));
+  }
+  g_assert_cmpuint(512,==,y_vector_get_len(Y_VECTOR(r)));
+  YOperation *op2 = g_object_new(Y_TYPE_SPECTROGRAM_OPERATION,"window-length",64,"hop",32,
+                                 "rows",8,"type",FFT_MAG,"window",FFT_WINDOW_RECTANGULAR,NULL);
+  YDerivedMatrix *m2 = Y_DERIVED_MATRIX(y_derived_matrix_new(Y_DATA(r),op2));
+  const double *v1 = y_matrix_get_values(Y_MATRIX(m));
+  const double *v2 = y_matrix_get_values(Y_MATRIX(m2));
+  for(i=0;i<8*33;i++) {
+    g_assert_cmpfloat(fabs(v1[i]-v2[i]), <, 1e-9);
+  }
+  g_object_unref(m);
+  g_object_unref(m2);
+}
+
 static void
 test_derived_matrix_subset(void)
 {
@@ -343,8 +1603,15 @@ main (int argc, char *argv[])
   g_test_add_func("/YData/simple/vector_new",test_simple_vector_new);
   g_test_add_func("/YData/simple/vector_alloc",test_simple_vector_alloc);
   g_test_add_func("/YData/simple/vector_copy",test_simple_vector_copy);
+  g_test_add_func("/YData/simple/vector_minmax_range",test_vector_minmax_range);
+  g_test_add_func("/YData/simple/vector_find_index",test_vector_find_index);
   g_test_add_func("/YData/range",test_range_vectors);
+  g_test_add_func("/YData/range/meshgrid",test_meshgrid);
   g_test_add_func("/YData/ring/vector",test_ring_vector);
+  g_test_add_func("/YData/ring/window",test_ring_window);
+  g_test_add_func("/YData/ring/history",test_history);
+  g_test_add_func("/YData/ring/tiered",test_tiered_ring);
+  g_test_add_func("/YData/ring/spill",test_ring_spill);
   g_test_add_func("/YData/ring/matrix",test_ring_matrix);
   g_test_add_func("/Ydata/property/scalar",test_property_scalar);
   g_test_add_func("/YData/derived/scalar/simple",test_derived_scalar_simple);
@@ -353,8 +1620,26 @@ main (int argc, char *argv[])
   g_test_add_func("/YData/derived/vector/subset",test_derived_vector_subset);
   g_test_add_func("/YData/derived/vector/FFT/mag",test_derived_vector_FFT_mag);
   g_test_add_func("/YData/derived/vector/FFT/phase",test_derived_vector_FFT_phase);
+  g_test_add_func("/YData/derived/vector/FFT/single",test_fft_single);
+  g_test_add_func("/YData/derived/vector/FFT/complex",test_fft_complex);
+  g_test_add_func("/YData/derived/vector/FFT/padding",test_fft_padding);
+  g_test_add_func("/YData/derived/vector/FFT/wisdom",test_fft_wisdom);
+  g_test_add_func("/YData/derived/vector/FFT/threaded",test_fft_threaded);
+  g_test_add_func("/YData/derived/vector/FFT/plan-cache",test_fft_plan_cache);
+  g_test_add_func("/YData/derived/vector/PSD",test_psd);
+  g_test_add_func("/YData/derived/vector/sliding-DFT",test_sliding_dft);
+  g_test_add_func("/YData/derived/matrix/lock-in",test_lock_in);
+  g_test_add_func("/YData/derived/vector/filter",test_filter);
+  g_test_add_func("/YData/derived/vector/correlate",test_correlate);
+  g_test_add_func("/YData/derived/vector/rolling-stats",test_rolling_stats);
+  g_test_add_func("/YData/derived/vector/decimate",test_decimate);
+  g_test_add_func("/YData/derived/vector/interpolate",test_interpolate);
+  g_test_add_func("/YData/derived/matrix/align",test_align);
   g_test_add_func("/YData/derived/vector/slice",test_derived_vector_slice);
   g_test_add_func("/YData/derived/matrix/simple",test_derived_matrix_simple);
   g_test_add_func("/YData/derived/matrix/subset",test_derived_matrix_subset);
+  g_test_add_func("/YData/derived/matrix/FFT",test_derived_matrix_FFT);
+  g_test_add_func("/YData/derived/matrix/FFT/rows",test_derived_matrix_FFT_rows);
+  g_test_add_func("/YData/derived/matrix/spectrogram",test_spectrogram);
   return g_test_run();
 }